@@ -204,18 +204,119 @@ int normal_cnn(uint8_t input[28][28])
     return max_idx;
 }
 
+/*------------------------------------------------------------
+ * fully connected layer on the fine-grained NICE ops
+ * in_len is a multiple of 4, weight is [out_len][in_len]
+ *-----------------------------------------------------------*/
+void nice_fc_dot4(const uint8_t *in, const int8_t *weight, const int32_t *bias, int in_len, int out_len,
+                  uint8_t in_zp, uint8_t weight_zp, uint32_t requant_arg, uint8_t *out)
+{
+    custom_cfg(NICE_CFG_ALU_ZP, ((uint32_t)weight_zp << 8) | in_zp);
+
+    for (int i = 0; i < out_len; i++)
+    {
+        int32_t sum = bias[i];
+        for (int j = 0; j < in_len; j += 4)
+        {
+            uint32_t act = (uint32_t)in[j] | ((uint32_t)in[j+1] << 8) | ((uint32_t)in[j+2] << 16) | ((uint32_t)in[j+3] << 24);
+            const uint8_t *w = (const uint8_t *)&weight[i * in_len + j];
+            uint32_t wgt = (uint32_t)w[0] | ((uint32_t)w[1] << 8) | ((uint32_t)w[2] << 16) | ((uint32_t)w[3] << 24);
+            sum += custom_dot4(act, wgt);
+        }
+        out[i] = (uint8_t)custom_requant(sum, requant_arg);
+    }
+}
+
+/*------------------------------------------------------------
+ * fill the inactive weight bank, the active one keeps running
+ *-----------------------------------------------------------*/
+void nice_stage_weights(const int8_t *conv1, const int8_t *conv2, const int8_t *fc1, const int8_t *fc2)
+{
+    custom_load_conv1((uintptr_t)conv1);
+    custom_load_conv2((uintptr_t)conv2);
+    custom_load_fc1((uintptr_t)fc1);
+    custom_load_fc2((uintptr_t)fc2);
+}
+
 void nice_load_weights()
 {
-    custom_load_conv1((uintptr_t)conv1_weight);
-    custom_load_conv2((uintptr_t)conv2_weight);
-    custom_load_fc1((uintptr_t)fc1_weight);
-    custom_load_fc2((uintptr_t)fc2_weight);
+    nice_stage_weights(conv1_weight, conv2_weight, fc1_weight, fc2_weight);
+    custom_swap();
+}
+
+/*------------------------------------------------------------
+ * E203_CFG_NICE_PREEMPT: re-issue a preempted op until it ends
+ *-----------------------------------------------------------*/
+static inline int nice_finish(int result)
+{
+    while (result == NICE_RESUME)
+        result = custom_resume();
+    return result;
 }
 
 int nice_cnn(uint8_t input[784])
 {
     int result;
-    result = custom_load_input((uintptr_t)input);
+    result = nice_finish(custom_load_input((uintptr_t)input));
     return result;
 }
 
+int nice_cnn_result(uint8_t input[784], nice_result_t *res)
+{
+    return nice_finish(custom_load_input_wb((uintptr_t)input, res));
+}
+
+int nice_cnn_frame(const void *frame, uint32_t fmt)
+{
+    return nice_finish(custom_load_frame((uintptr_t)frame, fmt));
+}
+
+/*------------------------------------------------------------
+ * classify num images, up to NICE_NUM of them in flight
+ *-----------------------------------------------------------*/
+void nice_cnn_batch(uint8_t (*input)[784], int num, int *result)
+{
+    if (NICE_NUM == 1)
+    {
+        for (int i = 0; i < num; i++)
+            result[i] = nice_finish(custom_load_input((uintptr_t)input[i]));
+        return;
+    }
+
+    for (int i = 0; i < num + NICE_NUM; i++)
+    {
+        if (i >= NICE_NUM && i - NICE_NUM < num)
+        {
+            int r;
+            while ((r = custom_collect()) == NICE_RESUME)
+                ;  // the image runs on, just ask again
+            result[i - NICE_NUM] = r;
+        }
+        if (i < num)
+            custom_load_input((uintptr_t)input[i]);
+    }
+}
+
+/*------------------------------------------------------------
+ * copy into the NICE scratchpad with word stores,
+ * dst is word aligned, the tail word is zero padded
+ *-----------------------------------------------------------*/
+void nice_sp_write(uintptr_t dst, const void *src, int len)
+{
+    const uint8_t *p = (const uint8_t *)src;
+    volatile uint32_t *sp = NICE_SP_PTR(dst);
+
+    for (int i = 0; i < len; i += 4)
+    {
+        uint32_t word = 0;
+        for (int b = 0; b < 4 && (i + b) < len; b++)
+            word |= (uint32_t)p[i + b] << (8 * b);
+        *sp++ = word;
+    }
+}
+
+int nice_cnn_sp(const uint8_t input[784])
+{
+    nice_sp_write(NICE_SP_INPUT, input, 784);
+    return nice_finish(custom_run());
+}
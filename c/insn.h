@@ -72,6 +72,33 @@ __STATIC_FORCEINLINE void custom_load_fc2(uintptr_t addr)
     );
 }
 
+// 256-byte activation LUT (python/act_lut.py), like the weights it goes
+// to the inactive bank; NICE_CFG_ACT_LUT picks the layers that use it
+__STATIC_FORCEINLINE void custom_load_act(uintptr_t addr)
+{
+    int zero = 0;
+    asm volatile (
+        ".insn r 0x7b, 2, 28, x0, %1, x0"
+        : "=r"(zero)
+        : "r"(addr)
+    );
+}
+
+#define NICE_QP_WORDS           35  // 5 + conv1 / conv2 / fc1 / fc2 biases, shipped model
+
+// quant params of the model, NICE_QP_WORDS int32 (python/qparams.py):
+// zero points, requant shift-adds and biases. to the inactive bank, so a
+// swap changes them together with the weights
+__STATIC_FORCEINLINE void custom_load_qp(uintptr_t addr)
+{
+    int zero = 0;
+    asm volatile (
+        ".insn r 0x7b, 2, 30, x0, %1, x0"
+        : "=r"(zero)
+        : "r"(addr)
+    );
+}
+
 __STATIC_FORCEINLINE int custom_load_input(uintptr_t addr)
 {
     int result;
@@ -83,8 +110,322 @@ __STATIC_FORCEINLINE int custom_load_input(uintptr_t addr)
     return result;
 }
 
+// FRAME_DS of the core: load_input from a raw camera frame,
+// (28 * FRAME_DS)^2 pixels, row major, 8-bit gray or RGB565.
+// the core takes it to luma, box-filters it down to 28x28 and
+// quantises it as quant_MNIST.py on the way in (python/frame_prep.py)
+#define NICE_FRAME_GRAY8        0
+#define NICE_FRAME_RGB565       1
+
+__STATIC_FORCEINLINE int custom_load_frame(uintptr_t addr, uint32_t fmt)
+{
+    int result;
+    asm volatile (
+        ".insn r 0x7b, 7, 29, %0, %1, %2"
+        : "=r"(result)
+        : "r"(addr), "r"(fmt)
+    );
+    return result;
+}
+
+////////////////////////////////////////////////////////////
+// result writeback: same as load_input / run, and before the
+// class is returned the logits and the sorted top-k are stored
+// to out. the addi waits for the response, so out is complete
+// once the call returns
+////////////////////////////////////////////////////////////
+
+#define NICE_CLASSES            10
+#define NICE_TOPK               3
+
+typedef struct
+{
+    int32_t logits[NICE_CLASSES];
+    struct
+    {
+        int32_t idx;
+        int32_t val;
+    } top[NICE_TOPK];                // descending
+    union
+    {
+        uint16_t q15[NICE_CLASSES];  // NICE_PROB_Q15
+        uint8_t  u8[NICE_CLASSES];   // NICE_PROB_U8
+    } prob;
+} nice_result_t;
+
+__STATIC_FORCEINLINE int custom_load_input_wb(uintptr_t addr, nice_result_t *out)
+{
+    int result;
+    asm volatile (
+        ".insn r 0x7b, 7, 22, %0, %1, %2\n\t"
+        "addi %0, %0, 0"
+        : "=r"(result)
+        : "r"(addr), "r"(out)
+        : "memory"
+    );
+    return result;
+}
+
+__STATIC_FORCEINLINE int custom_run_wb(nice_result_t *out)
+{
+    int result;
+    asm volatile (
+        ".insn r 0x7b, 5, 23, %0, x0, %1\n\t"
+        "addi %0, %0, 0"
+        : "=r"(result)
+        : "r"(out)
+        : "memory"
+    );
+    return result;
+}
+
+////////////////////////////////////////////////////////////
+// fine-grained ops for hand-written kernels
+//  dot4    : sum((act.u8[k] - in_zp) * (wgt.i8[k] - w_zp)), k = 0..3
+//  max4    : max of the 4 uint8 in a word
+//  requant : shift-add scale of a layer + zero_point, clamp (and relu)
+//  cfg     : write a config register (zero points of dot4, ...)
+////////////////////////////////////////////////////////////
+
+#define NICE_CFG_ALU_ZP         0
+#define NICE_CFG_PROB_FMT       1
+#define NICE_CFG_WL_ZIP         2
+#define NICE_CFG_ACT_LUT        3   // val: NICE_ACT_* mask, LUT instead of relu
+
+#define NICE_ACT_CONV1          (1 << 0)
+#define NICE_ACT_CONV2          (1 << 1)
+#define NICE_ACT_FC1            (1 << 2)
+
+#define NICE_PROB_Q15           0
+#define NICE_PROB_U8            1
+
+#define NICE_REQUANT_CONV1      0
+#define NICE_REQUANT_CONV2      1
+#define NICE_REQUANT_FC1        2
+#define NICE_REQUANT_NONE       3
+#define NICE_REQUANT_ARG(sel, zp, relu)  ((((relu) & 1) << 16) | (((zp) & 0xff) << 8) | ((sel) & 3))
+#define NICE_REQUANT_LUT        (1 << 17)   // or into the arg: through the act LUT
+// the scales are the shift-adds of the active bank's quant params (custom_load_qp)
+
+__STATIC_FORCEINLINE int custom_dot4(uint32_t act, uint32_t wgt)
+{
+    int result;
+    asm volatile (
+        ".insn r 0x7b, 7, 16, %0, %1, %2"
+        : "=r"(result)
+        : "r"(act), "r"(wgt)
+    );
+    return result;
+}
+
+__STATIC_FORCEINLINE int custom_max4(uint32_t val)
+{
+    int result;
+    asm volatile (
+        ".insn r 0x7b, 6, 17, %0, %1, x0"
+        : "=r"(result)
+        : "r"(val)
+    );
+    return result;
+}
+
+__STATIC_FORCEINLINE int custom_requant(int32_t acc, uint32_t arg)
+{
+    int result;
+    asm volatile (
+        ".insn r 0x7b, 7, 18, %0, %1, %2"
+        : "=r"(result)
+        : "r"(acc), "r"(arg)
+    );
+    return result;
+}
+
+__STATIC_FORCEINLINE void custom_cfg(uint32_t idx, uint32_t val)
+{
+    int zero = 0;
+    asm volatile (
+        ".insn r 0x7b, 3, 19, x0, %1, %2"
+        : "=r"(zero)
+        : "r"(val), "r"(idx)
+    );
+}
+
+////////////////////////////////////////////////////////////
+// scratchpad: NICE buffers mapped on the perips bus (8KB)
+//  weights, LUT, quant params (inactive bank) and input are read/write,
+//  layer outputs are read only
+//  weight / LUT accesses stall only during a weight load, so the
+//  next model can be written while an image runs; input accesses
+//  stall while an image runs, the read-only outputs never stall.
+//  never point custom_load_* at the scratchpad itself
+//  offsets are those of the shipped model, a CONV1_A16 core takes an
+//  int16_t [28][28] image (1568 bytes) and the buffers after it move
+////////////////////////////////////////////////////////////
+
+#define NICE_SP_BASE            0x10042000UL
+#define NICE_SP_CONV1_W         (NICE_SP_BASE + 0x0000)  // int8  [5][9]
+#define NICE_SP_CONV2_W         (NICE_SP_BASE + 0x0040)  // int8  [5][5][9]
+#define NICE_SP_FC1_W           (NICE_SP_BASE + 0x0140)  // int8  [10][20]
+#define NICE_SP_FC2_W           (NICE_SP_BASE + 0x0240)  // int8  [10][10]
+#define NICE_SP_ACT             (NICE_SP_BASE + 0x02c0)  // uint8 [256]
+#define NICE_SP_QP              (NICE_SP_BASE + 0x03c0)  // int32 [NICE_QP_WORDS]
+#define NICE_SP_INPUT           (NICE_SP_BASE + 0x0800)  // uint8 [28][28]
+#define NICE_SP_CONV1_OUT       (NICE_SP_BASE + 0x0c00)  // uint8 [5][12][12]
+#define NICE_SP_CONV2_OUT       (NICE_SP_BASE + 0x1000)  // int32 [5][4][4]
+#define NICE_SP_FC1_OUT         (NICE_SP_BASE + 0x1200)  // int32 [10]
+#define NICE_SP_LOGITS          (NICE_SP_BASE + 0x1280)  // int32 [10]
+#define NICE_SP_TOPK            (NICE_SP_BASE + 0x12c0)  // {idx, val} [NICE_TOPK]
+#define NICE_SP_PROB            (NICE_SP_BASE + 0x1300)  // Q15 [10]
+#define NICE_SP_STAT            (NICE_SP_BASE + 0x1340)  // bit 0: psum saturated (L_WIDTH < 32)
+
+#define NICE_SP_PTR(addr)       ((volatile uint32_t *)(addr))
+
+// run inference on the image already in the input buffer, returns the class
+__STATIC_FORCEINLINE int custom_run(void)
+{
+    int result;
+    asm volatile (
+        ".insn r 0x7b, 4, 20, %0, x0, x0"
+        : "=r"(result)
+    );
+    return result;
+}
+
+////////////////////////////////////////////////////////////
+// weight banks: custom_load_* and scratchpad writes fill the
+// inactive bank, even while an image runs on the active one.
+// custom_swap flips the banks between images.
+// biases and zero points are fixed in hardware and shared by both banks
+////////////////////////////////////////////////////////////
+
+// returns the new active bank
+__STATIC_FORCEINLINE int custom_swap(void)
+{
+    int result;
+    asm volatile (
+        ".insn r 0x7b, 4, 21, %0, x0, x0"
+        : "=r"(result)
+    );
+    return result;
+}
+
+////////////////////////////////////////////////////////////
+// FC_PIPE: fc1 / fc2 of an image run beside the convs of the
+// next one. load_input / run return the class of the previous
+// image (garbage for the first), custom_fc_sync waits for the
+// last one and computes its probabilities. the _wb forms drain
+// the pipeline and return their own image
+////////////////////////////////////////////////////////////
+
+__STATIC_FORCEINLINE int custom_fc_sync(void)
+{
+    int result;
+    asm volatile (
+        ".insn r 0x7b, 4, 25, %0, x0, x0"
+        : "=r"(result)
+    );
+    return result;
+}
+
+////////////////////////////////////////////////////////////
+// E203_CFG_NICE_NUM > 1: load_input / run go to the next free
+// accelerator and return its index at once, custom_collect
+// waits for the oldest image and returns its class (-1 when
+// none is in flight). keep at most NICE_NUM images in flight.
+// weight loads, cfg and swap reach all accelerators, the
+// scratchpad maps the one that takes the next image, so stage
+// weights with custom_load_*. get_prob reads the last collected
+// E203_CFG_NICE_DTCM_PORT: keep the images in DTCM, the odd
+// accelerators then read them over the DTCM port, beside the LSU
+// NICE_NUM follows the hardware config, the SDK app Makefile
+// takes it from the same config.v as the RTL:
+//   NICE_NUM_CFG := $(shell sed -n 's/^`define E203_CFG_NICE_NUM //p' $(E203)/rtl/e203/core/config.v)
+//   COMMON_FLAGS += -DE203_CFG_NICE_NUM=$(NICE_NUM_CFG)
+////////////////////////////////////////////////////////////
+
+#ifndef NICE_NUM
+#ifdef E203_CFG_NICE_NUM
+#define NICE_NUM                E203_CFG_NICE_NUM
+#else
+#define NICE_NUM                1
+#endif
+#endif
+
+__STATIC_FORCEINLINE int custom_collect(void)
+{
+    int result;
+    asm volatile (
+        ".insn r 0x7b, 4, 26, %0, x0, x0"
+        : "=r"(result)
+    );
+    return result;
+}
+
+void nice_cnn_batch(uint8_t (*input)[784], int num, int *result);
+
+////////////////////////////////////////////////////////////
+// E203_CFG_NICE_PREEMPT: with an interrupt pending, load_input,
+// run, fc_sync and collect may stop between two passes and
+// return NICE_RESUME, the interrupt is taken right after.
+// the latency bound is one pass; the input load in front of the
+// first pass and the weight loads are not preemptible and come on
+// top: about 200 cycles for load_input, (28 * FRAME_DS)^2 / 4 beats
+// for a gray load_frame (twice that for RGB565) and the blob size
+// of a weight load in beats, so they do grow with the model
+// custom_resume continues the parked op and returns what it
+// would have (-1 when nothing is parked), collect is just
+// issued again. the nice_* wrappers do that on their own.
+// an ISR may use the ALU ops and read
+// the scratchpad; a new load_input / run drops the parked image,
+// and so do swap and cfg of NICE_CFG_ACT_LUT / NICE_CFG_PROB_FMT,
+// which would change the model under it. custom_resume (and the
+// nice_* wrapper waiting on it) then returns -1
+////////////////////////////////////////////////////////////
+
+#define NICE_RESUME             (-2)
+
+__STATIC_FORCEINLINE int custom_resume(void)
+{
+    int result;
+    asm volatile (
+        ".insn r 0x7b, 4, 27, %0, x0, x0\n\t"
+        "addi %0, %0, 0"
+        : "=r"(result)
+        :
+        : "memory"
+    );
+    return result;
+}
+
+void nice_stage_weights(const int8_t *conv1, const int8_t *conv2, const int8_t *fc1, const int8_t *fc2);
+
+void nice_sp_write(uintptr_t dst, const void *src, int len);
+int  nice_cnn_sp(const uint8_t input[784]);
+
+////////////////////////////////////////////////////////////
+// softmax: every inference also computes the probabilities of
+// all classes (Q15 by default, uint8 after custom_cfg), they are
+// part of nice_result_t and readable with custom_get_prob
+////////////////////////////////////////////////////////////
+
+__STATIC_FORCEINLINE int custom_get_prob(uint32_t cls)
+{
+    int result;
+    asm volatile (
+        ".insn r 0x7b, 6, 24, %0, %1, x0"
+        : "=r"(result)
+        : "r"(cls)
+    );
+    return result;
+}
+
+void nice_fc_dot4(const uint8_t *in, const int8_t *weight, const int32_t *bias, int in_len, int out_len,
+                  uint8_t in_zp, uint8_t weight_zp, uint32_t requant_arg, uint8_t *out);
+
 void nice_load_weights();
 int  nice_cnn(uint8_t input[784]);
+int  nice_cnn_result(uint8_t input[784], nice_result_t *res);
+int  nice_cnn_frame(const void *frame, uint32_t fmt);
 
 int normal_cnn(uint8_t input[28][28]);
 
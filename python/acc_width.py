@@ -0,0 +1,103 @@
+import re
+
+from weight_codec import DATA_C, read_data_c
+from winograd import WINO_BT, weight_transform
+
+# worst-case column psum of the systolic array per layer, to size the PE
+# accumulators (L_WIDTH of the NICE core). a pass sums at most SA_ROWS
+# products down a column, the sum over passes is kept in the int32 output
+# registers of the core, so only one pass has to fit the PE.
+# activations are uint8 - zp, every product range holds 0, so a partial sum
+# higher up the column stays inside the range of the full column
+#
+#   python python/acc_width.py         # reads c/data.c, prints bits per layer
+
+SA_ROWS    = 10
+CONV_SLOTS = SA_ROWS - 1               # row 0 seeds the zero psum
+
+# layer -> zero point of the activations it reads
+ACT_ZP = {"conv1": "input_zp", "conv2": "conv1_out_zp", "fc1": "conv2_out_zp", "fc2": "fc1_out_zp"}
+
+
+def read_act_zp(path=DATA_C):
+    src = open(path).read()
+    return {name: int(re.search(r"%s\s*=\s*(\d+)" % zp, src).group(1)) for name, zp in ACT_ZP.items()}
+
+
+def bits(lo, hi):
+    """signed width that holds lo..hi"""
+    b = 1
+    while lo < -(1 << (b - 1)) or hi > (1 << (b - 1)) - 1:
+        b += 1
+    return b
+
+
+def col_range(terms):
+    """terms = [(weight, act_lo, act_hi)] of one column in one pass"""
+    lo = sum(min(w * a_lo, w * a_hi) for w, a_lo, a_hi in terms)
+    hi = sum(max(w * a_lo, w * a_hi) for w, a_lo, a_hi in terms)
+    return lo, hi
+
+
+def passes(name, w, wzp, azp):
+    """columns of every pass as the core schedules them, weights - zp"""
+    w = [v - wzp for v in w]
+    a_lo, a_hi = -azp, 255 - azp
+    if name in ("conv1", "conv2"):      # one kernel of one input channel per pass
+        return [[(v, a_lo, a_hi) for v in w[k:k + 9]] for k in range(0, len(w), 9)]
+    width = len(w) // 10                # in width, both fc layers have 10 outputs
+    cols = []
+    for o in range(len(w) // width):    # SA_ROWS inputs of one output per pass
+        row = w[o * width:(o + 1) * width]
+        cols += [[(v, a_lo, a_hi) for v in row[k:k + SA_ROWS]] for k in range(0, width, SA_ROWS)]
+    return cols
+
+
+def wino_passes(w, wzp, azp, cha=5, num=5):
+    """CONV2_WINO: U (G g G^T) times V (B^T d B) at one transform position,
+    CONV_SLOTS input channels per pass"""
+    a_lo, a_hi = -azp, 255 - azp
+    v_rng = []
+    for xi in range(4):
+        for nu in range(4):
+            cs = [WINO_BT[xi][a] * WINO_BT[nu][b] for a in range(4) for b in range(4)]
+            v_rng.append((sum(min(c * a_lo, c * a_hi) for c in cs), sum(max(c * a_lo, c * a_hi) for c in cs)))
+    cols = []
+    for n in range(num):
+        u = [weight_transform([[w[(n * cha + c) * 9 + a * 3 + b] - wzp for b in range(3)] for a in range(3)])
+             for c in range(cha)]
+        for p in range(16):
+            for c0 in range(0, cha, CONV_SLOTS):
+                cols.append([(u[c][p], v_rng[p][0], v_rng[p][1]) for c in range(c0, min(c0 + CONV_SLOTS, cha))])
+    return cols
+
+
+def report(name, cols, a_width, w_width):
+    lo = min(col_range(c)[0] for c in cols)
+    hi = max(col_range(c)[1] for c in cols)
+    rows = max(len(c) for c in cols)
+    shape = rows * (1 << (a_width - 1)) * (1 << (w_width - 1))
+    print("  %-10s %3d passes %2d rows  %8d .. %8d  %2d bit   (int%d x int%d: %2d bit)" %
+          (name, len(cols), rows, lo, hi, bits(lo, hi), a_width, w_width, bits(-shape, shape)))
+    return bits(lo, hi)
+
+
+# with the shipped weights no column needs more than 18 bits, although
+# int9 x int9 over 10 rows takes 21; L_WIDTH = 20 keeps two bits of margin
+# for retrained weights, the PEs saturate and flag it if one gets past.
+# CONV2_WINO reaches 21 bits on the same weights (26 by shape), take 24
+def main():
+    layers = read_data_c()
+    azp = read_act_zp()
+    print("worst-case column psum, c/data.c")
+    need = 0
+    for name, (w, wzp) in layers.items():
+        need = max(need, report(name, passes(name, w, wzp, azp[name]), 9, 9))
+    print("  direct model: L_WIDTH >= %d" % need)
+    w, wzp = layers["conv2"]
+    wino = report("conv2 wino", wino_passes(w, wzp, azp["conv2"]), 11, 13)
+    print("  CONV2_WINO:   L_WIDTH >= %d" % max(need, wino))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,59 @@
+import math
+import sys
+
+# activation LUT of the NICE core (custom3_load_act, NICE_SP_ACT): 256 uint8
+# codes in, 256 out, both on the output scale and zero point of the layer,
+# so the table is f applied to the dequantised code and quantised back.
+# a layer picked by CFG_ACT_LUT goes through it instead of its relu
+#
+#   python python/act_lut.py                   # check against float, all functions
+#   python python/act_lut.py relu6 conv2       # C array for one function / layer
+
+# output scale / zero point per layer, same numbers as cal_quant.py and the core
+LAYER = {
+    "conv1": (0.03605441376566887, 159),
+    "conv2": (0.06869560480117798, 118),
+    "fc1":   (0.13029447197914124, 107),
+}
+
+ACT = {
+    "relu":    lambda x: max(x, 0.0),
+    "relu6":   lambda x: min(max(x, 0.0), 6.0),
+    "hswish":  lambda x: x * min(max(x + 3.0, 0.0), 6.0) / 6.0,
+    "sigmoid": lambda x: 1.0 / (1.0 + math.exp(-x)),
+    "tanh":    math.tanh,
+}
+
+
+def build(act, scale, zp):
+    f = ACT[act]
+    return [min(max(round(f((q - zp) * scale) / scale) + zp, 0), 255) for q in range(256)]
+
+
+def check():
+    """worst error of the table against f on the codes, in output steps"""
+    for layer, (scale, zp) in LAYER.items():
+        for act in ACT:
+            lut = build(act, scale, zp)
+            err = max(abs((lut[q] - zp) * scale - min(max(ACT[act]((q - zp) * scale), (0 - zp) * scale),
+                                                          (255 - zp) * scale)) / scale for q in range(256))
+            print("  %-6s %-8s max err %.2f LSB" % (layer, act, err))
+    # the relu table is the identity clamped at zp, as the core does without the LUT
+    for layer, (scale, zp) in LAYER.items():
+        assert build("relu", scale, zp) == [max(q, zp) for q in range(256)], layer
+
+
+def print_c(act, layer):
+    scale, zp = LAYER[layer]
+    lut = build(act, scale, zp)
+    print("const uint8_t act_lut_%s_%s[256] __attribute__((aligned(4))) = {" % (act, layer))
+    for i in range(0, 256, 16):
+        print("    " + ", ".join("%3d" % v for v in lut[i:i + 16]) + ",")
+    print("};")
+
+
+if __name__ == "__main__":
+    if len(sys.argv) > 2:
+        print_c(sys.argv[1], sys.argv[2])
+    else:
+        check()
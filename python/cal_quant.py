@@ -57,6 +57,24 @@ def fc2_scale():
     scale_int32 = round(scale_out/(scale_in*scale_w))
     print(scale_int32)
 
+# CONV2_SKIP: x (conv1 output) onto the conv2 output scale, as n / 128
+def skip_scale():
+    scale_x=0.03605441376566887
+    scale_out=0.06869560480117798
+    scale_int32 = round(128*scale_x/scale_out)
+    print(scale_int32)
+
+# CONV2_DW: the depthwise half of a separable conv2 reads the conv1 output,
+# scale_w / scale_out / bias come from the quantized depthwise Conv2d of the
+# model, the results are CONV2_DW_BIAS and CONV2_DW_SCALE of the core
+def dw_bias(scale_w, bias, scale_in=0.03605441376566887):
+    bias_int32 = [round(x/(scale_in*scale_w)) for x in bias]
+    print(bias_int32)
+
+def dw_scale(scale_w, scale_out, scale_in=0.03605441376566887):
+    scale_int32 = round(scale_out/(scale_in*scale_w))
+    print(scale_int32)
+
 
 # conv1_bias()
 # conv1_scale()
@@ -66,6 +84,9 @@ def fc2_scale():
 # fc1_scale()
 fc2_bias()
 fc2_scale()
+# skip_scale()
+# dw_bias(scale_w, bias)
+# dw_scale(scale_w, scale_out)
 
 
 """
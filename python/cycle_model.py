@@ -0,0 +1,221 @@
+import math
+
+# cycle model of the NICE core main FSM, same counters as e203_subsys_nice_core.sv
+SA_ROWS = 10
+SA_COLS = 5
+
+MOVE_CYCLES = SA_ROWS + 1           # move_cnt 0..SA_ROWS
+CONV_SLOTS  = SA_ROWS - 1           # row 0 seeds the zero psum
+
+
+def conv_passes(passes, cal, premove):
+    """SA_PREMOVE: only the first pass of a conv layer has a MOVE state, the
+    others move their weights in during the drain of the CAL before"""
+    return (MOVE_CYCLES + passes * cal) if premove else passes * (MOVE_CYCLES + cal)
+
+
+def conv_layer(out_width, k, cout, cin, lanes=1, premove=0):
+    """one pass per (SA_COLS output channels, input channel, tap pass), returns (cycles, macs)
+    a 1x1 kernel packs CONV_SLOTS input channels into one pass instead,
+    int4 weights (lanes = 2) cover 2 * SA_COLS output channels per pass"""
+    out_size = out_width * out_width
+    cal = out_size + CONV_SLOTS + SA_COLS + 1   # cal_convX_cnt 0..CAL_CONVX_CYCLES
+    if k == 1:
+        in_passes = math.ceil(cin / CONV_SLOTS)
+    else:
+        in_passes = cin * math.ceil(k * k / CONV_SLOTS)
+    passes = math.ceil(cout / (SA_COLS * lanes)) * in_passes
+    macs = out_size * k * k * cout * cin
+    return conv_passes(passes, cal, premove), macs
+
+
+def dw_layer(out_width, k, cha):
+    """depthwise: SA_COLS channels per pass, each column on its own channel"""
+    out_size = out_width * out_width
+    cal = out_size + CONV_SLOTS + SA_COLS + 1
+    passes = math.ceil(cha / SA_COLS) * math.ceil(k * k / CONV_SLOTS)
+    return passes * (MOVE_CYCLES + cal), out_size * k * k * cha
+
+
+def wino_layer(out_width, cout, cin):
+    """CONV2_WINO: 2x2 output tiles, one pass per (group, transform position,
+    CONV_SLOTS input channels), macs counted as the direct conv they replace"""
+    tiles = (out_width // 2) ** 2
+    cal = tiles + CONV_SLOTS + SA_COLS + 1
+    passes = math.ceil(cout / SA_COLS) * 16 * math.ceil(cin / CONV_SLOTS)
+    return passes * (MOVE_CYCLES + cal), out_width * out_width * 9 * cout * cin
+
+
+def fc_layer(in_width, out_width, lanes=1):
+    """one SA_ROWS x (SA_COLS * lanes) block per pass"""
+    cal = SA_ROWS + SA_COLS + 2         # cal_fcX_cnt 0..CAL_FCX_CYCLES
+    passes = math.ceil(in_width / SA_ROWS) * math.ceil(out_width / (SA_COLS * lanes))
+    return passes * (MOVE_CYCLES + cal), in_width * out_width
+
+
+def util(cycles, macs):
+    return macs / (cycles * SA_ROWS * SA_COLS)
+
+
+def report(name, cycles, macs):
+    print("  %-26s %7d cycles %8d MAC  %5.1f%%" % (name, cycles, macs, 100 * util(cycles, macs)))
+
+
+def network(conv1_num, conv2_num, input_width=28, premove=0):
+    conv1_w = input_width // 2 - 2
+    conv2_w = conv1_w // 2 - 2
+    layers = [
+        ("conv1 %dx%d x%d" % (conv1_w, conv1_w, conv1_num), conv_layer(conv1_w, 3, conv1_num, 1, premove=premove)),
+        ("conv2 %dx%d x%d<-%d" % (conv2_w, conv2_w, conv2_num, conv1_num),
+         conv_layer(conv2_w, 3, conv2_num, conv1_num, premove=premove)),
+        ("fc1 %d->10" % (conv2_num * 4), fc_layer(conv2_num * 4, 10)),
+        ("fc2 10->10", fc_layer(10, 10)),
+    ]
+    print("CONV1_NUM = %d, CONV2_NUM = %d, input %dx%d%s" %
+          (conv1_num, conv2_num, input_width, input_width, ", SA_PREMOVE" if premove else ""))
+    total_c = total_m = 0
+    for name, (c, m) in layers:
+        report(name, c, m)
+        total_c += c
+        total_m += m
+    report("total", total_c, total_m)
+
+
+# every pass pays MOVE + fill/drain = SA_ROWS + 1 + RC + SA_COLS + 1 cycles and
+# row 0 idles for a 3x3 kernel, so a conv pass over P outputs reaches
+# 0.9 * P / (P + 26); the array is above 80% once P >= 208, i.e. 15x15 maps.
+# channel tiling adds passes but no per-pass cost, wide layers keep this ratio
+def break_even(target=0.8, k=3, premove=0):
+    w = 1
+    while util(*conv_layer(w, k, SA_COLS, 9, premove=premove)) < target:
+        w += 1
+    print("conv passes above %d%% from %dx%d outputs%s" % (100 * target, w, w, ", SA_PREMOVE" if premove else ""))
+
+
+network(5, 5)
+network(20, 35)             # 16 / 32 channel model padded to multiples of SA_COLS
+print("conv layers, 20 output channels")
+for w in (4, 12, 15, 30, 62):
+    report("conv %dx%d x20" % (w, w), *conv_layer(w, 3, 20, 1))
+    report("conv %dx%d x35<-20" % (w, w), *conv_layer(w, 3, 35, 20))
+break_even()
+
+# SA_PREMOVE: back-to-back conv passes lose the MOVE, a pass over P outputs
+# then reaches 0.9 * P / (P + 16), above 80% from 128 outputs (12x12 maps).
+# what is left per pass is the array fill and drain, CONV_SLOTS + SA_COLS +
+# 1 cycles; the shipped 4x4 conv2 (P = 16) stays fill-bound below 50%
+network(20, 35, premove=1)
+print("conv layers, 20 output channels, SA_PREMOVE")
+for w in (4, 12, 15, 30, 62):
+    report("conv %dx%d x35<-20" % (w, w), *conv_layer(w, 3, 35, 20, premove=1))
+break_even(premove=1)
+
+# depthwise 3x3 + pointwise 1x1 against the dense 3x3 it replaces
+print("separable block, 30x30 outputs x20 <- 20")
+dw = dw_layer(30, 3, 20)
+pw = conv_layer(30, 1, 20, 20)
+report("depthwise 3x3", *dw)
+report("pointwise 1x1", *pw)
+report("separable total", dw[0] + pw[0], dw[1] + pw[1])
+report("dense 3x3", *conv_layer(30, 3, 20, 20))
+
+# Winograd F(2x2,3x3) against direct 3x3. direct needs cin passes of
+# out^2 pixels, Winograd 16 * ceil(cin / 9) passes of out^2 / 4 tiles, so
+# it needs about 9 input channels per pass and maps large enough to hide
+# the per-pass fill; the shipped 4x4 conv2 and the one-channel conv1 lose
+print("Winograd F(2x2,3x3) against direct")
+for w, cout, cin in ((12, 5, 1), (4, 5, 5), (10, 20, 9), (30, 20, 18), (30, 35, 20)):
+    report("direct   %dx%d x%d<-%d" % (w, w, cout, cin), *conv_layer(w, 3, cout, cin))
+    report("winograd %dx%d x%d<-%d" % (w, w, cout, cin), *wino_layer(w, cout, cin))
+
+# 1x1 packs 9 channels per pass, 5x5 runs 9 + 9 + 7 taps in three passes
+print("kernel size, 30x30 outputs x20 <- 18")
+for k in (1, 3, 5):
+    report("conv %dx%d" % (k, k), *conv_layer(30, k, 20, 18))
+
+# int4 conv2 / fc1: two psum lanes per column halve the passes, weight
+# bytes (and load beats) halve with them
+print("int4 weights, 30x30 outputs x20 <- 18 and fc 320 -> 10")
+for lanes, name in ((1, "int8"), (2, "int4")):
+    report("conv %s" % name, *conv_layer(30, 3, 20, 18, lanes))
+    report("fc %s" % name, *fc_layer(320, 10, lanes))
+
+# FC1_GAP: one fc1 input per conv2 channel instead of the 2x2 flatten,
+# a quarter of the fc1 weights and passes
+print("fc1 after 2x2 pool + flatten against global average pool, x35 channels")
+report("flatten fc1 140->10", *fc_layer(35 * 4, 10))
+report("gap fc1 35->10", *fc_layer(35, 10))
+
+# CONV1_A16: int16 input, every conv1 pass runs for the low and the high
+# byte, conv1 costs twice its passes and the later layers nothing
+print("conv1 12x12 x5 <- 1, uint8 against int16 input")
+c8 = conv_layer(12, 3, 5, 1)
+report("conv1 uint8", *c8)
+report("conv1 int16", 2 * c8[0], c8[1])
+
+# CONV2_SKIP: the residual add sits in the conv2 requant and costs no cycle,
+# a concat skip makes fc1 read the x channels too. same-size 12x12 conv2
+print("conv2 skip, 12x12 x5<-5, fc1 after 2x2 pool + flatten")
+report("conv2 same 12x12", *conv_layer(12, 3, 5, 5))
+report("fc1 plain 180->10", *fc_layer(5 * 36, 10))
+report("fc1 concat 360->10", *fc_layer(10 * 36, 10))
+
+# FRAME_DS: load_frame reads the raw frame at the load_input rate of one
+# beat a cycle, 4 gray or 2 RGB565 pixels; the box filter and the quant
+# add no cycle, the frame load grows with FRAME_DS**2
+print("input load, 28x28 uint8 against raw frames")
+print("  %-26s %7d cycles" % ("load_input 28x28", 28 * 28 // 4 + 1))
+for ds in (2, 4):
+    for fmt, ppb in (("gray8", 4), ("rgb565", 2)):
+        print("  %-26s %7d cycles" % ("load_frame %dx%d %s" % (28 * ds, 28 * ds, fmt), (28 * ds) ** 2 // ppb + 1))
+
+# FC_PIPE: the convs of image N+1 overlap fc1 / fc2 of image N on the FC
+# engine (FC_MACS neurons per cycle, then one logit per cycle into the
+# top-k), an image then costs the slower of the two stages
+def fc_engine(fc1_in, fc1_out, fc2_in, fc2_out, macs):
+    return (math.ceil(fc1_out / macs) * fc1_in + math.ceil(fc2_out / macs) * fc2_in + fc2_out)
+
+
+def pipeline(conv1_num, conv2_num, macs, input_width=28):
+    conv1_w = input_width // 2 - 2
+    conv2_w = conv1_w // 2 - 2
+    load = input_width * input_width // 4 + 1
+    conv = load + conv_layer(conv1_w, 3, conv1_num, 1)[0] + conv_layer(conv2_w, 3, conv2_num, conv1_num)[0]
+    fc_in = conv2_num * 4
+    fc_arr = fc_layer(fc_in, 10)[0] + fc_layer(10, 10)[0]
+    fc_eng = fc_engine(fc_in, 10, 10, 10, macs)
+    print("  %-26s %7d cycles/image sequential, %7d pipelined (conv %d, fc engine %d)" %
+          ("x%d, x%d<-%d, %d MACs" % (conv1_num, conv2_num, conv1_num, macs),
+           conv + fc_arr, max(conv, fc_eng), conv, fc_eng))
+
+
+print("FC_PIPE throughput, input load included")
+for macs in (1, 2, 5):
+    pipeline(5, 5, macs)
+pipeline(20, 35, 2)
+
+# NICE_NUM (e203_subsys_nice_disp): images go round-robin to NICE_NUM cores
+# that share one ICB port. the input beats of all cores queue on it, each
+# beat holds the port MEM_LAT + 1 cycles as the memory of tb/tb_nice_disp.v,
+# so an image costs the slower of its share of the cores and its bus time.
+# DTCM_PORT puts the odd cores on a second port, the busier port carries
+# ceil(num / 2) of every num images.
+# a steady-state estimate, the issue and collect ops of the E203 are left out
+def dispatch(num, dtcm_port=0, conv1_num=5, conv2_num=5, mem_lat=1, input_width=28):
+    conv1_w = input_width // 2 - 2
+    conv2_w = conv1_w // 2 - 2
+    bus = (input_width * input_width // 4) * (mem_lat + 1)
+    compute = (conv_layer(conv1_w, 3, conv1_num, 1)[0] + conv_layer(conv2_w, 3, conv2_num, conv1_num)[0] +
+               fc_layer(conv2_num * 4, 10)[0] + fc_layer(10, 10)[0])
+    share = math.ceil(num / 2) / num if (dtcm_port and num > 1) else 1
+    per_image = max(bus * share, (bus + compute) / num)
+    print("  %-30s %7d cycles/image  %4.2fx  (bus %d, core %d)" %
+          ("NICE_NUM = %d%s, MEM_LAT = %d" % (num, " DTCM" if dtcm_port else "", mem_lat),
+           per_image, (bus + compute) / per_image, bus, bus + compute))
+
+
+print("NICE_NUM batch throughput, model of tb/tb_nice_disp.v")
+for mem_lat in (1, 4):
+    for dtcm_port in (0, 1):
+        for num in (1, 2, 4):
+            dispatch(num, dtcm_port, mem_lat=mem_lat)
@@ -0,0 +1,65 @@
+import random
+import sys
+
+# camera front end of the NICE core (FRAME_DS, custom3_load_frame): a raw
+# (28 * ds)^2 frame, 8-bit gray or RGB565, to luma, box mean over ds x ds,
+# then the input quantisation of quant_MNIST.py, bit for bit as the core
+#
+#   python python/frame_prep.py          # check against float, ds = 1..8
+#   python python/frame_prep.py 4        # only ds = 4
+
+SCALE      = 1 / 127.5                   # quant_MNIST.py, after Normalize(0.5, 0.5)
+ZERO_POINT = 127
+WIDTH      = 28
+
+
+def luma565(p):
+    r, g, b = (p >> 11) & 0x1f, (p >> 5) & 0x3f, p & 0x1f
+    r, g, b = (r << 3) | (r >> 2), (g << 2) | (g >> 4), (b << 3) | (b >> 2)
+    return (77 * r + 150 * g + 29 * b + 128) >> 8
+
+
+def quant(s, ds):
+    """quant_frame of the core: floor of the box mean by a Q20 multiply"""
+    mul = ((1 << 20) + ds * ds - 1) // (ds * ds)
+    return min(max((s * mul) >> 20, 0), 255)
+
+
+def core(frame, ds, rgb):
+    """frame: rows of raw pixels, 16-bit for RGB565"""
+    px = [[luma565(p) if rgb else p for p in row] for row in frame]
+    return [[quant(sum(px[y * ds + i][x * ds + j] for i in range(ds) for j in range(ds)), ds)
+             for x in range(WIDTH)] for y in range(WIDTH)]
+
+
+def ref(frame, ds, rgb):
+    """float luma and mean, then torch.round (half to even) as quant_MNIST.py"""
+    def y(p):
+        if not rgb:
+            return p
+        r, g, b = ((p >> 11) & 0x1f) * 255 / 31, ((p >> 5) & 0x3f) * 255 / 63, (p & 0x1f) * 255 / 31
+        return 0.299 * r + 0.587 * g + 0.114 * b
+    out = []
+    for r in range(WIDTH):
+        row = []
+        for c in range(WIDTH):
+            m = sum(y(frame[r * ds + i][c * ds + j]) for i in range(ds) for j in range(ds)) / (ds * ds)
+            row.append(min(max(round((m / 255 - 0.5) / 0.5 / SCALE) + ZERO_POINT, 0), 255))
+        out.append(row)
+    return out
+
+
+def check(ds):
+    # the Q20 mean is the exact floor on every sum a box can reach
+    assert all(quant(s, ds) == s // (ds * ds) for s in range(255 * ds * ds + 1)), ds
+    rnd = random.Random(ds)
+    for rgb in (0, 1):
+        frame = [[rnd.randrange(1 << 16 if rgb else 256) for _ in range(WIDTH * ds)] for _ in range(WIDTH * ds)]
+        got, want = core(frame, ds, rgb), ref(frame, ds, rgb)
+        err = max(abs(got[r][c] - want[r][c]) for r in range(WIDTH) for c in range(WIDTH))
+        print("  ds %d %-7s %4dx%-4d max err %d codes" % (ds, "rgb565" if rgb else "gray8", WIDTH * ds, WIDTH * ds, err))
+
+
+if __name__ == "__main__":
+    for ds in ([int(sys.argv[1])] if len(sys.argv) > 1 else range(1, 9)):
+        check(ds)
@@ -0,0 +1,61 @@
+import torch
+
+# int4 export for the CONV2_W4 / FC1_W4 modes of the NICE core. weights are
+# symmetric int4 (zero point 0) with one scale per layer, two per byte:
+# weight k sits in nibble k % 2 of byte k / 2, flat order as the int8 arrays
+# ([n][c][tap] for conv2, [out][in] for fc1). activations stay uint8 with the
+# scales of the int8 model, so only bias and requant scale change
+#
+#   python python/train_cuda.py      # saves cnn_fp32_weights.pth and cnn_int8_weights.pth
+#   python python/int4_export.py
+
+FP32_PTH = "./python/cnn_fp32_weights.pth"
+INT8_PTH = "./python/cnn_int8_weights.pth"
+
+
+def quant_int4(w):
+    scale = w.abs().max().item() / 7
+    q = torch.clamp(torch.round(w / scale), -8, 7).to(torch.int8)
+    return q, scale
+
+
+def pack_int4(q):
+    flat = [int(v) & 0xf for v in q.flatten().tolist()]
+    if len(flat) % 2:
+        flat.append(0)
+    return [((flat[k + 1] << 4) | flat[k]) - (256 if flat[k + 1] & 0x8 else 0) for k in range(0, len(flat), 2)]
+
+
+def unpack_int4(packed, num):
+    out = []
+    for k in range(num):
+        nib = (packed[k // 2] >> (4 * (k % 2))) & 0xf
+        out.append(nib - 16 if nib & 0x8 else nib)
+    return out
+
+
+def c_array(name, vals):
+    body = ", ".join(str(v) for v in vals)
+    return "int8_t %s[%d] = {%s};" % (name, len(vals), body)
+
+
+def export(layer, w, b, scale_in, scale_out):
+    q, scale_w = quant_int4(w)
+    packed = pack_int4(q)
+    assert unpack_int4(packed, q.numel()) == q.flatten().tolist()
+    bias_int32 = [round(x / (scale_in * scale_w)) for x in b.tolist()]
+    print("// %s: scale_w = %.9f, requant scale = 1/%.1f" % (layer, scale_w, scale_out / (scale_in * scale_w)))
+    print(c_array("%s_weight_w4" % layer, packed))
+    print("int32_t %s_bias_w4[%d] = {%s};" % (layer, len(bias_int32), ", ".join(str(v) for v in bias_int32)))
+
+
+def main():
+    fp32 = torch.load(FP32_PTH, map_location="cpu")
+    int8 = torch.load(INT8_PTH, map_location="cpu")
+    # conv2 reads conv1's output, fc1 reads conv2's (through the max-pools)
+    export("conv2", fp32["conv2.weight"], fp32["conv2.bias"], float(int8["conv1.scale"]), float(int8["conv2.scale"]))
+    export("fc1",   fp32["fc1.weight"],   fp32["fc1.bias"],   float(int8["conv2.scale"]), float(int8["fc1.scale"]))
+
+
+if __name__ == "__main__":
+    main()
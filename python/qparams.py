@@ -0,0 +1,94 @@
+import random
+import sys
+
+# quant params of the NICE core (custom3_load_qp, NICE_SP_QP): zero points,
+# requant shift-adds and biases of one model as QP_WORDS int32, loaded like
+# the weights into the inactive bank so a swap flips them with the model
+#
+#   python python/qparams.py            # check the requant words, print the C array
+#   python python/qparams.py check      # only the check
+
+# shipped model, same numbers as c/data.c and cal_quant.py
+ZP = {
+    "input": 127,
+    "conv1_w": 2, "conv1_out": 159,
+    "conv2_w": 31, "conv2_out": 118,
+    "fc1_w": 7, "fc1_out": 107,
+    "fc2_w": 11,
+}
+CONV1_BIAS = [871, -16316, -9617, -21527, -7265]
+CONV2_BIAS = [-215, 2005, -2292, 4127, 441]
+FC1_BIAS   = [-318, -434, 1721, -288, -879, 872, -658, -665, 2352, -2272]
+FC2_BIAS   = [-5, 88, -71, -14, -2, -32, 22, 28, -64, 19]
+
+# requant as up to three (sign, shift) terms and a final shift, rq_t of the core
+RQ = {
+    "conv1": ([(+1, 0), (+1, 8)], 9),              # 1/510 ≈ (1 + 1/256) / 512
+    "conv2": ([(+1, 8), (+1, 10), (-1, 12)], 0),   # 1/216 ≈ 1/256 + 1/1024 - 1/4096
+    "fc1":   ([(+1, 8), (+1, 10)], 0),             # 1/206 ≈ 1/256 + 1/1024
+}
+
+# the fixed shift-adds the core had before the params were banked
+FIXED = {
+    "conv1": lambda a: (a + (a >> 8)) >> 9,
+    "conv2": lambda a: (a >> 8) + (a >> 10) - (a >> 12),
+    "fc1":   lambda a: (a >> 8) + (a >> 10),
+}
+
+
+def rq_word(terms, post):
+    """rq_t: {rsvd[5:0], s2, a2, s1, a1, s0, a0, post}, sign 01 add, 11 subtract"""
+    w = post
+    for k, (s, a) in enumerate(terms):
+        w |= ((a | ((1 if s > 0 else 3) << 5)) << (5 + 7 * k))
+    return w
+
+
+def requant(acc, w):
+    """requant() of the core on a packed rq_t"""
+    s = 0
+    for k in range(3):
+        f = (w >> (5 + 7 * k)) & 0x7f
+        sign, a = f >> 5, f & 0x1f
+        if sign == 1:
+            s += acc >> a
+        elif sign == 3:
+            s -= acc >> a
+    return s >> (w & 0x1f)
+
+
+def s32(x):
+    return ((x + (1 << 31)) & 0xffffffff) - (1 << 31)
+
+
+def blob():
+    zp = ZP
+    words = [zp["input"] | zp["conv1_w"] << 8 | zp["conv1_out"] << 16 | zp["conv2_w"] << 24,
+             zp["conv2_out"] | zp["fc1_w"] << 8 | zp["fc1_out"] << 16 | zp["fc2_w"] << 24]
+    words += [rq_word(*RQ[layer]) for layer in ("conv1", "conv2", "fc1")]
+    words += CONV1_BIAS + CONV2_BIAS + FC1_BIAS + FC2_BIAS
+    return [s32(w) for w in words]
+
+
+def check():
+    rnd = random.Random(0)
+    accs = [rnd.randrange(-(1 << 24), 1 << 24) for _ in range(20000)] + list(range(-1024, 1024))
+    for layer, (terms, post) in RQ.items():
+        w = rq_word(terms, post)
+        bad = sum(requant(a, w) != FIXED[layer](a) for a in accs)
+        print("  %-5s rq 0x%08x  %d of %d accs differ" % (layer, w, bad, len(accs)))
+        assert bad == 0, layer
+
+
+def c_array(words):
+    lines = ["#define NICE_QP_WORDS %d" % len(words), "const int32_t nice_qp[NICE_QP_WORDS] = {"]
+    for i in range(0, len(words), 5):
+        lines.append("    " + ", ".join("%d" % w for w in words[i:i + 5]) + ",")
+    lines.append("};")
+    return "\n".join(lines)
+
+
+if __name__ == "__main__":
+    check()
+    if sys.argv[1:] != ["check"]:
+        print(c_array(blob()))
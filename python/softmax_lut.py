@@ -0,0 +1,66 @@
+import math
+import random
+
+# fc2 logit scale, same numbers as fc2_bias() in cal_quant.py
+scale_in = 0.13029447197914124
+scale_w  = 0.13029447197914124
+SCALE    = scale_in * scale_w
+
+FRAC_BITS = 5                       # exp argument step = 1/32
+EXP_HI_N  = 12                      # exp(-12) rounds to 0 in Q16
+
+
+def exp_luts():
+    exp_hi = [round(math.exp(-h) * 65535) for h in range(EXP_HI_N)]
+    exp_lo = [round(math.exp(-l / (1 << FRAC_BITS)) * 65535) for l in range(1 << FRAC_BITS)]
+    return exp_hi, exp_lo
+
+
+def scale_x32(d):
+    # d * SCALE * 32 ≈ d * 139 / 256, rounded, d clamped to 16 bit (exp is 0 long before)
+    d = min(d, 0xffff)
+    return (d * 139 + 128) >> 8
+
+
+def hw_softmax(logits):
+    """bit-accurate model of the NICE softmax stage, returns Q15 probabilities"""
+    exp_hi, exp_lo = exp_luts()
+    a_max = max(logits)
+    e = []
+    for a in logits:
+        x = scale_x32(a_max - a)
+        hi = x >> FRAC_BITS
+        lo = x & ((1 << FRAC_BITS) - 1)
+        e.append(0 if hi >= EXP_HI_N else (exp_hi[hi] * exp_lo[lo]) >> 16)
+    recip = (1 << 31) // sum(e)
+    return [min((v * recip) >> 16, 32767) for v in e]
+
+
+def float_softmax(logits):
+    m = max(logits)
+    e = [math.exp(SCALE * (a - m)) for a in logits]
+    s = sum(e)
+    return [v / s for v in e]
+
+
+def print_luts():
+    exp_hi, exp_lo = exp_luts()
+    print("scale * 32 =", SCALE * 32)
+    print("exp_hi =", exp_hi)
+    print("exp_lo =", exp_lo)
+
+
+def check(num=10000):
+    random.seed(0)
+    max_err = 0.0
+    for _ in range(num):
+        logits = [random.randint(-800, 800) for _ in range(10)]
+        ref = float_softmax(logits)
+        hw  = hw_softmax(logits)
+        for r, p in zip(ref, hw):
+            max_err = max(max_err, abs(r - p / 32768))
+    print("max abs error over %d vectors: %.5f" % (num, max_err))
+
+
+print_luts()
+check()
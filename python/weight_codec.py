@@ -0,0 +1,98 @@
+import math
+import re
+
+# sparse bitmap weight blobs for the compressed loads of the NICE core
+# (CFG_WL_ZIP, rtl/e203/subsys/weight_dec.sv). a blob is the header word
+# {8'd0, fill, len[15:0]} and len payload bytes: per group of 8 weights a
+# bitmap byte, bit j set when weight j is not the fill byte, then those
+# weights in order. fill is the weight zero point, so pruned weights cost
+# one bit each
+#
+#   python python/weight_codec.py      # reads c/data.c, prints beats per layer
+
+DATA_C = "./c/data.c"
+LAYERS = ("conv1", "conv2", "fc1", "fc2")
+
+
+def encode(weights, fill):
+    """int8 weights -> blob bytes, header first"""
+    payload = []
+    for g in range(0, len(weights), 8):
+        grp = weights[g:g + 8]
+        mask = sum(1 << j for j, w in enumerate(grp) if (w & 0xff) != fill)
+        payload.append(mask)
+        payload += [w & 0xff for j, w in enumerate(grp) if mask >> j & 1]
+    assert len(payload) < (1 << 16)
+    hdr = (fill << 16) | len(payload)
+    return [hdr & 0xff, hdr >> 8 & 0xff, hdr >> 16 & 0xff, 0] + payload
+
+
+def decode(blob, size):
+    """byte model of weight_dec, returns the bank as uint8"""
+    fill = blob[2]
+    left = blob[0] | (blob[1] << 8)
+    bank = [fill] * size
+    mask = cur = grp = 0
+    for b in blob[4:4 + left]:
+        if mask == 0:
+            mask, cur, grp = b, grp, grp + 8
+        else:
+            pos = (mask & -mask).bit_length() - 1
+            if cur + pos < size:
+                bank[cur + pos] = b
+            mask &= mask - 1
+    return bank
+
+
+def raw_beats(size):
+    return math.ceil(size / 4)          # CONVX_CNT_CYCLES
+
+
+def zip_beats(blob):
+    return math.ceil(len(blob) / 4)     # header + payload, weight_dec beats
+
+
+def prune(weights, zp, ratio):
+    """set the ratio of weights closest to the zero point to it"""
+    order = sorted(range(len(weights)), key=lambda k: abs(weights[k] - zp))
+    out = list(weights)
+    for k in order[:int(ratio * len(weights))]:
+        out[k] = zp
+    return out
+
+
+def read_data_c(path=DATA_C):
+    src = open(path).read()
+    layers = {}
+    for name in LAYERS:
+        body = re.search(r"%s_weight\[\d+\]\s*=\s*\{([^}]*)\}" % name, src).group(1)
+        zp = re.search(r"%s_weight_zp\s*=\s*(-?\d+)" % name, src).group(1)
+        layers[name] = ([int(v) for v in body.replace("\n", " ").split(",") if v.strip()], int(zp))
+    return layers
+
+
+def report(layers, ratio):
+    print("pruned %d%% to the zero point" % (100 * ratio))
+    total_raw = total_zip = 0
+    for name, (w, zp) in layers.items():
+        w = prune(w, zp, ratio)
+        blob = encode(w, zp & 0xff)
+        assert decode(blob, len(w)) == [v & 0xff for v in w]
+        raw, z = raw_beats(len(w)), zip_beats(blob)
+        total_raw += raw
+        total_zip += z
+        print("  %-6s %4d weights %4d raw beats %4d zip beats  %+4d" % (name, len(w), raw, z, raw - z))
+    print("  %-6s %16s %4d raw beats %4d zip beats  %+4d" % ("total", "", total_raw, total_zip, total_raw - total_zip))
+
+
+# the shipped int8 model is dense, a bitmap byte per 8 weights makes its
+# blobs 1/8 larger, keep it on raw loads. from about 15% of the weights at
+# the zero point the blob is smaller, half pruned saves a third of the beats
+def main():
+    layers = read_data_c()
+    for ratio in (0.0, 0.25, 0.5, 0.75):
+        report(layers, ratio)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,80 @@
+import random
+
+# Winograd F(2x2,3x3) as run by CONV2_WINO in the NICE core. G is scaled by 2
+# so every transform is integer: U = G g G^T is 4x the textbook one, the
+# output transform gives 4x the direct sum and >> 2 brings it back exactly
+WINO_G  = [[2, 0, 0], [1, 1, 1], [1, -1, 1], [0, 0, 2]]
+WINO_BT = [[1, 0, -1, 0], [0, 1, 1, 0], [0, -1, 1, 0], [0, 1, 0, -1]]
+WINO_AT = [[1, 1, 1, 0], [0, 1, -1, -1]]
+# G 1 G^T: the loader keeps U of the raw kernel, MOVE takes zp * WINO_GZ off
+WINO_GZ = [4, 6, 2, 4, 6, 9, 3, 6, 2, 3, 1, 2, 4, 6, 2, 4]
+
+
+def weight_transform(g):
+    """3x3 kernel (weight - zp) -> 16 values, U[xi*4 + nu], int13"""
+    return [sum(WINO_G[xi][a] * WINO_G[nu][b] * g[a][b] for a in range(3) for b in range(3))
+            for xi in range(4) for nu in range(4)]
+
+
+def input_transform(d):
+    """4x4 patch (pooled input - zp) -> 16 values, V[xi*4 + nu], int11"""
+    return [sum(WINO_BT[xi][a] * WINO_BT[nu][b] * d[a][b] for a in range(4) for b in range(4))
+            for xi in range(4) for nu in range(4)]
+
+
+def output_transform(m):
+    """16 channel sums of U * V -> 2x2 outputs"""
+    y4 = [[sum(WINO_AT[a][xi] * WINO_AT[b][nu] * m[xi * 4 + nu] for xi in range(4) for nu in range(4))
+           for b in range(2)] for a in range(2)]
+    assert all(v % 4 == 0 for row in y4 for v in row)
+    return [[v >> 2 for v in row] for row in y4]
+
+
+def wino_conv(x, w):
+    """x[c][h][w] int9 activations, w[c][3][3] int9 weights, one output channel"""
+    cha = len(x)
+    out = len(x[0]) - 2
+    y = [[0] * out for _ in range(out)]
+    u = [weight_transform(w[c]) for c in range(cha)]
+    for ty in range(out // 2):
+        for tx in range(out // 2):
+            m = [0] * 16
+            for c in range(cha):
+                d = [row[2 * tx:2 * tx + 4] for row in x[c][2 * ty:2 * ty + 4]]
+                v = input_transform(d)
+                m = [m[p] + u[c][p] * v[p] for p in range(16)]
+            t = output_transform(m)
+            for a in range(2):
+                for b in range(2):
+                    y[2 * ty + a][2 * tx + b] = t[a][b]
+    return y
+
+
+def direct_conv(x, w):
+    cha = len(x)
+    out = len(x[0]) - 2
+    return [[sum(x[c][i + a][j + b] * w[c][a][b] for c in range(cha) for a in range(3) for b in range(3))
+             for j in range(out)] for i in range(out)]
+
+
+def check(num=200):
+    random.seed(0)
+    u_max = v_max = 0
+    for _ in range(num):
+        x = [[[random.randint(-255, 255) for _ in range(6)] for _ in range(6)] for _ in range(5)]
+        w = [[[random.randint(-255, 255) for _ in range(3)] for _ in range(3)] for _ in range(5)]
+        assert wino_conv(x, w) == direct_conv(x, w)
+        g, zp = [[random.randint(-128, 127) for _ in range(3)] for _ in range(3)], random.randint(-128, 127)
+        u_raw = weight_transform(g)
+        assert max(abs(v) for v in u_raw) <= 9 * 128
+        assert weight_transform([[v - zp for v in row] for row in g]) == [u_raw[p] - zp * WINO_GZ[p] for p in range(16)]
+        u_max = max(u_max, max(abs(v) for c in range(5) for v in weight_transform(w[c])))
+        v_max = max(v_max, max(abs(v) for v in input_transform([r[:4] for r in x[0][:4]])))
+    print("bit-exact over %d 6x6x5 maps, |U| <= %d, |V| <= %d" % (num, u_max, v_max))
+    # worst case with |g|, |d| <= 255
+    print("bounds: |U| <= %d (int13), |V| <= %d (int11), raw-kernel U in the loader <= %d (int12)" %
+          (9 * 255, 4 * 255, 9 * 128))
+
+
+if __name__ == "__main__":
+    check()
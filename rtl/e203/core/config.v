@@ -95,6 +95,10 @@
 
 `define E203_CFG_HAS_ECC
 `define E203_CFG_HAS_NICE
+`define E203_CFG_NICE_NUM 1
+//`define E203_CFG_NICE_DTCM_PORT
+//`define E203_CFG_NICE_CLK_ASYNC
+//`define E203_CFG_NICE_PREEMPT
 `define E203_CFG_SUPPORT_SHARE_MULDIV
 `define E203_CFG_SUPPORT_AMO
 `define E203_CFG_DTCM_ADDR_WIDTH 16
@@ -274,6 +274,7 @@ module e203_core(
 
   `ifdef E203_HAS_NICE//{
   input nice_mem_holdup  ,                 //O: nice occupys the memory. for avoid of dead-loop庐
+  output nice_irq_req    ,                 //O: an interrupt waits for the nice insn in flight
   // nice_req interface
   output nice_req_valid  ,                 //O: handshake flag, cmd is valid
   input  nice_req_ready  ,                 //I: handshake flag, cmd is accepted.
@@ -496,6 +497,9 @@ module e203_core(
 
 
     .excp_active            (excp_active),
+  `ifdef E203_HAS_NICE//{
+    .nice_irq_req           (nice_irq_req),
+  `endif//}
     .commit_mret            (commit_mret),
     .commit_trap            (commit_trap),
     .test_mode              (test_mode),
@@ -161,6 +161,24 @@ module e203_cpu #(
   input                          ppi_icb_rsp_excl_ok  ,
   input  [`E203_XLEN-1:0]        ppi_icb_rsp_rdata,
 
+  `ifdef E203_HAS_NICE//{
+  //////////////////////////////////////////////////////////////
+  // The ICB Interface from the perips fabric to the NICE scratchpad
+  //    * Bus cmd channel
+  input                          nice_sp_icb_cmd_valid,
+  output                         nice_sp_icb_cmd_ready,
+  input  [`E203_ADDR_SIZE-1:0]   nice_sp_icb_cmd_addr, 
+  input                          nice_sp_icb_cmd_read, 
+  input  [`E203_XLEN-1:0]        nice_sp_icb_cmd_wdata,
+  input  [`E203_XLEN/8-1:0]      nice_sp_icb_cmd_wmask,
+  //
+  //    * Bus RSP channel
+  output                         nice_sp_icb_rsp_valid,
+  input                          nice_sp_icb_rsp_ready,
+  output                         nice_sp_icb_rsp_err  ,
+  output [`E203_XLEN-1:0]        nice_sp_icb_rsp_rdata,
+  `endif//}
+
   
   input [`E203_ADDR_SIZE-1:0]    clint_region_indic,
   input                          clint_icb_enable,
@@ -282,6 +300,10 @@ module e203_cpu #(
 
   input  test_mode,
 
+  `ifdef E203_NICE_CLK_ASYNC//{
+  input  nice_clk,
+  `endif//}
+
   input  clk,
   input  rst_n
   );
@@ -461,6 +483,7 @@ module e203_cpu #(
 
   `ifdef E203_HAS_NICE//{
    /* input */ wire                   nice_mem_holdup          ; 
+   /* output*/ wire                   nice_irq_req             ; 
    /* output*/ wire                   nice_req_valid           ; 
    /* input */ wire                   nice_req_ready           ; 
    /* output*/ wire  [`E203_XLEN-1:0] nice_req_inst            ;  
@@ -484,12 +507,76 @@ module e203_cpu #(
    /* output*/ wire  [`E203_XLEN-1:0]  nice_icb_rsp_rdata      ;
    /* output*/ wire  nice_icb_rsp_err                          ; 
 
-   e203_subsys_nice_core u_e203_nice_core  (
+  `ifdef E203_NICE_DTCM_PORT//{
+   // odd NICE instances on the DTCM external port, the SoC side of it is tied off
+   wire                       nice_dtcm_icb_cmd_valid;
+   wire                       nice_dtcm_icb_cmd_ready;
+   wire [`E203_ADDR_SIZE-1:0] nice_dtcm_icb_cmd_addr ;
+   wire                       nice_dtcm_icb_cmd_read ;
+   wire [`E203_XLEN-1:0]      nice_dtcm_icb_cmd_wdata;
+   wire                       nice_dtcm_icb_rsp_valid;
+   wire                       nice_dtcm_icb_rsp_ready;
+   wire                       nice_dtcm_icb_rsp_err  ;
+   wire [`E203_XLEN-1:0]      nice_dtcm_icb_rsp_rdata;
+
+   assign ext2dtcm_icb_cmd_ready = 1'b0;
+   assign ext2dtcm_icb_rsp_valid = 1'b0;
+   assign ext2dtcm_icb_rsp_err   = 1'b0;
+   assign ext2dtcm_icb_rsp_rdata = {`E203_XLEN{1'b0}};
+  `endif//}
+
+  `ifdef E203_NICE_CLK_ASYNC//{
+   e203_subsys_nice_cdc #(
+    .NICE_NUM             (`E203_NICE_NUM)
+   ) u_e203_nice_core  (
+    
+    .core_clk             (clk_aon),
+    .core_rst_n           (rst_aon),
+    .nice_clk             (nice_clk),
+  `else//}{
+   e203_subsys_nice_disp #(
+    .NICE_NUM             (`E203_NICE_NUM)
+  `ifdef E203_NICE_DTCM_PORT//{
+   ,.DTCM_PORT            (1)
+   ,.DTCM_BASE            (`E203_DTCM_ADDR_BASE)
+   ,.DTCM_AW              (`E203_DTCM_ADDR_WIDTH)
+  `endif//}
+   ) u_e203_nice_core  (
     
     .nice_clk             (clk_aon),
     .nice_rst_n	          (rst_aon),
+
+  `ifdef E203_NICE_DTCM_PORT//{
+    .nice_dtcm_icb_cmd_valid(nice_dtcm_icb_cmd_valid),
+    .nice_dtcm_icb_cmd_ready(nice_dtcm_icb_cmd_ready),
+    .nice_dtcm_icb_cmd_addr (nice_dtcm_icb_cmd_addr ),
+    .nice_dtcm_icb_cmd_read (nice_dtcm_icb_cmd_read ),
+    .nice_dtcm_icb_cmd_wdata(nice_dtcm_icb_cmd_wdata),
+    .nice_dtcm_icb_cmd_size (),
+    .nice_dtcm_icb_rsp_valid(nice_dtcm_icb_rsp_valid),
+    .nice_dtcm_icb_rsp_ready(nice_dtcm_icb_rsp_ready),
+    .nice_dtcm_icb_rsp_rdata(nice_dtcm_icb_rsp_rdata),
+    .nice_dtcm_icb_rsp_err  (nice_dtcm_icb_rsp_err  ),
+  `else//}{
+    .nice_dtcm_icb_cmd_valid(),
+    .nice_dtcm_icb_cmd_ready(1'b0),
+    .nice_dtcm_icb_cmd_addr (),
+    .nice_dtcm_icb_cmd_read (),
+    .nice_dtcm_icb_cmd_wdata(),
+    .nice_dtcm_icb_cmd_size (),
+    .nice_dtcm_icb_rsp_valid(1'b0),
+    .nice_dtcm_icb_rsp_ready(),
+    .nice_dtcm_icb_rsp_rdata({`E203_XLEN{1'b0}}),
+    .nice_dtcm_icb_rsp_err  (1'b0),
+  `endif//}
+  `endif//}
     .nice_active	         (),
     .nice_mem_holdup	  (nice_mem_holdup),
+  `ifdef E203_NICE_PREEMPT//{
+    .nice_irq_req         (nice_irq_req),
+  `else//}{
+    .nice_irq_req         (1'b0),
+  `endif//}
     
     .nice_req_valid       (nice_req_valid),
     .nice_req_ready       (nice_req_ready),
@@ -512,7 +599,19 @@ module e203_cpu #(
     .nice_icb_rsp_valid   (nice_icb_rsp_valid),
     .nice_icb_rsp_ready   (nice_icb_rsp_ready),
     .nice_icb_rsp_rdata   (nice_icb_rsp_rdata),
-    .nice_icb_rsp_err     (nice_icb_rsp_err)	
+    .nice_icb_rsp_err     (nice_icb_rsp_err),
+
+    .nice_sp_icb_cmd_valid(nice_sp_icb_cmd_valid),
+    .nice_sp_icb_cmd_ready(nice_sp_icb_cmd_ready),
+    .nice_sp_icb_cmd_addr (nice_sp_icb_cmd_addr ),
+    .nice_sp_icb_cmd_read (nice_sp_icb_cmd_read ),
+    .nice_sp_icb_cmd_wdata(nice_sp_icb_cmd_wdata),
+    .nice_sp_icb_cmd_wmask(nice_sp_icb_cmd_wmask),
+
+    .nice_sp_icb_rsp_valid(nice_sp_icb_rsp_valid),
+    .nice_sp_icb_rsp_ready(nice_sp_icb_rsp_ready),
+    .nice_sp_icb_rsp_rdata(nice_sp_icb_rsp_rdata),
+    .nice_sp_icb_rsp_err  (nice_sp_icb_rsp_err  )
 
    );
   `endif//}
@@ -736,6 +835,7 @@ module e203_cpu #(
     ///////////////////////////////////////////
     // The nice interface
     .nice_mem_holdup         (nice_mem_holdup), //I: nice occupys the memory. for avoid of dead-loop.
+    .nice_irq_req            (nice_irq_req),    //O: an interrupt waits for the nice insn in flight.
     // nice_req interface
     .nice_req_valid     (nice_req_valid ), //O: handshake flag, cmd is valid
     .nice_req_ready     (nice_req_ready ),     //I: handshake flag, cmd is accepted.
@@ -865,6 +965,19 @@ module e203_cpu #(
     .clk_dtcm_ram            (clk_dtcm_ram ),
 
   `ifdef E203_HAS_DTCM_EXTITF //{
+  `ifdef E203_NICE_DTCM_PORT//{
+    .ext2dtcm_icb_cmd_valid  (nice_dtcm_icb_cmd_valid),
+    .ext2dtcm_icb_cmd_ready  (nice_dtcm_icb_cmd_ready),
+    .ext2dtcm_icb_cmd_addr   (nice_dtcm_icb_cmd_addr[`E203_DTCM_ADDR_WIDTH-1:0]),
+    .ext2dtcm_icb_cmd_read   (nice_dtcm_icb_cmd_read ),
+    .ext2dtcm_icb_cmd_wdata  (nice_dtcm_icb_cmd_wdata),
+    .ext2dtcm_icb_cmd_wmask  ({`E203_XLEN/8{1'b1}}),
+
+    .ext2dtcm_icb_rsp_valid  (nice_dtcm_icb_rsp_valid),
+    .ext2dtcm_icb_rsp_ready  (nice_dtcm_icb_rsp_ready),
+    .ext2dtcm_icb_rsp_err    (nice_dtcm_icb_rsp_err  ),
+    .ext2dtcm_icb_rsp_rdata  (nice_dtcm_icb_rsp_rdata),
+  `else//}{
     .ext2dtcm_icb_cmd_valid  (ext2dtcm_icb_cmd_valid),
     .ext2dtcm_icb_cmd_ready  (ext2dtcm_icb_cmd_ready),
     .ext2dtcm_icb_cmd_addr   (ext2dtcm_icb_cmd_addr ),
@@ -876,6 +989,7 @@ module e203_cpu #(
     .ext2dtcm_icb_rsp_ready  (ext2dtcm_icb_rsp_ready),
     .ext2dtcm_icb_rsp_err    (ext2dtcm_icb_rsp_err  ),
     .ext2dtcm_icb_rsp_rdata  (ext2dtcm_icb_rsp_rdata),
+  `endif//}
   `endif//}
 
     .test_mode               (test_mode),
@@ -154,6 +154,25 @@ module e203_cpu_top(
   input  [`E203_XLEN-1:0]        ppi_icb_rsp_rdata,
   // The Private Peripheral Interface (ICB): End
 
+  `ifdef E203_HAS_NICE//{
+  //////////////////////////////////////////////////////////////
+  // The NICE Scratchpad Interface (ICB): Begin
+  //    * Bus cmd channel
+  input                          nice_sp_icb_cmd_valid,
+  output                         nice_sp_icb_cmd_ready,
+  input  [`E203_ADDR_SIZE-1:0]   nice_sp_icb_cmd_addr, 
+  input                          nice_sp_icb_cmd_read, 
+  input  [`E203_XLEN-1:0]        nice_sp_icb_cmd_wdata,
+  input  [`E203_XLEN/8-1:0]      nice_sp_icb_cmd_wmask,
+  //
+  //    * Bus RSP channel
+  output                         nice_sp_icb_rsp_valid,
+  input                          nice_sp_icb_rsp_ready,
+  output                         nice_sp_icb_rsp_err  ,
+  output [`E203_XLEN-1:0]        nice_sp_icb_rsp_rdata,
+  // The NICE Scratchpad Interface (ICB): End
+  `endif//}
+
   //////////////////////////////////////////////////////////////
   // The CLINT Interface (ICB): Begin
   output                         clint_icb_cmd_valid,
@@ -227,6 +246,11 @@ module e203_cpu_top(
   // The test mode signal
   input  test_mode,
 
+  `ifdef E203_NICE_CLK_ASYNC//{
+  // The NICE accelerator clock
+  input  nice_clk,
+  `endif//}
+
   // The Clock
   input  clk,
 
@@ -442,6 +466,20 @@ module e203_cpu_top(
     .ppi_icb_rsp_excl_ok   (ppi_icb_rsp_excl_ok  ),
     .ppi_icb_rsp_rdata     (ppi_icb_rsp_rdata),
 
+  `ifdef E203_HAS_NICE//{
+    .nice_sp_icb_cmd_valid (nice_sp_icb_cmd_valid),
+    .nice_sp_icb_cmd_ready (nice_sp_icb_cmd_ready),
+    .nice_sp_icb_cmd_addr  (nice_sp_icb_cmd_addr ),
+    .nice_sp_icb_cmd_read  (nice_sp_icb_cmd_read ),
+    .nice_sp_icb_cmd_wdata (nice_sp_icb_cmd_wdata),
+    .nice_sp_icb_cmd_wmask (nice_sp_icb_cmd_wmask),
+
+    .nice_sp_icb_rsp_valid (nice_sp_icb_rsp_valid),
+    .nice_sp_icb_rsp_ready (nice_sp_icb_rsp_ready),
+    .nice_sp_icb_rsp_err   (nice_sp_icb_rsp_err  ),
+    .nice_sp_icb_rsp_rdata (nice_sp_icb_rsp_rdata),
+  `endif//}
+
     .clint_region_indic      (clint_region_indic),
     .clint_icb_enable        (clint_icb_enable),
     .clint_icb_cmd_valid     (clint_icb_cmd_valid),
@@ -544,6 +582,9 @@ module e203_cpu_top(
 
     .test_mode     (test_mode), 
   `ifndef E203_HAS_LOCKSTEP//{
+  `endif//}
+  `ifdef E203_NICE_CLK_ASYNC//{
+    .nice_clk      (nice_clk),
   `endif//}
     .rst_n         (rst_n),
     .clk           (clk  ) 
@@ -31,6 +31,9 @@ module e203_exu(
   output commit_trap,
   output exu_active,
   output excp_active,
+  `ifdef E203_HAS_NICE//{
+  output nice_irq_req,
+  `endif//}
 
   output core_wfi,
   output tm_stop,
@@ -773,6 +776,9 @@ module e203_exu(
     .nonflush_cmt_ena    (nonflush_cmt_ena),
 
     .excp_active         (excp_active),
+  `ifdef E203_HAS_NICE//{
+    .nice_irq_req        (nice_irq_req),
+  `endif//}
 
     .amo_wait            (amo_wait     ),
 
@@ -36,6 +36,10 @@ module e203_exu_commit(
 
   output  excp_active,
 
+  `ifdef E203_HAS_NICE//{
+  output  nice_irq_req,
+  `endif//}
+
   input   amo_wait,
 
   output  wfi_halt_ifu_req,
@@ -293,6 +297,9 @@ module e203_exu_commit(
   `endif//}
 
     .excp_active (excp_active),
+  `ifdef E203_HAS_NICE//{
+    .nice_irq_req (nice_irq_req),
+  `endif//}
     .amo_wait (amo_wait),
 
     .clk   (clk  ),
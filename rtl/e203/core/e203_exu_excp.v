@@ -115,6 +115,10 @@ module e203_exu_excp(
 
   output  excp_active,
 
+  `ifdef E203_HAS_NICE//{
+  output  nice_irq_req,
+  `endif//}
+
   input   clk,
   input   rst_n
   );
@@ -373,6 +377,12 @@ module e203_exu_excp(
                                   | (tmr_irq_r & mtie_r)
                                   );
   assign irq_req     = (~irq_mask) & irq_req_raw;
+
+  `ifdef E203_HAS_NICE//{
+    // The IRQ is only taken with the OITF empty, so a long NICE instruction
+    //   in flight holds it off; the NICE sees this and answers early
+  assign nice_irq_req = irq_req;
+  `endif//}
   assign wfi_irq_req = (~wfi_irq_mask) & irq_req_raw;
 
   assign irq_req_active = wfi_flag_r ? wfi_irq_req : irq_req; 
@@ -8,8 +8,11 @@
 // ====================================================================
 
 module PE_r  #(
-  parameter int L_WIDTH = 32,
-  parameter int S_WIDTH = 8
+  parameter int L_WIDTH = 32,   // accumulator, below 32 the psum saturates
+  parameter int S_WIDTH = 8,
+  parameter int A_WIDTH = 9,    // activation
+  parameter int W_WIDTH = 9,    // stationary weight
+  parameter int W4_PACK = 0     // int4 pass on one multiplier, weight_reg = w1 * 2**16 + w0
 )(
   // system
   input  logic                     PE_clk,
@@ -19,34 +22,48 @@ module PE_r  #(
   input  logic                     PE_mode,      // fix weight
   input  logic                     PE_en_up,     // store mode
   input  logic                     PE_en_left,   // calculation mode
+  input  logic                     PE_w4,        // two int4 weights, two int16 psum lanes
   output logic                     PE_en_down,
+  output logic                     PE_sat,       // psum clamped to L_WIDTH this cycle
 
   // data  
   input  logic signed [31:0]       PE_data_up,
   output logic signed [31:0]       PE_data_down,
 
-  input  logic signed [8:0]        PE_data_left
+  input  logic signed [A_WIDTH-1:0] PE_data_left
 );
 
-  typedef logic signed [31:0] int32_t;
-  typedef logic signed [8:0]  int9_t;
+  typedef logic signed [L_WIDTH-1:0] acc_t;
+  typedef logic signed [A_WIDTH-1:0] act_t;
+  typedef logic signed [W_WIDTH-1:0] wgt_t;
 
   logic       en_down_reg;
-  int32_t     data_down_reg;
-  int9_t      weight_reg;
+  acc_t       data_down_reg;
+  wgt_t       weight_reg;
+  logic       sat_reg;
+
+  // psum one bit wider than the accumulator, an overflow shows as differing top bits
+  logic signed [L_WIDTH:0] mac;
+  logic                    mac_ovf;
+  acc_t                    mac_sat;
+
+  assign mac     = PE_data_left * weight_reg + $signed(PE_data_up[L_WIDTH-1:0]);
+  assign mac_ovf = (L_WIDTH < 32) && (mac[L_WIDTH] != mac[L_WIDTH-1]);
+  assign mac_sat = mac[L_WIDTH] ? {1'b1, {(L_WIDTH-1){1'b0}}} : {1'b0, {(L_WIDTH-1){1'b1}}};
 
   always_ff @(posedge PE_clk or negedge PE_rst_n) begin
     if (!PE_rst_n) begin
       en_down_reg    <= 1'b0;
       data_down_reg  <= '0;
       weight_reg     <= '0;
+      sat_reg        <= 1'b0;
     end
     else begin
       // ----------------------
       // store mode
       // ----------------------
       if (PE_en_up & PE_mode) begin
-        weight_reg    <= $signed(PE_data_up[9-1:0]); 
+        weight_reg    <= $signed(PE_data_up[W_WIDTH-1:0]); 
         data_down_reg <= PE_data_up;
         en_down_reg   <= 1'b1;
       end 
@@ -57,15 +74,22 @@ module PE_r  #(
       // ----------------------
       // calculation mode
       // ----------------------
+      sat_reg <= PE_en_left & ~PE_w4 & mac_ovf;
+
       if (PE_en_left) begin
-        data_down_reg  <= PE_data_left * weight_reg + PE_data_up;
+        if (PE_w4 && !W4_PACK)
+          data_down_reg <= {16'(PE_data_left * $signed(weight_reg[7:4]) + $signed(PE_data_up[31:16])),
+                            16'(PE_data_left * $signed(weight_reg[3:0]) + $signed(PE_data_up[15:0]))};
+        else  // W4_PACK: both products in one psum, split with a sign correction below the array
+          data_down_reg <= mac_ovf ? mac_sat : acc_t'(mac);
       end 
     end
   end
 
   // output
   assign PE_en_down    = en_down_reg;
-  assign PE_data_down  = data_down_reg;
+  assign PE_data_down  = 32'(data_down_reg);   // sign-extended
+  assign PE_sat        = sat_reg;
 
 endmodule
 
@@ -0,0 +1,86 @@
+//=====================================================================
+//
+// Designer   : FyF
+//
+// Description:
+//  im2col address generator for the conv layers of the NICE core
+//  Each lane walks the output map in raster order, lane i one cycle
+//  behind lane i-1 like the rows / columns of the systolic array,
+//  and registers the input position it reads for its kernel tap
+//
+// ====================================================================
+
+module conv_addr_gen #(
+  parameter int LANES     = 9,
+  parameter int OUT_WIDTH = 12,   // output map width
+  parameter int FIRST     = 1,    // cnt of the first step of lane 0
+  parameter int STRIDE    = 1,
+  parameter int PAD       = 0,
+  parameter int PF        = 2,    // pool factor in front of the conv
+  parameter int MAP_WIDTH = 14,   // pooled input map width
+  parameter int OW        = (OUT_WIDTH > 1) ? $clog2(OUT_WIDTH) : 1,
+  parameter int AW        = $clog2(PF * MAP_WIDTH)
+)(
+  // system
+  input  logic                clk,
+  input  logic                rst_n,
+
+  // control
+  input  logic                clear,             // end of the pass
+  input  int                  cnt,               // cal_convX_cnt
+  input  int                  tap_row [LANES],   // kernel tap of each lane, fixed over a pass
+  input  int                  tap_col [LANES],
+
+  // address
+  output logic [OW-1:0]       out_row [LANES],   // output pixel
+  output logic [OW-1:0]       out_col [LANES],
+  output logic [AW-1:0]       in_row  [LANES],   // top-left input pixel of its pool window
+  output logic [AW-1:0]       in_col  [LANES],
+  output logic                in_pad  [LANES]    // outside the map, reads the zero point
+);
+
+  always_ff @(posedge clk or negedge rst_n) begin
+    if (!rst_n) begin
+      out_row <= '{default: '0};
+      out_col <= '{default: '0};
+      in_row  <= '{default: '0};
+      in_col  <= '{default: '0};
+      in_pad  <= '{default: 1'b0};
+    end
+    else begin
+      for (int i = 0; i < LANES; i++) begin
+        int row_n, col_n;
+        int r, c;
+
+        // next output pixel
+        row_n = out_row[i];
+        col_n = out_col[i];
+        if (clear) begin
+          row_n = 0;
+          col_n = 0;
+        end
+        else if (cnt >= FIRST + i) begin
+          if (col_n == OUT_WIDTH - 1) begin
+            col_n = 0;
+            row_n = (row_n == OUT_WIDTH - 1) ? 0 : (row_n + 1);
+          end
+          else begin
+            col_n = col_n + 1;
+          end
+        end
+
+        // its input position, registered with it so the buffer read
+        // in sa_input_res starts from a flop
+        r = PF * (row_n * STRIDE + tap_row[i] - PAD);
+        c = PF * (col_n * STRIDE + tap_col[i] - PAD);
+
+        out_row[i] <= row_n[OW-1:0];
+        out_col[i] <= col_n[OW-1:0];
+        in_row[i]  <= r[AW-1:0];
+        in_col[i]  <= c[AW-1:0];
+        in_pad[i]  <= (r < 0) || (c < 0) || (r >= PF * MAP_WIDTH) || (c >= PF * MAP_WIDTH);
+      end
+    end
+  end
+
+endmodule
@@ -158,6 +158,26 @@
 `endif//}
 `ifdef E203_CFG_HAS_NICE//{
    `define E203_HAS_NICE
+   `ifdef E203_CFG_NICE_NUM//{
+     `define E203_NICE_NUM `E203_CFG_NICE_NUM
+   `else//}{
+     `define E203_NICE_NUM 1
+   `endif//}
+   `ifdef E203_CFG_NICE_CLK_ASYNC//{
+     `define E203_NICE_CLK_ASYNC
+   `endif//}
+   // odd NICE instances stream DTCM images over the DTCM external port,
+   // needs the synchronous NICE and takes the port from the SoC
+   `ifdef E203_CFG_NICE_DTCM_PORT//{
+   `ifndef E203_CFG_NICE_CLK_ASYNC//{
+   `ifdef E203_CFG_HAS_DTCM//{
+     `define E203_NICE_DTCM_PORT
+   `endif//}
+   `endif//}
+   `endif//}
+   `ifdef E203_CFG_NICE_PREEMPT//{
+     `define E203_NICE_PREEMPT
+   `endif//}
    //`define E203_HAS_CSR_NICE 
 `endif//}
 
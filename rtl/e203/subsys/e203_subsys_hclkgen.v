@@ -46,6 +46,7 @@ module e203_subsys_hclkgen(
   output  inspect_16m_clk,
   output  inspect_pll_clk,
 
+  output  niceclk,// The NICE accelerator clock
   output  hfclk// The generated clock by this module
   );
 
@@ -53,6 +54,7 @@ module e203_subsys_hclkgen(
 
   // The PLL module
   wire plloutclk;
+  wire pllniceclk;
   wire pll_powerd = pll_ASLEEP | hfclkrst; // Power down by PMU or the register programmed
   e203_subsys_pll u_e203_subsys_pll(
     .pll_asleep (pll_powerd ),
@@ -61,6 +63,7 @@ module e203_subsys_hclkgen(
     .pll_M   (pll_M ),
     .pll_N   (pll_N ),
     .pllrefclk  (hfextclk ),
+    .pllniceclk (pllniceclk),
     .plloutclk  (plloutclk ) 
   );
 
@@ -109,6 +112,9 @@ module e203_subsys_hclkgen(
 
   assign hfclk = test_mode ? hfextclk : gfcm_clk;
 
+  // The NICE clock, straight from the PLL
+  assign niceclk = test_mode ? hfextclk : pllniceclk;
+
   assign inspect_16m_clk = hfextclk ;
   assign inspect_pll_clk = plloutclk;
 
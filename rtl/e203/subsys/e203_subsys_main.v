@@ -247,6 +247,7 @@ module e203_subsys_main(
  wire inspect_mem_rsp_ready;
  wire inspect_core_clk;
  wire inspect_pll_clk;
+ wire niceclk;
  wire inspect_16m_clk;
 
  assign inspect_pc_29b = inspect_pc[29];
@@ -362,6 +363,7 @@ module e203_subsys_main(
     .inspect_pll_clk(inspect_pll_clk),
     .inspect_16m_clk(inspect_16m_clk),
                 
+    .niceclk     (niceclk     ),
     .hfclk       (hfclk       ) // The generated clock by this module
   );
 
@@ -391,6 +393,20 @@ module e203_subsys_main(
   wire                         ppi_icb_rsp_err  ;
   wire [`E203_XLEN-1:0]        ppi_icb_rsp_rdata;
 
+  `ifdef E203_HAS_NICE//{
+  wire                         nice_sp_icb_cmd_valid;
+  wire                         nice_sp_icb_cmd_ready;
+  wire [`E203_ADDR_SIZE-1:0]   nice_sp_icb_cmd_addr; 
+  wire                         nice_sp_icb_cmd_read; 
+  wire [`E203_XLEN-1:0]        nice_sp_icb_cmd_wdata;
+  wire [`E203_XLEN/8-1:0]      nice_sp_icb_cmd_wmask;
+
+  wire                         nice_sp_icb_rsp_valid;
+  wire                         nice_sp_icb_rsp_ready;
+  wire                         nice_sp_icb_rsp_err  ;
+  wire [`E203_XLEN-1:0]        nice_sp_icb_rsp_rdata;
+  `endif//}
+
   
   wire                         clint_icb_cmd_valid;
   wire                         clint_icb_cmd_ready;
@@ -563,6 +579,20 @@ module e203_subsys_main(
     .ppi_icb_rsp_err       (ppi_icb_rsp_err  ),
     .ppi_icb_rsp_rdata     (ppi_icb_rsp_rdata),
 
+  `ifdef E203_HAS_NICE//{
+    .nice_sp_icb_cmd_valid (nice_sp_icb_cmd_valid),
+    .nice_sp_icb_cmd_ready (nice_sp_icb_cmd_ready),
+    .nice_sp_icb_cmd_addr  (nice_sp_icb_cmd_addr ),
+    .nice_sp_icb_cmd_read  (nice_sp_icb_cmd_read ),
+    .nice_sp_icb_cmd_wdata (nice_sp_icb_cmd_wdata),
+    .nice_sp_icb_cmd_wmask (nice_sp_icb_cmd_wmask),
+    
+    .nice_sp_icb_rsp_valid (nice_sp_icb_rsp_valid),
+    .nice_sp_icb_rsp_ready (nice_sp_icb_rsp_ready),
+    .nice_sp_icb_rsp_err   (nice_sp_icb_rsp_err  ),
+    .nice_sp_icb_rsp_rdata (nice_sp_icb_rsp_rdata),
+  `endif//}
+
     .plic_icb_cmd_valid     (plic_icb_cmd_valid),
     .plic_icb_cmd_ready     (plic_icb_cmd_ready),
     .plic_icb_cmd_addr      (plic_icb_cmd_addr ),
@@ -612,6 +642,9 @@ module e203_subsys_main(
     .mem_icb_rsp_rdata  (mem_icb_rsp_rdata),
 
     .test_mode     (test_mode), 
+  `ifdef E203_NICE_CLK_ASYNC//{
+    .nice_clk      (niceclk),
+  `endif//}
     .clk           (hfclk  ),
     .rst_n         (core_rst_n) 
   );
@@ -736,6 +769,20 @@ e203_subsys_clint u_e203_subsys_clint(
     .ppi_icb_rsp_err       (ppi_icb_rsp_err  ),
     .ppi_icb_rsp_rdata     (ppi_icb_rsp_rdata),
 
+  `ifdef E203_HAS_NICE//{
+    .nice_sp_icb_cmd_valid (nice_sp_icb_cmd_valid),
+    .nice_sp_icb_cmd_ready (nice_sp_icb_cmd_ready),
+    .nice_sp_icb_cmd_addr  (nice_sp_icb_cmd_addr ),
+    .nice_sp_icb_cmd_read  (nice_sp_icb_cmd_read ),
+    .nice_sp_icb_cmd_wdata (nice_sp_icb_cmd_wdata),
+    .nice_sp_icb_cmd_wmask (nice_sp_icb_cmd_wmask),
+    
+    .nice_sp_icb_rsp_valid (nice_sp_icb_rsp_valid),
+    .nice_sp_icb_rsp_ready (nice_sp_icb_rsp_ready),
+    .nice_sp_icb_rsp_err   (nice_sp_icb_rsp_err  ),
+    .nice_sp_icb_rsp_rdata (nice_sp_icb_rsp_rdata),
+  `endif//}
+
   
     .sysper_icb_cmd_valid  (sysper_icb_cmd_valid),
     .sysper_icb_cmd_ready  (sysper_icb_cmd_ready),
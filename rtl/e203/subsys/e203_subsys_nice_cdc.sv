@@ -0,0 +1,308 @@
+//=====================================================================
+//
+// Designer   : FyF
+//
+// Description:
+//  NICE accelerator on its own clock (E203_CFG_NICE_CLK_ASYNC)
+//  e203_subsys_nice_disp runs on nice_clk, the E203 side keeps the
+//  core clock. Every valid/ready channel crosses through a
+//  nice_cdc_fifo: nice_req, nice_rsp, the ICB memory channel and the
+//  scratchpad. nice_clk may be faster, slower or a ratio of the core
+//  clock, nothing here assumes a phase relation
+//  - nice_rst_n is core_rst_n, asserted at once and released on nice_clk
+//  - a request is taken as soon as the FIFO has room, the E203 waits
+//    for the response anyway
+//  - nice_mem_holdup is seen a few cycles late on the core side, so it
+//    is also held from the request until its response
+//  - nice_irq_req is a level, it only needs a two-flop sync
+//
+// ====================================================================
+`include "e203_defines.v"
+
+`ifdef E203_HAS_NICE//{
+module e203_subsys_nice_cdc #(
+  parameter NICE_NUM = 1,
+  parameter FIFO_AW  = 2
+)(
+    // System
+    input                         core_clk             ,
+    input                         core_rst_n           ,
+    input                         nice_clk             ,
+    output                        nice_active	         ,
+    output                        nice_mem_holdup	     ,
+    input                         nice_irq_req         ,  // an interrupt waits, answer long ops early
+
+    // Control cmd_req
+    input                         nice_req_valid       ,
+    output                        nice_req_ready       ,
+    input  [`E203_XLEN-1:0]       nice_req_inst        ,
+    input  [`E203_XLEN-1:0]       nice_req_rs1         ,
+    input  [`E203_XLEN-1:0]       nice_req_rs2         ,
+
+    // Control cmd_rsp
+    output                        nice_rsp_valid       ,
+    input                         nice_rsp_ready       ,
+    output [`E203_XLEN-1:0]       nice_rsp_rdat        ,
+    output                        nice_rsp_err    	   ,
+
+    // Memory lsu_req
+    output                        nice_icb_cmd_valid   ,
+    input                         nice_icb_cmd_ready   ,
+    output [`E203_ADDR_SIZE-1:0]  nice_icb_cmd_addr    ,
+    output                        nice_icb_cmd_read    ,
+    output [`E203_XLEN-1:0]       nice_icb_cmd_wdata   ,
+    output [1:0]                  nice_icb_cmd_size    ,
+
+    // Memory lsu_rsp
+    input                         nice_icb_rsp_valid   ,
+    output                        nice_icb_rsp_ready   ,
+    input  [`E203_XLEN-1:0]       nice_icb_rsp_rdata   ,
+    input                         nice_icb_rsp_err     ,
+
+    // Scratchpad icb_cmd, buffers mapped into the PPI region
+    input                         nice_sp_icb_cmd_valid,
+    output                        nice_sp_icb_cmd_ready,
+    input  [`E203_ADDR_SIZE-1:0]  nice_sp_icb_cmd_addr ,
+    input                         nice_sp_icb_cmd_read ,
+    input  [`E203_XLEN-1:0]       nice_sp_icb_cmd_wdata,
+    input  [`E203_XLEN/8-1:0]     nice_sp_icb_cmd_wmask,
+
+    // Scratchpad icb_rsp
+    output                        nice_sp_icb_rsp_valid,
+    input                         nice_sp_icb_rsp_ready,
+    output [`E203_XLEN-1:0]       nice_sp_icb_rsp_rdata,
+    output                        nice_sp_icb_rsp_err
+
+  );
+
+  localparam XL = `E203_XLEN;
+  localparam AL = `E203_ADDR_SIZE;
+
+  ////////////////////////////////////////////////////////////
+  // reset of the NICE domain
+  ////////////////////////////////////////////////////////////
+  wire nice_rst_n;
+
+  sirv_gnrl_sync #(.DP(2), .DW(1)) u_nice_rst_sync (
+    .din_a (1'b1),
+    .dout  (nice_rst_n),
+    .clk   (nice_clk),
+    .rst_n (core_rst_n)
+  );
+
+  sirv_gnrl_sync #(.DP(2), .DW(1)) u_irq_sync (
+    .din_a (nice_irq_req),
+    .dout  (n_irq_req),
+    .clk   (nice_clk),
+    .rst_n (nice_rst_n)
+  );
+
+  ////////////////////////////////////////////////////////////
+  // accelerator, NICE domain
+  ////////////////////////////////////////////////////////////
+  wire              n_active;
+  wire              n_holdup;
+  wire              n_irq_req;
+  wire              n_req_valid;
+  wire              n_req_ready;
+  wire [XL-1:0]     n_req_inst;
+  wire [XL-1:0]     n_req_rs1;
+  wire [XL-1:0]     n_req_rs2;
+  wire              n_rsp_valid;
+  wire              n_rsp_ready;
+  wire [XL-1:0]     n_rsp_rdat;
+  wire              n_rsp_err;
+  wire              n_cmd_valid;
+  wire              n_cmd_ready;
+  wire [AL-1:0]     n_cmd_addr;
+  wire              n_cmd_read;
+  wire [XL-1:0]     n_cmd_wdata;
+  wire [1:0]        n_cmd_size;
+  wire              n_icb_rsp_valid;
+  wire              n_icb_rsp_ready;
+  wire [XL-1:0]     n_icb_rsp_rdata;
+  wire              n_icb_rsp_err;
+  wire              n_sp_cmd_valid;
+  wire              n_sp_cmd_ready;
+  wire [AL-1:0]     n_sp_cmd_addr;
+  wire              n_sp_cmd_read;
+  wire [XL-1:0]     n_sp_cmd_wdata;
+  wire [XL/8-1:0]   n_sp_cmd_wmask;
+  wire              n_sp_rsp_valid;
+  wire              n_sp_rsp_ready;
+  wire [XL-1:0]     n_sp_rsp_rdata;
+  wire              n_sp_rsp_err;
+
+  e203_subsys_nice_disp #(
+    .NICE_NUM             (NICE_NUM)
+  ) u_nice_disp (
+    .nice_clk             (nice_clk),
+    .nice_rst_n           (nice_rst_n),
+    .nice_active          (n_active),
+    .nice_mem_holdup      (n_holdup),
+    .nice_irq_req         (n_irq_req),
+
+    .nice_req_valid       (n_req_valid),
+    .nice_req_ready       (n_req_ready),
+    .nice_req_inst        (n_req_inst),
+    .nice_req_rs1         (n_req_rs1),
+    .nice_req_rs2         (n_req_rs2),
+
+    .nice_rsp_valid       (n_rsp_valid),
+    .nice_rsp_ready       (n_rsp_ready),
+    .nice_rsp_rdat        (n_rsp_rdat),
+    .nice_rsp_err         (n_rsp_err),
+
+    .nice_icb_cmd_valid   (n_cmd_valid),
+    .nice_icb_cmd_ready   (n_cmd_ready),
+    .nice_icb_cmd_addr    (n_cmd_addr),
+    .nice_icb_cmd_read    (n_cmd_read),
+    .nice_icb_cmd_wdata   (n_cmd_wdata),
+    .nice_icb_cmd_size    (n_cmd_size),
+
+    .nice_icb_rsp_valid   (n_icb_rsp_valid),
+    .nice_icb_rsp_ready   (n_icb_rsp_ready),
+    .nice_icb_rsp_rdata   (n_icb_rsp_rdata),
+    .nice_icb_rsp_err     (n_icb_rsp_err),
+
+    .nice_sp_icb_cmd_valid(n_sp_cmd_valid),
+    .nice_sp_icb_cmd_ready(n_sp_cmd_ready),
+    .nice_sp_icb_cmd_addr (n_sp_cmd_addr ),
+    .nice_sp_icb_cmd_read (n_sp_cmd_read ),
+    .nice_sp_icb_cmd_wdata(n_sp_cmd_wdata),
+    .nice_sp_icb_cmd_wmask(n_sp_cmd_wmask),
+
+    .nice_sp_icb_rsp_valid(n_sp_rsp_valid),
+    .nice_sp_icb_rsp_ready(n_sp_rsp_ready),
+    .nice_sp_icb_rsp_rdata(n_sp_rsp_rdata),
+    .nice_sp_icb_rsp_err  (n_sp_rsp_err  ),
+
+    // the DTCM port runs on the core clock, not with the async NICE
+    .nice_dtcm_icb_cmd_valid(),
+    .nice_dtcm_icb_cmd_ready(1'b0),
+    .nice_dtcm_icb_cmd_addr (),
+    .nice_dtcm_icb_cmd_read (),
+    .nice_dtcm_icb_cmd_wdata(),
+    .nice_dtcm_icb_cmd_size (),
+    .nice_dtcm_icb_rsp_valid(1'b0),
+    .nice_dtcm_icb_rsp_ready(),
+    .nice_dtcm_icb_rsp_rdata({XL{1'b0}}),
+    .nice_dtcm_icb_rsp_err  (1'b0)
+  );
+
+  ////////////////////////////////////////////////////////////
+  // core -> NICE
+  ////////////////////////////////////////////////////////////
+  nice_cdc_fifo #(.DW(3*XL), .AW(FIFO_AW)) u_req_cdc (
+    .wclk   (core_clk),
+    .wrst_n (core_rst_n),
+    .i_vld  (nice_req_valid),
+    .i_rdy  (nice_req_ready),
+    .i_dat  ({nice_req_inst, nice_req_rs1, nice_req_rs2}),
+    .rclk   (nice_clk),
+    .rrst_n (nice_rst_n),
+    .o_vld  (n_req_valid),
+    .o_rdy  (n_req_ready),
+    .o_dat  ({n_req_inst, n_req_rs1, n_req_rs2})
+  );
+
+  nice_cdc_fifo #(.DW(XL+1), .AW(FIFO_AW)) u_icb_rsp_cdc (
+    .wclk   (core_clk),
+    .wrst_n (core_rst_n),
+    .i_vld  (nice_icb_rsp_valid),
+    .i_rdy  (nice_icb_rsp_ready),
+    .i_dat  ({nice_icb_rsp_err, nice_icb_rsp_rdata}),
+    .rclk   (nice_clk),
+    .rrst_n (nice_rst_n),
+    .o_vld  (n_icb_rsp_valid),
+    .o_rdy  (n_icb_rsp_ready),
+    .o_dat  ({n_icb_rsp_err, n_icb_rsp_rdata})
+  );
+
+  nice_cdc_fifo #(.DW(AL+1+XL+XL/8), .AW(FIFO_AW)) u_sp_cmd_cdc (
+    .wclk   (core_clk),
+    .wrst_n (core_rst_n),
+    .i_vld  (nice_sp_icb_cmd_valid),
+    .i_rdy  (nice_sp_icb_cmd_ready),
+    .i_dat  ({nice_sp_icb_cmd_addr, nice_sp_icb_cmd_read, nice_sp_icb_cmd_wdata, nice_sp_icb_cmd_wmask}),
+    .rclk   (nice_clk),
+    .rrst_n (nice_rst_n),
+    .o_vld  (n_sp_cmd_valid),
+    .o_rdy  (n_sp_cmd_ready),
+    .o_dat  ({n_sp_cmd_addr, n_sp_cmd_read, n_sp_cmd_wdata, n_sp_cmd_wmask})
+  );
+
+  ////////////////////////////////////////////////////////////
+  // NICE -> core
+  ////////////////////////////////////////////////////////////
+  nice_cdc_fifo #(.DW(XL+1), .AW(FIFO_AW)) u_rsp_cdc (
+    .wclk   (nice_clk),
+    .wrst_n (nice_rst_n),
+    .i_vld  (n_rsp_valid),
+    .i_rdy  (n_rsp_ready),
+    .i_dat  ({n_rsp_err, n_rsp_rdat}),
+    .rclk   (core_clk),
+    .rrst_n (core_rst_n),
+    .o_vld  (nice_rsp_valid),
+    .o_rdy  (nice_rsp_ready),
+    .o_dat  ({nice_rsp_err, nice_rsp_rdat})
+  );
+
+  nice_cdc_fifo #(.DW(AL+1+XL+2), .AW(FIFO_AW)) u_icb_cmd_cdc (
+    .wclk   (nice_clk),
+    .wrst_n (nice_rst_n),
+    .i_vld  (n_cmd_valid),
+    .i_rdy  (n_cmd_ready),
+    .i_dat  ({n_cmd_addr, n_cmd_read, n_cmd_wdata, n_cmd_size}),
+    .rclk   (core_clk),
+    .rrst_n (core_rst_n),
+    .o_vld  (nice_icb_cmd_valid),
+    .o_rdy  (nice_icb_cmd_ready),
+    .o_dat  ({nice_icb_cmd_addr, nice_icb_cmd_read, nice_icb_cmd_wdata, nice_icb_cmd_size})
+  );
+
+  nice_cdc_fifo #(.DW(XL+1), .AW(FIFO_AW)) u_sp_rsp_cdc (
+    .wclk   (nice_clk),
+    .wrst_n (nice_rst_n),
+    .i_vld  (n_sp_rsp_valid),
+    .i_rdy  (n_sp_rsp_ready),
+    .i_dat  ({n_sp_rsp_err, n_sp_rsp_rdata}),
+    .rclk   (core_clk),
+    .rrst_n (core_rst_n),
+    .o_vld  (nice_sp_icb_rsp_valid),
+    .o_rdy  (nice_sp_icb_rsp_ready),
+    .o_dat  ({nice_sp_icb_rsp_err, nice_sp_icb_rsp_rdata})
+  );
+
+  ////////////////////////////////////////////////////////////
+  // status, core domain
+  ////////////////////////////////////////////////////////////
+  wire holdup_sync;
+  wire active_sync;
+
+  sirv_gnrl_sync #(.DP(2), .DW(2)) u_status_sync (
+    .din_a ({n_holdup, n_active}),
+    .dout  ({holdup_sync, active_sync}),
+    .clk   (core_clk),
+    .rst_n (core_rst_n)
+  );
+
+  // NICE ops between request and response
+  wire      req_hsked = nice_req_valid & nice_req_ready;
+  wire      rsp_hsked = nice_rsp_valid & nice_rsp_ready;
+  reg [2:0] op_pend;
+
+  always @(posedge core_clk or negedge core_rst_n) begin
+    if (!core_rst_n)
+      op_pend <= 3'd0;
+    else if (req_hsked & ~rsp_hsked)
+      op_pend <= op_pend + 1'b1;
+    else if (rsp_hsked & ~req_hsked)
+      op_pend <= op_pend - 1'b1;
+  end
+
+  assign nice_mem_holdup = (op_pend != 0) | holdup_sync;
+  assign nice_active     = (op_pend != 0) | active_sync | nice_req_valid;
+
+endmodule
+`endif//}
@@ -15,6 +15,7 @@ module e203_subsys_nice_core (
     input                         nice_rst_n	         ,
     output                        nice_active	         ,
     output                        nice_mem_holdup	     ,
+    input                         nice_irq_req         ,  // an interrupt waits, answer long ops early
 
     // Control cmd_req
     input                         nice_req_valid       ,
@@ -41,13 +42,138 @@ module e203_subsys_nice_core (
     input                         nice_icb_rsp_valid   ,
     output                        nice_icb_rsp_ready   ,
     input  [`E203_XLEN-1:0]       nice_icb_rsp_rdata   ,
-    input                         nice_icb_rsp_err
+    input                         nice_icb_rsp_err     ,
+
+    // Scratchpad icb_cmd, buffers mapped into the PPI region
+    input                         nice_sp_icb_cmd_valid,
+    output                        nice_sp_icb_cmd_ready,
+    input  [`E203_ADDR_SIZE-1:0]  nice_sp_icb_cmd_addr ,
+    input                         nice_sp_icb_cmd_read ,
+    input  [`E203_XLEN-1:0]       nice_sp_icb_cmd_wdata,
+    input  [`E203_XLEN/8-1:0]     nice_sp_icb_cmd_wmask,
+
+    // Scratchpad icb_rsp
+    output                        nice_sp_icb_rsp_valid,
+    input                         nice_sp_icb_rsp_ready,
+    output [`E203_XLEN-1:0]       nice_sp_icb_rsp_rdata,
+    output                        nice_sp_icb_rsp_err
 
   );
 
+  // accumulator width of the array PEs. a pass sums at most SA_ROWS
+  // products, python/acc_width.py prints the worst case per layer for the
+  // weights in c/data.c (18 bit for the shipped model). below 32 the PEs
+  // saturate and set the status word of the scratchpad, int4 lanes need 32
   parameter L_WIDTH = 32;
   parameter S_WIDTH = 8;
 
+  // conv output channels, tiled over the SA_COLS columns of the array so
+  // both must be multiples of it; pad a model with zero-weight channels
+  parameter CONV1_NUM = 5;
+  parameter CONV2_NUM = 5;
+
+  // int32 conv biases on the accumulator scale, one per output channel
+  // (python/cal_quant.py conv1_bias() / conv2_bias()). the defaults are the
+  // shipped model, other channel counts override them with CONV1_NUM / CONV2_NUM
+  parameter int CONV1_BIAS [CONV1_NUM] = '{871, -16316, -9617, -21527, -7265};
+  parameter int CONV2_BIAS [CONV2_NUM] = '{-215, 2005, -2292, 4127, 441};
+
+  // conv kernel sizes, 1, 3 or 5
+  parameter CONV1_WIDTH = 3;
+  parameter CONV2_WIDTH = 3;
+
+  // conv stride, zero padding (input zero point) and fused pooling
+  // on the layer input, POOL = 0 bypasses it for stride-2 models
+  parameter CONV1_STRIDE = 1;
+  parameter CONV1_PAD    = 0;
+  parameter CONV1_POOL   = 1;
+  parameter CONV2_STRIDE = 1;
+  parameter CONV2_PAD    = 0;
+  parameter CONV2_POOL   = 1;
+
+  // pooling in front of conv1 / conv2 and fc1: POOL_K x POOL_K windows
+  // (2 or 3) every POOL_STRIDE pixels, max or rounded average (POOL_AVG).
+  // FC1_GAP replaces the pool + flatten in front of fc1 by a global
+  // average pool, fc1 then takes one input per conv2 channel
+  parameter POOL_K       = 2;
+  parameter POOL_STRIDE  = 2;
+  parameter POOL_AVG     = 0;
+  parameter FC1_GAP      = 0;
+
+  // conv2 as a depthwise-separable block: CONV2_WIDTH depthwise per input
+  // channel, then a 1x1 pointwise conv to CONV2_NUM outputs
+  parameter CONV2_DW     = 0;
+
+  // quantisation of the depthwise half, the pointwise half is conv2 and
+  // uses its constants. from python/cal_quant.py: dw_bias() per channel on
+  // the accumulator scale, dw_scale() the divisor of the requant, the
+  // weight and output zero points. CONV2_DW needs a CONV2_DW_SCALE
+  parameter int CONV2_DW_BIAS [CONV1_NUM] = '{default: 0};
+  parameter     CONV2_DW_SCALE = 0;
+  parameter     CONV2_DW_WZP   = 0;
+  parameter     CONV2_DW_ZP    = 0;
+
+  // conv2 by Winograd F(2x2,3x3), 16 multiplies per 2x2 outputs instead of
+  // 36. needs a dense 3x3 stride-1 conv2 without padding, even output width.
+  // a pass then takes 9 input channels at one transform position, so it only
+  // wins from about 9 input channels on maps large enough to hide the pass
+  // fill (2.3x slower on the shipped 5-channel 4x4 conv2, see
+  // python/cycle_model.py, CONV2_WINO_GAIN_CHECK warns). conv1 stays direct
+  parameter CONV2_WINO   = 0;
+
+  // skip connection around conv2, x is the conv2 input (pooled conv1 output).
+  // 1: residual add, conv2 stores relu(conv2(x) + x) with both operands
+  //    requantised to the conv2 output scale
+  // 2: channel concat, fc1 reads the conv2 channels, then the x channels
+  // needs a conv2 that keeps the map size (stride 1, PAD = (WIDTH-1)/2),
+  // the add also CONV2_NUM = CONV1_NUM
+  parameter CONV2_SKIP   = 0;
+
+  // packed int4 weights, two per byte, for conv2 / fc1. each PE holds two
+  // and feeds two int16 psum lanes, a pass covers 2 * SA_COLS outputs.
+  // symmetric (zero point 0), conv1 and fc2 stay int8. CONV2_NUM is then
+  // tiled 2 * SA_COLS at a time
+  parameter CONV2_W4     = 0;
+  parameter FC1_W4       = 0;
+
+  // int16 activations into conv1, the layer that reads the sensor input.
+  // the input buffer holds signed int16 pixels (zero point 0, little
+  // endian), each conv1 pass runs twice on the int9 array inputs, low byte
+  // then high byte, and the psum adds them as lo + (hi << 8). the later
+  // layers stay uint8, only conv1 pays the doubled passes
+  parameter CONV1_A16    = 0;
+
+  // camera front end for custom3_load_frame: a raw square frame of
+  // 28 * FRAME_DS pixels, 8-bit gray or RGB565, is turned into luma,
+  // box-filtered FRAME_DS x FRAME_DS down to 28x28 and quantised on the
+  // way into the input buffer, at the load_input rate of one beat a cycle.
+  // 0 leaves the op out
+  parameter FRAME_DS     = 0;
+
+  // inter-image pipelining: fc1 / fc2 of image N run on a small FC engine
+  // of FC_MACS multipliers while the array runs the convs of image N+1.
+  // load_input / run then return the class of the previous image,
+  // fc_sync and the _wb forms drain the pipeline
+  parameter FC_PIPE      = 0;
+  parameter FC_MACS      = 2;
+
+  // register stages on the array datapath for fmax. SA_IN_PIPE: after the
+  // input mux / pool / dequant of sa_input_res. SA_OUT_PIPE: between the
+  // accumulate and the requant / clamp of sa_output_sum. each costs one
+  // cycle per pass, the array side counters run that much behind. the
+  // depth they save is not measured yet, make sweep in syn/ reports it
+  parameter SA_IN_PIPE   = 0;
+  parameter SA_OUT_PIPE  = 0;
+
+  // conv passes: the MOVE of the next pass runs in the drain of this CAL,
+  // right behind the last psum of each column, so back-to-back conv passes
+  // cost the CAL alone. it waits out a pending interrupt so that PREEMPT
+  // still finds a MOVE, see python/cycle_model.py for the utilisation
+  parameter SA_PREMOVE   = 0;
+
+  // scratchpad window, 2**SP_AW bytes, must match the o15 region in perips
+  parameter SP_AW = 13;
+
   // here we only use custom3:
   // CUSTOM0 = 7'h0b, R type
   // CUSTOM1 = 7'h2b, R tpye
@@ -96,20 +222,60 @@ module e203_subsys_nice_core (
   wire custom3_load_conv2 = custom3 && (func3 == 3'b010) && (func7 == 7'b0001100);
   wire custom3_load_fc1   = custom3 && (func3 == 3'b010) && (func7 == 7'b0001101);
   wire custom3_load_fc2   = custom3 && (func3 == 3'b010) && (func7 == 7'b0001110);
+  // 256-byte activation LUT, loaded like the weights into the inactive bank
+  wire custom3_load_act   = custom3 && (func3 == 3'b010) && (func7 == 7'b0011100);
+  // quant params of the model (zero points, biases, requant), into the inactive bank
+  wire custom3_load_qp    = custom3 && (func3 == 3'b010) && (func7 == 7'b0011110);
   wire custom3_load_input = custom3 && (func3 == 3'b110) && (func7 == 7'b0001111);
+  // FRAME_DS: load_input from a raw camera frame at rs1, rs2[0] = 1 for RGB565
+  wire custom3_load_frame = custom3 && (func3 == 3'b111) && (func7 == 7'b0011101) && (FRAME_DS != 0);
+  // run inference on the image already in the input buffer (written through the scratchpad)
+  wire custom3_run        = custom3 && (func3 == 3'b100) && (func7 == 7'b0010100);
+  // load_input / run that also write the logits and the sorted top-k to rs2
+  wire custom3_load_input_wb = custom3 && (func3 == 3'b111) && (func7 == 7'b0010110);
+  wire custom3_run_wb        = custom3 && (func3 == 3'b101) && (func7 == 7'b0010111);
+  // rd = probability of class rs1 from the last inference, Q15 or uint8 (CFG_PROB_FMT)
+  wire custom3_get_prob      = custom3 && (func3 == 3'b110) && (func7 == 7'b0011000);
+  // FC_PIPE: wait for the FC engine, rd = class of the last image
+  wire custom3_fc_sync       = custom3 && (func3 == 3'b100) && (func7 == 7'b0011001);
+  // PREEMPT: continue the parked inference, answers like the op it continues;
+  // rd = -1 when nothing is parked
+  wire custom3_resume        = custom3 && (func3 == 3'b100) && (func7 == 7'b0011011);
+  // flip the active weight bank, rd = new active bank
+  wire custom3_swap       = custom3 && (func3 == 3'b100) && (func7 == 7'b0010101);
+
+  // fine-grained ops for software kernels, one result per instruction
+  //   dot4    rd, rs1, rs2 : sum((rs1.u8[k] - in_zp) * (rs2.i8[k] - w_zp)), k = 0..3
+  //   max4    rd, rs1      : max(rs1.u8[0..3])
+  //   requant rd, rs1, rs2 : clamp(scale(rs1) + rs2.zp), rs2 = {lut, relu, zp, scale_sel}
+  //   cfg         rs1, rs2 : write rs1 to config register rs2
+  wire custom3_dot4       = custom3 && (func3 == 3'b111) && (func7 == 7'b0010000);
+  wire custom3_max4       = custom3 && (func3 == 3'b110) && (func7 == 7'b0010001);
+  wire custom3_requant    = custom3 && (func3 == 3'b111) && (func7 == 7'b0010010);
+  wire custom3_cfg        = custom3 && (func3 == 3'b011) && (func7 == 7'b0010011);
 
   ////////////////////////////////////////////////////////////
   //  multi-cyc op
   ////////////////////////////////////////////////////////////
-  wire custom_multi_cyc_op = custom3_load_conv1 | custom3_load_conv2 | custom3_load_fc1 | 
-                             custom3_load_fc2   | custom3_load_input;
+  wire custom_input_op     = custom3_load_input | custom3_load_input_wb | custom3_load_frame;
+  wire custom_run_op       = custom3_run        | custom3_run_wb;
+  wire custom_wb_op        = custom3_load_input_wb | custom3_run_wb;
+  wire custom_multi_cyc_op = custom_input_op | custom_run_op | custom3_fc_sync;
+  // weight loads, served by the weight loader into the inactive bank
+  wire custom_wl_op        = custom3_load_conv1 | custom3_load_conv2 | custom3_load_fc1 | 
+                             custom3_load_fc2   | custom3_load_act   | custom3_load_qp;
   // need access memory
   wire custom_mem_op       = custom3_load_conv1 | custom3_load_conv2 | custom3_load_fc1 | 
-                             custom3_load_fc2   | custom3_load_input;
+                             custom3_load_fc2   | custom3_load_act   | custom3_load_qp   |
+                             custom_input_op;
+  // answered from registers in the cycle after the request
+  wire custom_alu_op       = custom3_dot4 | custom3_max4 | custom3_requant | custom3_cfg |
+                             custom3_swap | custom3_get_prob | custom3_resume;
 
   ////////////////////////////////////////////////////////////
   // NICE FSM
   ////////////////////////////////////////////////////////////
+  // LOAD_CONV1..LOAD_FC2, LOAD_ACT and LOAD_QP are the states of the weight loader
   localparam IDLE       = 4'd0;
   localparam LOAD_CONV1 = 4'd1;
   localparam LOAD_CONV2 = 4'd2;
@@ -124,15 +290,29 @@ module e203_subsys_nice_core (
   localparam CAL_FC1    = 4'd11;
   localparam MOVE_FC2   = 4'd12;
   localparam CAL_FC2    = 4'd13;
+  localparam EXEC_ALU   = 4'd14;
+  localparam OUT_WB     = 4'd15;
+  localparam SOFTMAX    = 5'd16;
+  localparam FC_HAND    = 5'd17;  // FC_PIPE: hand the pooled conv2 output to the FC engine
+  localparam FC_WAIT    = 5'd18;  // FC_PIPE: wait for the FC engine to finish
+  localparam PREEMPT    = 5'd19;  // parked for an interrupt, answers NICE_RESUME
+  localparam LOAD_ACT   = 5'd20;  // weight loader: activation LUT
+  localparam LOAD_QP    = 5'd21;  // weight loader: quant params
+  localparam WINO_XF    = 5'd22;  // weight loader: CONV2_WINO weight transform
 
   // FSM state register
   integer state;
+  // weight loader state register
+  integer wl_state;
 
   wire state_is_idle       = (state == IDLE);
-  wire state_is_load_conv1 = (state == LOAD_CONV1);
-  wire state_is_load_conv2 = (state == LOAD_CONV2);
-  wire state_is_load_fc1   = (state == LOAD_FC1);
-  wire state_is_load_fc2   = (state == LOAD_FC2);
+  wire state_is_load_conv1 = (wl_state == LOAD_CONV1);
+  wire state_is_load_conv2 = (wl_state == LOAD_CONV2);
+  wire state_is_load_fc1   = (wl_state == LOAD_FC1);
+  wire state_is_load_fc2   = (wl_state == LOAD_FC2);
+  wire state_is_load_act   = (wl_state == LOAD_ACT);
+  wire state_is_load_qp    = (wl_state == LOAD_QP);
+  wire state_is_wino_xf    = (wl_state == WINO_XF);
   wire state_is_load_input = (state == LOAD_INPUT);
   wire state_is_move_conv1 = (state == MOVE_CONV1);
   wire state_is_cal_conv1  = (state == CAL_CONV1);
@@ -142,20 +322,50 @@ module e203_subsys_nice_core (
   wire state_is_cal_fc1    = (state == CAL_FC1);
   wire state_is_move_fc2   = (state == MOVE_FC2);
   wire state_is_cal_fc2    = (state == CAL_FC2);
+  wire state_is_exec_alu   = (state == EXEC_ALU);
+  wire state_is_out_wb     = (state == OUT_WB);
+  wire state_is_softmax    = (state == SOFTMAX);
+  wire state_is_fc_hand    = (state == FC_HAND);
+  wire state_is_fc_wait    = (state == FC_WAIT);
+  wire state_is_preempt    = (state == PREEMPT);
 
   wire state_is_move       = state_is_move_conv1 | state_is_move_conv2 | 
                              state_is_move_fc1   | state_is_move_fc2;
 
+  // the loader holds its response until the main FSM is back in IDLE,
+  // the main FSM takes no new instruction until that response is gone,
+  // so responses leave in program order
+  reg  wl_rsp_pend;
+  reg  main_rsp_pend;      // image answer the E203 did not take in its cycle
+  wire wl_state_is_idle    = (wl_state == IDLE);
+  wire wl_idle             = wl_state_is_idle & ~wl_rsp_pend;
+
+  // active weight bank, loads and scratchpad writes go to ~wbank_act
+  logic wbank_act;
+
   // handshake success signals
   wire nice_req_hsked;
   wire nice_icb_rsp_hsked;
   wire nice_rsp_hsked;
 
+  // scratchpad write strobes, one per writable buffer
+  wire sp_wr_conv1;
+  wire sp_wr_conv2;
+  wire sp_wr_fc1;
+  wire sp_wr_fc2;
+  wire sp_wr_act;
+  wire sp_wr_qp;
+  wire sp_wr_input;
+  wire [SP_AW-1:0] sp_wr_idx;  // byte index inside the selected buffer
+
   // finish signals
   wire load_conv1_done;
   wire load_conv2_done;
   wire load_fc1_done;
   wire load_fc2_done;
+  wire load_act_done;
+  wire load_qp_done;
+  wire conv2_xf_done;
   wire load_input_done;
   wire move_conv1_done;
   wire cal_conv1_done;
@@ -165,69 +375,103 @@ module e203_subsys_nice_core (
   wire cal_fc1_done;
   wire move_fc2_done;
   wire cal_fc2_done;
-
+  wire exec_alu_done;
+  wire out_wb_done;
+  wire softmax_done;
+  wire preempt_take;
+
+  // FC engine, free when it holds no image
+  wire fc_idle;
+
+  // CONV2_WINO: scratchpad writes to conv2 since the last weight transform
+  reg  conv2_xf_stale;
+
+  // result writeback requested by the running inference
+  reg                  out_wb_r;
+  reg [`E203_XLEN-1:0] out_addr_r;
+
+  // layer tiling, conv output channels go SA_COLS at a time, conv2 sums its
+  // input channels and kernel taps over passes, fc1 is cut into
+  // SA_ROWS x SA_COLS blocks
+  integer conv1_grp_cnt;
+  integer conv2_grp_cnt;
   integer conv2_cha_cnt;
-  integer fc1_block_cnt;
+  integer fc1_in_tile_cnt;
+  integer fc1_out_tile_cnt;
   integer fc2_block_cnt;
 
+  integer conv1_tap_cnt;
+  integer conv2_tap_cnt;
+  reg     conv2_pw_phase;  // CONV2_DW: 0 depthwise passes, 1 pointwise passes
+
+  // SA_PREMOVE: the weights of the next pass are moving in / are in,
+  // the CAL then goes on to the next CAL without a MOVE
+  reg     sa_premove;
+  wire    sa_premove_run;
+
+  // PREEMPT: with nice_irq_req up, an inference stops at the next pass
+  // boundary (a MOVE before its first cycle) or in an FC_PIPE wait and
+  // answers NICE_RESUME. the tile counters above stay where they are and
+  // resume_state holds the state to go back to, custom3_resume continues.
+  // a pass completes between two preemptions, so the op always moves on;
+  // the interrupt waits at most for LOAD_INPUT and one pass. weight loads
+  // are not preempted, they are bounded by the size of one layer.
+  // swap and the cfg of the datapath (CFG_ACT_LUT, CFG_PROB_FMT) would
+  // change the model under the parked image, they drop it like a new image
+  integer resume_state;
+  reg     preempt_ok;      // a pass or the input load finished since the op (re)started
+  wire    park_drop;       // swap / datapath cfg, set with the config registers
+
+  wire conv1_grp_last;
+  wire conv1_tap_last;
+  wire conv2_grp_last;
+  wire conv2_cha_last;
+  wire conv2_tap_last;
+  wire [31:0] conv2_cha_nxt;
+  wire [31:0] conv2_cha_grp_nxt;  // first input channel of the next group
+  wire fc1_in_tile_last;
+  wire fc1_out_tile_last;
+
   // FSM state update using behavioral description
   always @(posedge nice_clk or negedge nice_rst_n)
   begin
     if (!nice_rst_n) begin
       state <= IDLE;  // Reset state to IDLE
+      conv1_grp_cnt <= 0;
+      conv1_tap_cnt <= 0;
+      conv2_grp_cnt <= 0;
       conv2_cha_cnt <= 0;
-      fc1_block_cnt <= 0;
+      conv2_tap_cnt <= 0;
+      conv2_pw_phase <= 1'b0;
+      fc1_in_tile_cnt <= 0;
+      fc1_out_tile_cnt <= 0;
       fc2_block_cnt <= 0;
+      resume_state <= IDLE;
     end else begin
       case (state)
         IDLE: begin
-          if (nice_req_hsked && custom_multi_cyc_op) begin
-            if (custom3_load_conv1)
-              state <= LOAD_CONV1;
-            else if (custom3_load_conv2)
-              state <= LOAD_CONV2;
-            else if (custom3_load_fc1)
-              state <= LOAD_FC1;
-            else if (custom3_load_fc2)
-              state <= LOAD_FC2;
-            else if (custom3_load_input)
+          if (nice_req_hsked && custom3_resume && (resume_state != IDLE)) begin
+            state <= resume_state;
+            resume_state <= IDLE;
+          end
+          else if (nice_req_hsked && custom_multi_cyc_op) begin
+            if (custom_input_op)
               state <= LOAD_INPUT;
+            else if (custom_run_op)
+              state <= MOVE_CONV1;
+            else if (custom3_fc_sync)
+              state <= FC_WAIT;
             else
               state <= IDLE;
           end
+          else if (nice_req_hsked && custom_alu_op) begin
+            state <= EXEC_ALU;
+          end
           else begin
             state <= IDLE;
           end
         end
         
-        LOAD_CONV1: begin
-          if (load_conv1_done)
-            state <= IDLE;
-          else
-            state <= LOAD_CONV1;
-        end
-
-        LOAD_CONV2: begin
-          if (load_conv2_done)
-            state <= IDLE;
-          else
-            state <= LOAD_CONV2;
-        end
-
-        LOAD_FC1: begin
-          if (load_fc1_done)
-            state <= IDLE;
-          else
-            state <= LOAD_FC1;
-        end
-
-        LOAD_FC2: begin
-          if (load_fc2_done)
-            state <= IDLE;
-          else
-            state <= LOAD_FC2;
-        end
-
         LOAD_INPUT: begin
           if (load_input_done)
             state <= MOVE_CONV1;
@@ -243,8 +487,20 @@ module e203_subsys_nice_core (
         end
 
         CAL_CONV1: begin
-          if (cal_conv1_done)
-            state <= MOVE_CONV2;
+          if (cal_conv1_done) begin
+            if (~conv1_tap_last) begin
+              state <= sa_premove ? CAL_CONV1 : MOVE_CONV1;
+              conv1_tap_cnt <= conv1_tap_cnt + 1;
+            end else if (~conv1_grp_last) begin
+              state <= sa_premove ? CAL_CONV1 : MOVE_CONV1;
+              conv1_tap_cnt <= 0;
+              conv1_grp_cnt <= conv1_grp_cnt + 1;
+            end else begin
+              state <= MOVE_CONV2;
+              conv1_tap_cnt <= 0;
+              conv1_grp_cnt <= 0;
+            end
+          end
           else
             state <= CAL_CONV1;
         end
@@ -258,12 +514,30 @@ module e203_subsys_nice_core (
 
         CAL_CONV2: begin
           if (cal_conv2_done) begin
-            if (conv2_cha_cnt < 4) begin
-              state <= MOVE_CONV2;
-              conv2_cha_cnt <= conv2_cha_cnt + 1;
+            if (~conv2_tap_last) begin
+              state <= sa_premove ? CAL_CONV2 : MOVE_CONV2;
+              conv2_tap_cnt <= conv2_tap_cnt + 1;
+            end else if (~conv2_cha_last) begin
+              state <= sa_premove ? CAL_CONV2 : MOVE_CONV2;
+              conv2_tap_cnt <= 0;
+              conv2_cha_cnt <= conv2_cha_nxt;
+            end else if (~conv2_grp_last) begin
+              state <= sa_premove ? CAL_CONV2 : MOVE_CONV2;
+              conv2_tap_cnt <= 0;
+              conv2_cha_cnt <= conv2_cha_grp_nxt;
+              conv2_grp_cnt <= conv2_grp_cnt + 1;
+            end else if (CONV2_DW && ~conv2_pw_phase) begin
+              state <= sa_premove ? CAL_CONV2 : MOVE_CONV2;
+              conv2_tap_cnt <= 0;
+              conv2_cha_cnt <= 0;
+              conv2_grp_cnt <= 0;
+              conv2_pw_phase <= 1'b1;
             end else begin
-              state <= MOVE_FC1;
+              state <= FC_PIPE ? FC_HAND : MOVE_FC1;
+              conv2_tap_cnt <= 0;
               conv2_cha_cnt <= 0;
+              conv2_grp_cnt <= 0;
+              conv2_pw_phase <= 1'b0;
             end
           end
           else
@@ -279,12 +553,17 @@ module e203_subsys_nice_core (
 
         CAL_FC1: begin
           if (cal_fc1_done) begin
-            if (fc1_block_cnt < 3) begin
+            if (~fc1_in_tile_last) begin
+              state <= MOVE_FC1;
+              fc1_in_tile_cnt <= fc1_in_tile_cnt + 1;
+            end else if (~fc1_out_tile_last) begin
               state <= MOVE_FC1;
-              fc1_block_cnt <= fc1_block_cnt + 1;
+              fc1_in_tile_cnt <= 0;
+              fc1_out_tile_cnt <= fc1_out_tile_cnt + 1;
             end else begin
               state <= MOVE_FC2;
-              fc1_block_cnt <= 0;
+              fc1_in_tile_cnt <= 0;
+              fc1_out_tile_cnt <= 0;
             end
           end
           else
@@ -304,7 +583,7 @@ module e203_subsys_nice_core (
               state <= MOVE_FC2;
               fc2_block_cnt <= fc2_block_cnt + 1;
             end else begin
-              state <= IDLE;
+              state <= SOFTMAX;
               fc2_block_cnt <= 0;
             end
           end
@@ -312,50 +591,530 @@ module e203_subsys_nice_core (
             state <= CAL_FC2;
         end
 
+        EXEC_ALU: begin
+          if (exec_alu_done)
+            state <= IDLE;
+          else
+            state <= EXEC_ALU;
+        end
+
+        SOFTMAX: begin
+          if (softmax_done)
+            state <= out_wb_r ? OUT_WB : IDLE;
+          else
+            state <= SOFTMAX;
+        end
+
+        // the handoff waits for the engine to drop the previous image,
+        // the next image may then overwrite the conv buffers
+        FC_HAND: begin
+          if (fc_idle)
+            state <= out_wb_r ? FC_WAIT : IDLE;
+          else
+            state <= FC_HAND;
+        end
+
+        FC_WAIT: begin
+          if (fc_idle)
+            state <= SOFTMAX;
+          else
+            state <= FC_WAIT;
+        end
+
+        OUT_WB: begin
+          if (out_wb_done)
+            state <= IDLE;
+          else
+            state <= OUT_WB;
+        end
+
+        PREEMPT: begin
+          if (nice_rsp_hsked)
+            state <= IDLE;
+          else
+            state <= PREEMPT;
+        end
+
         default:
           state <= IDLE;
       endcase
+
+      // a new image, swap or datapath cfg drops the parked one
+      if (nice_req_hsked && (custom_input_op || custom_run_op || park_drop) && (resume_state != IDLE)) begin
+        resume_state <= IDLE;
+        conv1_grp_cnt <= 0;
+        conv1_tap_cnt <= 0;
+        conv2_grp_cnt <= 0;
+        conv2_cha_cnt <= 0;
+        conv2_tap_cnt <= 0;
+        conv2_pw_phase <= 1'b0;
+        fc1_in_tile_cnt <= 0;
+        fc1_out_tile_cnt <= 0;
+        fc2_block_cnt <= 0;
+      end
+
+      if (preempt_take) begin
+        state <= PREEMPT;
+        resume_state <= state;
+      end
+    end
+  end
+
+  always @(posedge nice_clk or negedge nice_rst_n) begin
+    if (!nice_rst_n)
+      preempt_ok <= 1'b0;
+    else if (nice_req_hsked & (custom_input_op | custom_run_op | custom3_resume))
+      preempt_ok <= 1'b0;
+    else if (cal_conv1_done | cal_conv2_done | cal_fc1_done | cal_fc2_done | load_input_done)
+      preempt_ok <= 1'b1;
+  end
+
+
+  wire wl_done = load_conv1_done | load_conv2_done | load_fc1_done | load_fc2_done |
+                 load_act_done   | load_qp_done;
+
+  // weight loader FSM, runs beside the main FSM so that the inactive bank
+  // can be refilled while an image is computed on the active one
+  always @(posedge nice_clk or negedge nice_rst_n)
+  begin
+    if (!nice_rst_n) begin
+      wl_state <= IDLE;
+    end else begin
+      case (wl_state)
+        IDLE: begin
+          if (nice_req_hsked && custom_wl_op) begin
+            if (custom3_load_conv1)
+              wl_state <= LOAD_CONV1;
+            else if (custom3_load_conv2)
+              wl_state <= LOAD_CONV2;
+            else if (custom3_load_fc1)
+              wl_state <= LOAD_FC1;
+            else if (custom3_load_act)
+              wl_state <= LOAD_ACT;
+            else if (custom3_load_qp)
+              wl_state <= LOAD_QP;
+            else
+              wl_state <= LOAD_FC2;
+          end
+          else if (conv2_xf_stale && nice_req_valid && custom3_swap) begin
+            wl_state <= WINO_XF;  // the swap waits for it
+          end
+          else begin
+            wl_state <= IDLE;
+          end
+        end
+
+        LOAD_CONV1: begin
+          if (load_conv1_done)
+            wl_state <= IDLE;
+          else
+            wl_state <= LOAD_CONV1;
+        end
+
+        LOAD_CONV2: begin
+          if (load_conv2_done)
+            wl_state <= CONV2_WINO ? WINO_XF : IDLE;
+          else
+            wl_state <= LOAD_CONV2;
+        end
+
+        LOAD_FC1: begin
+          if (load_fc1_done)
+            wl_state <= IDLE;
+          else
+            wl_state <= LOAD_FC1;
+        end
+
+        LOAD_FC2: begin
+          if (load_fc2_done)
+            wl_state <= IDLE;
+          else
+            wl_state <= LOAD_FC2;
+        end
+
+        LOAD_ACT: begin
+          if (load_act_done)
+            wl_state <= IDLE;
+          else
+            wl_state <= LOAD_ACT;
+        end
+
+        LOAD_QP: begin
+          if (load_qp_done)
+            wl_state <= IDLE;
+          else
+            wl_state <= LOAD_QP;
+        end
+
+        WINO_XF: begin
+          if (conv2_xf_done)
+            wl_state <= IDLE;
+          else
+            wl_state <= WINO_XF;
+        end
+
+        default:
+          wl_state <= IDLE;
+      endcase
+    end
+  end
+
+  // deferred loader response and its bus error
+  wire wl_rsp_valid = wl_rsp_pend & state_is_idle & ~main_rsp_pend;
+  reg  wl_rsp_err;
+
+  always @(posedge nice_clk or negedge nice_rst_n) begin
+    if (!nice_rst_n) begin
+      wl_rsp_pend <= 1'b0;
+      wl_rsp_err  <= 1'b0;
+    end
+    else begin
+      if (wl_done)
+        wl_rsp_pend <= 1'b1;
+      else if (wl_rsp_valid & nice_rsp_hsked)
+        wl_rsp_pend <= 1'b0;
+
+      if (nice_req_hsked & custom_wl_op)
+        wl_rsp_err  <= 1'b0;
+      else if (~wl_state_is_idle & nice_icb_rsp_hsked & nice_icb_rsp_err)
+        wl_rsp_err  <= 1'b1;
     end
   end
 
+  always @(posedge nice_clk or negedge nice_rst_n) begin
+    if (!nice_rst_n)
+      wbank_act <= 1'b0;
+    else if (nice_req_hsked & custom3_swap)
+      wbank_act <= ~wbank_act;
+  end
+
 
   typedef logic        [7:0]  uint8_t;
   typedef logic signed [7:0]  int8_t;
   typedef logic signed [31:0] int32_t;
   typedef logic signed [8:0]  int9_t;
+  typedef logic signed [15:0] int16_t;
+
+  // quant params of the model: zero points, biases and the requant shift-adds.
+  // they are banked with the weights (custom3_load_qp into the inactive bank,
+  // 4c below), so a swap flips them together with the model they belong to.
+  // both banks reset to the shipped model, the blob is QP_WORDS int32:
+  //   0   {conv2_weight_zp, conv1_out_zp, conv1_weight_zp, input_zp}
+  //   1   {fc2_weight_zp, fc1_out_zp, fc1_weight_zp, conv2_out_zp}
+  //   2-4 requant of conv1, conv2, fc1, rq_t
+  //   5.. conv1_bias[CONV1_NUM], conv2_bias[CONV2_NUM], fc1_bias[10], fc2_bias[10]
+  // python/qparams.py packs it. the skip, depthwise and frame scales below
+  // stay elaboration constants shared by both banks
+  localparam QP_ZP0         = 0;
+  localparam QP_ZP1         = 1;
+  localparam QP_RQ_CONV1    = 2;
+  localparam QP_RQ_CONV2    = 3;
+  localparam QP_RQ_FC1      = 4;
+  localparam QP_CONV1_BIAS  = 5;
+  localparam QP_CONV2_BIAS  = QP_CONV1_BIAS + CONV1_NUM;
+  localparam QP_FC1_BIAS    = QP_CONV2_BIAS + CONV2_NUM;
+  localparam QP_FC2_BIAS    = QP_FC1_BIAS   + 10;
+  localparam QP_WORDS       = QP_FC2_BIAS   + 10;                // 35
+
+  // requant by up to three shifted terms and a final shift:
+  //   (s0 * (acc >>> a0) + s1 * (acc >>> a1) + s2 * (acc >>> a2)) >>> post
+  // a sign field is 2'b00 off, 2'b01 add, 2'b11 subtract
+  typedef struct packed {
+    logic [5:0] rsvd;
+    logic [1:0] s2;
+    logic [4:0] a2;
+    logic [1:0] s1;
+    logic [4:0] a1;
+    logic [1:0] s0;
+    logic [4:0] a0;
+    logic [4:0] post;
+  } rq_t;
+
+  // conv1: scale = 1/510 ≈ (1 + 1/256) / 512, (acc + acc/256) >> 9
+  localparam rq_t RQ_CONV1 = '{s0: 2'b01, a0: 5'd0, s1: 2'b01, a1: 5'd8,  s2: 2'b00, a2: 5'd0,  post: 5'd9, default: '0};
+  // conv2: scale = 1/216 ≈ 1/256 + 1/1024 - 1/4096
+  localparam rq_t RQ_CONV2 = '{s0: 2'b01, a0: 5'd8, s1: 2'b01, a1: 5'd10, s2: 2'b11, a2: 5'd12, post: 5'd0, default: '0};
+  // fc1:   scale = 1/206 ≈ 1/256 + 1/1024
+  localparam rq_t RQ_FC1   = '{s0: 2'b01, a0: 5'd8, s1: 2'b01, a1: 5'd10, s2: 2'b00, a2: 5'd0,  post: 5'd0, default: '0};
+
+  localparam int32_t FC1_BIAS_DEF[10] = '{-318, -434, 1721, -288, -879, 872, -658, -665, 2352, -2272};
+  localparam int32_t FC2_BIAS_DEF[10] = '{-5, 88, -71, -14, -2, -32, 22, 28, -64, 19};
+
+  // word i of the shipped blob, the reset value of both banks
+  function automatic int32_t qp_default(input int i);
+    if (i == QP_ZP0)
+      return {8'd31, 8'd159, 8'd2, 8'd127};
+    else if (i == QP_ZP1)
+      return {8'd11, 8'd107, 8'd7, 8'd118};
+    else if (i == QP_RQ_CONV1)
+      return RQ_CONV1;
+    else if (i == QP_RQ_CONV2)
+      return RQ_CONV2;
+    else if (i == QP_RQ_FC1)
+      return RQ_FC1;
+    else if (i < QP_CONV2_BIAS)
+      return CONV1_BIAS[i - QP_CONV1_BIAS];
+    else if (i < QP_FC1_BIAS)
+      return CONV2_BIAS[i - QP_CONV2_BIAS];
+    else if (i < QP_FC2_BIAS)
+      return FC1_BIAS_DEF[i - QP_FC1_BIAS];
+    else
+      return FC2_BIAS_DEF[i - QP_FC2_BIAS];
+  endfunction
+
+  int32_t qp_bank [2][QP_WORDS];
+
+  // views of the active bank, named as the constants they replace
+  uint8_t input_zp;
+  uint8_t conv1_weight_zp;
+  uint8_t conv1_out_zp;
+  uint8_t conv2_weight_zp;
+  uint8_t conv2_out_zp;
+  uint8_t fc1_weight_zp;
+  uint8_t fc1_out_zp;
+  uint8_t fc2_weight_zp;
+  rq_t    rq_conv1;
+  rq_t    rq_conv2;
+  rq_t    rq_fc1;
+  int32_t conv1_bias [CONV1_NUM];
+  int32_t conv2_bias [CONV2_NUM];
+  int32_t fc1_bias   [10];
+  int32_t fc2_bias   [10];
+
+  assign {conv2_weight_zp, conv1_out_zp, conv1_weight_zp, input_zp} = qp_bank[wbank_act][QP_ZP0];
+  assign {fc2_weight_zp, fc1_out_zp, fc1_weight_zp, conv2_out_zp}   = qp_bank[wbank_act][QP_ZP1];
+  assign rq_conv1 = qp_bank[wbank_act][QP_RQ_CONV1];
+  assign rq_conv2 = qp_bank[wbank_act][QP_RQ_CONV2];
+  assign rq_fc1   = qp_bank[wbank_act][QP_RQ_FC1];
+
+  generate
+    for (genvar i = 0; i < CONV1_NUM; i++) begin
+      assign conv1_bias[i] = qp_bank[wbank_act][QP_CONV1_BIAS + i];
+    end
+    for (genvar i = 0; i < CONV2_NUM; i++) begin
+      assign conv2_bias[i] = qp_bank[wbank_act][QP_CONV2_BIAS + i];
+    end
+    for (genvar i = 0; i < 10; i++) begin
+      assign fc1_bias[i] = qp_bank[wbank_act][QP_FC1_BIAS + i];
+      assign fc2_bias[i] = qp_bank[wbank_act][QP_FC2_BIAS + i];
+    end
+  endgenerate
+
+  // depthwise half of a CONV2_DW block, its output feeds the pointwise conv
+  // that uses conv2_bias / conv2_out_zp above
+  localparam int32_t conv2_dw_bias[CONV1_NUM] = CONV2_DW_BIAS;
+  localparam uint8_t conv2_dw_weight_zp = CONV2_DW_WZP;
+  localparam uint8_t conv2_dw_out_zp = CONV2_DW_ZP;
+
+  // output requant by shift-add, shared by the layer pipeline and custom3_requant
+  function automatic int32_t rq_term(input int32_t acc, input logic [1:0] s, input logic [4:0] a);
+    return (s == 2'b01) ? (acc >>> a) : (s == 2'b11) ? -(acc >>> a) : 0;
+  endfunction
+
+  function automatic int32_t requant(input int32_t acc, input rq_t rq);
+    return (rq_term(acc, rq.s0, rq.a0) + rq_term(acc, rq.s1, rq.a1) + rq_term(acc, rq.s2, rq.a2)) >>> rq.post;
+  endfunction
+
+  // CONV1_A16: the int16 input steps 256 times finer than the uint8 one,
+  //        an image given as (x - input_zp) << 8 gives the uint8 result
+  function automatic int32_t requant_a16(input int32_t acc, input rq_t rq);
+    return requant(acc >>> 8, rq);
+  endfunction
+
+  // CONV2_SKIP: x from the conv1 output scale to the conv2 output scale,
+  //        0.0361 / 0.0687 ≈ 67/128, python/cal_quant.py skip_scale()
+  function automatic int32_t requant_skip(input int32_t q);
+    return ((q <<< 6) + (q <<< 1) + q) >>> 7;
+  endfunction
+
+  // FRAME_DS: quant_MNIST.py takes a pixel x to round((x / 127.5 - 1) / SCALE)
+  //        + ZERO_POINT, with SCALE = 1/127.5 and ZERO_POINT = 127 that is
+  //        x - 0.5 rounded, taken as floor of the box mean. ties go down where
+  //        torch rounds half to even, at most one code off (python/frame_prep.py).
+  //        the mean is sum * ceil(2**20 / FRAME_DS**2) >> 20, exact up to FRAME_DS = 8
+  localparam FRAME_N    = (FRAME_DS != 0) ? FRAME_DS * FRAME_DS : 1;
+  localparam FRAME_QMUL = ((1 << 20) + FRAME_N - 1) / FRAME_N;
+
+  function automatic uint8_t quant_frame(input int32_t sum);
+    return clamp_u8((sum * FRAME_QMUL) >>> 20, 8'd0, 1'b0);
+  endfunction
+
+  // conv2 depthwise: scale = 1/CONV2_DW_SCALE, a model parameter rather than
+  //        a fixed shift-add, as (acc * round(2**24 / CONV2_DW_SCALE)) >> 24
+  localparam longint CONV2_DW_QMUL = (CONV2_DW_SCALE > 0) ?
+                                     (((64'sd1 << 24) + CONV2_DW_SCALE / 2) / CONV2_DW_SCALE) : 0;
+
+  if (CONV2_DW && (CONV2_DW_SCALE <= 0)) begin : CONV2_DW_CHECK
+    $error("CONV2_DW needs CONV2_DW_SCALE / _BIAS / _WZP / _ZP of the model, python/cal_quant.py dw_scale()");
+  end
+
+  function automatic int32_t requant_conv2_dw(input int32_t acc);
+    return int32_t'((longint'(acc) * CONV2_DW_QMUL) >>> 24);
+  endfunction
+
+  // add zero_point and clamp to uint8, relu clamps at zero_point instead of 0
+  function automatic uint8_t clamp_u8(input int32_t acc, input uint8_t zp, input logic relu);
+    int32_t res;
+    res = acc + int32_t'(zp);
+    if (relu && (res < int32_t'(zp)))
+      return zp;
+    else if (res < 0)
+      return 8'd0;
+    else if (res > 255)
+      return 8'd255;
+    else
+      return uint8_t'(res);
+  endfunction
+
+
+  // layer geometry, a conv reads its input through the optional pool
+  localparam INPUT_WIDTH        = 28;
+  localparam CONV1_RC           = CONV1_WIDTH * CONV1_WIDTH;              // 9
+  localparam CONV1_PF           = CONV1_POOL ? POOL_STRIDE : 1;           // pool stride
+  localparam CONV1_PK           = CONV1_POOL ? POOL_K : 1;                // pool window
+  localparam POOL1_OUTPUT_WIDTH = (INPUT_WIDTH - CONV1_PK) / CONV1_PF + 1;  // 14
+  localparam CONV1_OUTPUT_WIDTH = (POOL1_OUTPUT_WIDTH + 2*CONV1_PAD - CONV1_WIDTH) / CONV1_STRIDE + 1;  // 12
+  localparam CONV1_OUTPUT_SIZE  = CONV1_OUTPUT_WIDTH * CONV1_OUTPUT_WIDTH;  // 144
+
+  localparam CONV2_CHA          = CONV1_NUM;
+  localparam CONV2_RC           = CONV2_WIDTH * CONV2_WIDTH;              // 9
+  localparam CONV2_PF           = CONV2_POOL ? POOL_STRIDE : 1;
+  localparam CONV2_PK           = CONV2_POOL ? POOL_K : 1;
+  localparam POOL2_OUTPUT_WIDTH = (CONV1_OUTPUT_WIDTH - CONV2_PK) / CONV2_PF + 1;  // 6
+  localparam CONV2_OUTPUT_WIDTH = (POOL2_OUTPUT_WIDTH + 2*CONV2_PAD - CONV2_WIDTH) / CONV2_STRIDE + 1;  // 4
+  localparam CONV2_OUTPUT_SIZE  = CONV2_OUTPUT_WIDTH * CONV2_OUTPUT_WIDTH;  // 16
 
-  localparam uint8_t input_zp = 127;
+  // CONV2_WINO streams 2x2 output tiles through the array instead of pixels
+  localparam CONV2_WINO_TW      = CONV2_WINO ? (CONV2_OUTPUT_WIDTH / 2) : 1;  // 2
+  localparam CONV2_WINO_TILES   = CONV2_WINO_TW * CONV2_WINO_TW;            // 4
+  localparam CONV2_LANE_WIDTH   = CONV2_WINO ? CONV2_WINO_TW : CONV2_OUTPUT_WIDTH;
+  localparam CONV2_STREAM       = CONV2_LANE_WIDTH * CONV2_LANE_WIDTH;      // pixels or tiles per pass
+
+  // fc1 pools the conv2 output, global average pooling is one window over the map
+  localparam POOL3_K            = FC1_GAP ? CONV2_OUTPUT_WIDTH : POOL_K;
+  localparam POOL3_S            = FC1_GAP ? 1 : POOL_STRIDE;
+  localparam POOL3_AVG          = FC1_GAP | POOL_AVG;
+  localparam POOL3_OUTPUT_WIDTH = (CONV2_OUTPUT_WIDTH - POOL3_K) / POOL3_S + 1;  // 2
+  localparam POOL3_OUTPUT_SIZE  = POOL3_OUTPUT_WIDTH * POOL3_OUTPUT_WIDTH;  // 4
+
+  if (((POOL_K != 2) && (POOL_K != 3)) || (POOL_STRIDE < 1) || (POOL_STRIDE > POOL_K) ||
+      (CONV2_OUTPUT_WIDTH < POOL3_K)) begin : POOL_CHECK
+    $error("POOL_K must be 2 or 3 with 1 <= POOL_STRIDE <= POOL_K, and conv2 must cover one fc1 pool window");
+  end
+
+  // max or rounded average of the first k * k bytes of a pool window,
+  // a k = 1 window passes its pixel through
+  localparam POOL_WIN = 9;  // up to 3x3
+
+  function automatic uint8_t pool_u8(input uint8_t win[POOL_WIN], input int k, input logic avg);
+    int     sum;
+    uint8_t mx;
+    sum = 0;
+    mx  = '0;
+    for (int j = 0; j < POOL_WIN; j++) begin
+      if (j < k * k) begin
+        sum = sum + int'(win[j]);
+        mx  = (win[j] > mx) ? win[j] : mx;
+      end
+    end
+    return avg ? uint8_t'((sum + k * k / 2) / (k * k)) : mx;
+  endfunction
+
+  // pool_u8 for the CONV1_A16 input, the average rounds half away from zero
+  function automatic int16_t pool_i16(input int16_t win[POOL_WIN], input int k, input logic avg);
+    int     sum;
+    int16_t mx;
+    sum = 0;
+    mx  = 16'sh8000;
+    for (int j = 0; j < POOL_WIN; j++) begin
+      if (j < k * k) begin
+        sum = sum + int'(win[j]);
+        mx  = (win[j] > mx) ? win[j] : mx;
+      end
+    end
+    if (!avg)
+      return mx;
+    else if (sum < 0)
+      return int16_t'((sum - k * k / 2) / (k * k));
+    else
+      return int16_t'((sum + k * k / 2) / (k * k));
+  endfunction
 
-  localparam uint8_t conv1_weight_zp = 2;
-  localparam int32_t conv1_bias[5] = '{871, -16316, -9617, -21527, -7265};
-  localparam uint8_t conv1_out_zp = 159;
+  if (CONV2_WINO && ((CONV2_WIDTH != 3) || (CONV2_STRIDE != 1) || (CONV2_PAD != 0) ||
+                     CONV2_DW || (CONV2_OUTPUT_WIDTH % 2))) begin : CONV2_WINO_CHECK
+    $error("CONV2_WINO needs a dense 3x3 stride-1 conv2 without padding and an even output width");
+  end
 
-  localparam uint8_t conv2_weight_zp = 31;
-  localparam int32_t conv2_bias[5] = '{-215, 2005, -2292, 4127, 441};
-  localparam uint8_t conv2_out_zp = 118;
+  if ((CONV2_SKIP > 2) || (CONV2_SKIP && (POOL2_OUTPUT_WIDTH != CONV2_OUTPUT_WIDTH)) ||
+      ((CONV2_SKIP == 1) && (CONV2_NUM != CONV2_CHA))) begin : CONV2_SKIP_CHECK
+    $error("CONV2_SKIP needs a conv2 that keeps the map size, the residual add also CONV2_NUM = CONV1_NUM");
+  end
 
-  localparam uint8_t fc1_weight_zp = 7;
-  localparam int32_t fc1_bias[10] = '{-318, -434, 1721, -288, -879, 872, -658, -665, 2352, -2272};
-  localparam uint8_t fc1_out_zp = 107;
+  // fc1 input channels, the conv2 output and with a concat skip also x
+  localparam FC1_IN_CHA         = CONV2_NUM + ((CONV2_SKIP == 2) ? CONV2_CHA : 0);
 
-  localparam uint8_t fc2_weight_zp = 11;
-  localparam int32_t fc2_bias[10] = '{-5, 88, -71, -14, -2, -32, 22, 28, -64, 19};
+  // Winograd F(2x2,3x3) with G scaled by 2 so the transforms stay integer:
+  // U = G g G^T is 4x the textbook one, A^T (sum U.V) A is then 4x the direct
+  // sum and >>> 2 gives it back exactly, see python/winograd.py
+  localparam int WINO_G  [4][3] = '{'{2, 0, 0}, '{1, 1, 1}, '{1, -1, 1}, '{0, 0, 2}};
+  localparam int WINO_BT [4][4] = '{'{1, 0, -1, 0}, '{0, 1, 1, 0}, '{0, -1, 1, 0}, '{0, 1, 0, -1}};
+  localparam int WINO_AT [2][4] = '{'{1, 1, 1, 0}, '{0, 1, -1, -1}};
+  // G 1 G^T, the zero point term of U at each transform position
+  localparam int WINO_GZ [16]   = '{4, 6, 2, 4, 6, 9, 3, 6, 2, 3, 1, 2, 4, 6, 2, 4};
 
 
   ////////////////////////////////////////////////////////////
   // instr EXU
   ////////////////////////////////////////////////////////////
+  //////////// 0. compressed weight loads
+  // with CFG_WL_ZIP set a custom3_load_* reads a sparse bitmap blob (see
+  // weight_dec.sv, python/weight_codec.py) instead of the raw array, the
+  // load ends after the header beat and the payload beats of the blob
+  localparam CFG_WL_ZIP = 2;  // rs1[0]: 0 = raw, 1 = sparse bitmap
+
+  logic wl_zip;
+
+  always @(posedge nice_clk or negedge nice_rst_n) begin
+    if (!nice_rst_n)
+      wl_zip <= 1'b0;
+    else if (nice_req_hsked & custom3_cfg & (nice_req_rs2 == CFG_WL_ZIP))
+      wl_zip <= nice_req_rs1[0];
+  end
+
+  logic        wl_dec_hdr;
+  logic [7:0]  wl_dec_fill;
+  int          wl_dec_beats;
+  logic        wl_dec_wr  [4];
+  logic [15:0] wl_dec_idx [4];
+  logic [7:0]  wl_dec_val [4];
+
+  // one decoder, the loader runs one load at a time
+  weight_dec #(
+    .AW     (16)
+  ) u_weight_dec (
+    .clk    (nice_clk),
+    .rst_n  (nice_rst_n),
+    .clear  (wl_done),
+    .beat   (wl_zip & ~wl_state_is_idle & nice_icb_rsp_hsked),
+    .rdata  (nice_icb_rsp_rdata),
+    .hdr    (wl_dec_hdr),
+    .fill   (wl_dec_fill),
+    .beats  (wl_dec_beats),
+    .wr     (wl_dec_wr),
+    .wr_idx (wl_dec_idx),
+    .wr_val (wl_dec_val)
+  );
+
+
   //////////// 1. custom3_load_conv1
 
-  localparam CONV1_NUM        = 5;
-  localparam CONV1_WIDTH      = 3;
-  localparam CONV1_RC         = CONV1_WIDTH * CONV1_WIDTH; // 9
   localparam CONV1_SIZE       = CONV1_NUM * CONV1_RC;      // 45
-  localparam CONV1_CNT_CYCLES = 12; // CONV1_SIZE/4
+  localparam CONV1_CNT_CYCLES = (CONV1_SIZE + 3) / 4;      // 12
 
   integer load_conv1_cnt;
+  wire [31:0] load_conv1_lim  = wl_zip ? wl_dec_beats : CONV1_CNT_CYCLES;
 
-  wire load_conv1_cnt_done    = (load_conv1_cnt == CONV1_CNT_CYCLES);
+  wire load_conv1_cnt_done    = (load_conv1_cnt == load_conv1_lim);
   wire load_conv1_icb_rsp_hs  = state_is_load_conv1   & nice_icb_rsp_hsked;
   wire load_conv1_cnt_incr    = load_conv1_icb_rsp_hs & ~load_conv1_cnt_done;
   assign load_conv1_done      = load_conv1_icb_rsp_hs & load_conv1_cnt_done;
@@ -374,11 +1133,11 @@ module e203_subsys_nice_core (
   end
 
   // valid signals
-  wire nice_rsp_valid_load_conv1     = state_is_load_conv1 & load_conv1_cnt_done & nice_icb_rsp_valid;
-  wire nice_icb_cmd_valid_load_conv1 = state_is_load_conv1 & (load_conv1_cnt < CONV1_CNT_CYCLES);
+  wire nice_icb_cmd_valid_load_conv1 = state_is_load_conv1 & (load_conv1_cnt < load_conv1_lim);
 
   // conv1_weight
-  int8_t conv1_weight_flat [CONV1_SIZE];
+  int8_t conv1_weight_bank [2][CONV1_SIZE];
+  int8_t conv1_weight_flat [CONV1_SIZE];  // active bank
   int8_t conv1_weight [CONV1_NUM][CONV1_RC];
 
   // Constant connection, no resource consumption
@@ -390,35 +1149,59 @@ module e203_subsys_nice_core (
     end
   endgenerate
 
+  generate
+    for (genvar i = 0; i < CONV1_SIZE; i++) begin
+      assign conv1_weight_flat[i] = conv1_weight_bank[wbank_act][i];
+    end
+  endgenerate
+
   logic [$clog2(CONV1_SIZE):0] conv1_wptr;
 
   // conv1 buffer data storage
   always @(posedge nice_clk or negedge nice_rst_n) begin
     if (!nice_rst_n) begin
-      conv1_weight_flat <= '{default: '0};
+      conv1_weight_bank <= '{default: '0};
       conv1_wptr <= 0;
     end 
+    else if (load_conv1_cnt_incr && wl_zip) begin
+      if (wl_dec_hdr)
+        conv1_weight_bank[~wbank_act] <= '{default: int8_t'(wl_dec_fill)};
+      for (int b = 0; b < 4; b++) begin
+        if (wl_dec_wr[b] && (wl_dec_idx[b] < CONV1_SIZE))
+          conv1_weight_bank[~wbank_act][wl_dec_idx[b]] <= int8_t'(wl_dec_val[b]);
+      end
+    end
     else if (load_conv1_cnt_incr && (conv1_wptr < CONV1_SIZE)) begin
       for (int b = 0; b < 4; b++) begin
         if ((conv1_wptr + b) < CONV1_SIZE)
-          conv1_weight_flat[conv1_wptr + b] <= int8_t'(nice_icb_rsp_rdata[8*b +: 8]);
+          conv1_weight_bank[~wbank_act][conv1_wptr + b] <= int8_t'(nice_icb_rsp_rdata[8*b +: 8]);
       end
       conv1_wptr <= conv1_wptr + 4;
     end
+    else if (load_conv1_done) begin
+      conv1_wptr <= 0;
+    end
+    else if (sp_wr_conv1) begin
+      for (int b = 0; b < 4; b++) begin
+        if (nice_sp_icb_cmd_wmask[b] && ((sp_wr_idx + b) < CONV1_SIZE))
+          conv1_weight_bank[~wbank_act][sp_wr_idx + b] <= int8_t'(nice_sp_icb_cmd_wdata[8*b +: 8]);
+      end
+    end
   end
 
 
 //////////// 2. custom3_load_conv2
-  localparam CONV2_NUM        = 5;
-  localparam CONV2_CHA        = 5;
-  localparam CONV2_WIDTH      = 3;
-  localparam CONV2_RC         = CONV2_WIDTH * CONV2_WIDTH;        // 9
-  localparam CONV2_SIZE       = CONV2_NUM * CONV2_RC * CONV2_CHA; // 45
-  localparam CONV2_CNT_CYCLES = 57;
+  // dense [n][c][tap], or CONV2_DW: depthwise [c][tap] then pointwise [n][c]
+  localparam CONV2_DW_SIZE    = CONV2_CHA * CONV2_RC;
+  localparam CONV2_SIZE       = CONV2_DW ? (CONV2_DW_SIZE + CONV2_NUM * CONV2_CHA) :
+                                CONV2_W4 ? ((CONV2_NUM * CONV2_RC * CONV2_CHA + 1) / 2) :
+                                           (CONV2_NUM * CONV2_RC * CONV2_CHA);     // 225
+  localparam CONV2_CNT_CYCLES = (CONV2_SIZE + 3) / 4;             // 57
 
   integer load_conv2_cnt;
+  wire [31:0] load_conv2_lim  = wl_zip ? wl_dec_beats : CONV2_CNT_CYCLES;
 
-  wire load_conv2_cnt_done    = (load_conv2_cnt == CONV2_CNT_CYCLES);
+  wire load_conv2_cnt_done    = (load_conv2_cnt == load_conv2_lim);
   wire load_conv2_icb_rsp_hs  = state_is_load_conv2   & nice_icb_rsp_hsked;
   wire load_conv2_cnt_incr    = load_conv2_icb_rsp_hs & ~load_conv2_cnt_done;
   assign load_conv2_done      = load_conv2_icb_rsp_hs & load_conv2_cnt_done;
@@ -437,50 +1220,129 @@ module e203_subsys_nice_core (
   end
 
   // valid signals
-  wire nice_rsp_valid_load_conv2     = state_is_load_conv2 & load_conv2_cnt_done & nice_icb_rsp_valid;
-  wire nice_icb_cmd_valid_load_conv2 = state_is_load_conv2 & (load_conv2_cnt < CONV2_CNT_CYCLES);
+  wire nice_icb_cmd_valid_load_conv2 = state_is_load_conv2 & (load_conv2_cnt < load_conv2_lim);
 
   // conv2_weight
-  int8_t conv2_weight_flat [CONV2_SIZE];
+  int8_t conv2_weight_bank [2][CONV2_SIZE];
+  int8_t conv2_weight_flat [CONV2_SIZE];  // active bank
   int8_t conv2_weight [CONV2_NUM][CONV2_CHA][CONV2_RC];
 
   generate
-    for (genvar n = 0; n < CONV2_NUM; n++) begin
-      for (genvar c = 0; c < CONV2_CHA; c++) begin
-        for (genvar r = 0; r < CONV2_RC; r++) begin
-          assign conv2_weight[n][c][r] = conv2_weight_flat[n * (CONV2_CHA*CONV2_RC) + c * CONV2_RC + r];
+    if (!CONV2_DW) begin : CONV2_DENSE_VIEW
+      for (genvar n = 0; n < CONV2_NUM; n++) begin
+        for (genvar c = 0; c < CONV2_CHA; c++) begin
+          for (genvar r = 0; r < CONV2_RC; r++) begin
+            localparam int k = n * (CONV2_CHA*CONV2_RC) + c * CONV2_RC + r;
+            if (CONV2_W4)  // weight k in nibble k % 2 of byte k / 2
+              assign conv2_weight[n][c][r] = int8_t'($signed(conv2_weight_flat[k/2][4*(k%2) +: 4]));
+            else
+              assign conv2_weight[n][c][r] = conv2_weight_flat[k];
+          end
         end
       end
     end
   endgenerate
 
+  generate
+    for (genvar i = 0; i < CONV2_SIZE; i++) begin
+      assign conv2_weight_flat[i] = conv2_weight_bank[wbank_act][i];
+    end
+  endgenerate
+
   logic [$clog2(CONV2_SIZE):0] conv2_wptr;
 
   // conv2 buffer data storage
   always @(posedge nice_clk or negedge nice_rst_n) begin
     if (!nice_rst_n) begin
-      conv2_weight_flat <= '{default: '0};
+      conv2_weight_bank <= '{default: '0};
       conv2_wptr <= 0;
     end 
+    else if (load_conv2_cnt_incr && wl_zip) begin
+      if (wl_dec_hdr)
+        conv2_weight_bank[~wbank_act] <= '{default: int8_t'(wl_dec_fill)};
+      for (int b = 0; b < 4; b++) begin
+        if (wl_dec_wr[b] && (wl_dec_idx[b] < CONV2_SIZE))
+          conv2_weight_bank[~wbank_act][wl_dec_idx[b]] <= int8_t'(wl_dec_val[b]);
+      end
+    end
     else if (load_conv2_cnt_incr && (conv2_wptr < CONV2_SIZE)) begin
       for (int b = 0; b < 4; b++) begin
         if ((conv2_wptr + b) < CONV2_SIZE)
-          conv2_weight_flat[conv2_wptr + b] <= int8_t'(nice_icb_rsp_rdata[8*b +: 8]);
+          conv2_weight_bank[~wbank_act][conv2_wptr + b] <= int8_t'(nice_icb_rsp_rdata[8*b +: 8]);
       end
       conv2_wptr <= conv2_wptr + 4;
     end
+    else if (load_conv2_done) begin
+      conv2_wptr <= 0;
+    end
+    else if (sp_wr_conv2) begin
+      for (int b = 0; b < 4; b++) begin
+        if (nice_sp_icb_cmd_wmask[b] && ((sp_wr_idx + b) < CONV2_SIZE))
+          conv2_weight_bank[~wbank_act][sp_wr_idx + b] <= int8_t'(nice_sp_icb_cmd_wdata[8*b +: 8]);
+      end
+    end
+  end
+
+  // CONV2_WINO keeps every (n, c) kernel transformed, U = G g G^T without
+  // the zero point (MOVE takes zp * G 1 G^T off, so the zero point may come
+  // with a later load_qp). the loader runs WINO_XF after load_conv2, one
+  // kernel per cycle into the inactive bank; scratchpad writes to conv2 mark
+  // it stale and the next swap runs WINO_XF before it flips the banks
+  localparam CONV2_XF_KERNELS = CONV2_WINO ? (CONV2_NUM * CONV2_CHA) : 1;  // 25
+
+  typedef logic signed [11:0] int12_t;  // |U| <= 9 * 128
+  int12_t conv2_wino_u_bank [2][CONV2_XF_KERNELS][16];
+
+  integer conv2_xf_cnt;
+  assign conv2_xf_done = state_is_wino_xf & (conv2_xf_cnt == CONV2_XF_KERNELS - 1);
+
+  always @(posedge nice_clk or negedge nice_rst_n) begin
+    if (!nice_rst_n)
+      conv2_xf_cnt <= 0;
+    else if (conv2_xf_done)
+      conv2_xf_cnt <= 0;
+    else if (state_is_wino_xf)
+      conv2_xf_cnt <= conv2_xf_cnt + 1;
+  end
+
+  always @(posedge nice_clk or negedge nice_rst_n) begin
+    if (!nice_rst_n)
+      conv2_xf_stale <= 1'b0;
+    else if (state_is_wino_xf)
+      conv2_xf_stale <= 1'b0;
+    else if (sp_wr_conv2 && CONV2_WINO)
+      conv2_xf_stale <= 1'b1;
+  end
+
+  // constant G, the kernel index is the only mux
+  always @(posedge nice_clk or negedge nice_rst_n) begin
+    if (!nice_rst_n)
+      conv2_wino_u_bank <= '{default: '0};
+    else if (state_is_wino_xf) begin
+      for (int p = 0; p < 16; p++) begin
+        int u;
+        u = 0;
+        for (int a = 0; a < 3; a++)
+          for (int b = 0; b < 3; b++)
+            u += WINO_G[p / 4][a] * WINO_G[p % 4][b] *
+                 conv2_weight_bank[~wbank_act][conv2_xf_cnt*CONV2_RC + a*3 + b];
+        conv2_wino_u_bank[~wbank_act][conv2_xf_cnt][p] <= int12_t'(u);
+      end
+    end
   end
 
 
   //////////// 3. custom3_load_fc1
   localparam FC1_OUT_WIDTH  = 10;
-  localparam FC1_IN_WIDTH   = 20;
-  localparam FC1_SIZE       = FC1_OUT_WIDTH * FC1_IN_WIDTH;  // 200
-  localparam FC1_CNT_CYCLES = 50;
+  localparam FC1_IN_WIDTH   = FC1_IN_CHA * POOL3_OUTPUT_SIZE; // 20
+  localparam FC1_SIZE       = FC1_W4 ? ((FC1_OUT_WIDTH * FC1_IN_WIDTH + 1) / 2) :
+                                       (FC1_OUT_WIDTH * FC1_IN_WIDTH);  // 200
+  localparam FC1_CNT_CYCLES = (FC1_SIZE + 3) / 4;            // 50
 
   integer load_fc1_cnt;
+  wire [31:0] load_fc1_lim  = wl_zip ? wl_dec_beats : FC1_CNT_CYCLES;
 
-  wire load_fc1_cnt_done    = (load_fc1_cnt == FC1_CNT_CYCLES);
+  wire load_fc1_cnt_done    = (load_fc1_cnt == load_fc1_lim);
   wire load_fc1_icb_rsp_hs  = state_is_load_fc1   & nice_icb_rsp_hsked;
   wire load_fc1_cnt_incr    = load_fc1_icb_rsp_hs & ~load_fc1_cnt_done;
   assign load_fc1_done      = load_fc1_icb_rsp_hs & load_fc1_cnt_done;
@@ -490,7 +1352,7 @@ module e203_subsys_nice_core (
     if (!nice_rst_n)
       load_fc1_cnt <= 0;
     else 
-    if (load_fc1_cnt_done)
+    if (load_fc1_done)
       load_fc1_cnt <= 0;
     else if (load_fc1_cnt_incr)
       load_fc1_cnt <= load_fc1_cnt + 1;
@@ -499,36 +1361,63 @@ module e203_subsys_nice_core (
   end
 
   // valid signals
-  wire nice_rsp_valid_load_fc1     = state_is_load_fc1 & load_fc1_cnt_done & nice_icb_rsp_valid;
-  wire nice_icb_cmd_valid_load_fc1 = state_is_load_fc1 & (load_fc1_cnt < FC1_CNT_CYCLES);
+  wire nice_icb_cmd_valid_load_fc1 = state_is_load_fc1 & (load_fc1_cnt < load_fc1_lim);
 
   // fc1_weight
-  int8_t fc1_weight_flat [FC1_SIZE];
+  int8_t fc1_weight_bank [2][FC1_SIZE];
+  int8_t fc1_weight_flat [FC1_SIZE];  // active bank
   int8_t fc1_weight [FC1_OUT_WIDTH][FC1_IN_WIDTH];
 
   generate
     for (genvar o = 0; o < FC1_OUT_WIDTH; o++) begin
       for (genvar i = 0; i < FC1_IN_WIDTH; i++) begin
-        assign fc1_weight[o][i] = fc1_weight_flat[o * FC1_IN_WIDTH + i];
+        localparam int k = o * FC1_IN_WIDTH + i;
+        if (FC1_W4)
+          assign fc1_weight[o][i] = int8_t'($signed(fc1_weight_flat[k/2][4*(k%2) +: 4]));
+        else
+          assign fc1_weight[o][i] = fc1_weight_flat[k];
       end
     end
   endgenerate
 
+  generate
+    for (genvar i = 0; i < FC1_SIZE; i++) begin
+      assign fc1_weight_flat[i] = fc1_weight_bank[wbank_act][i];
+    end
+  endgenerate
+
   logic [$clog2(FC1_SIZE):0] fc1_wptr;
 
   // fc1 buffer data storage
   always @(posedge nice_clk or negedge nice_rst_n) begin
     if (!nice_rst_n) begin
-      fc1_weight_flat <= '{default: '0};
+      fc1_weight_bank <= '{default: '0};
       fc1_wptr <= 0;
     end 
+    else if (load_fc1_cnt_incr && wl_zip) begin
+      if (wl_dec_hdr)
+        fc1_weight_bank[~wbank_act] <= '{default: int8_t'(wl_dec_fill)};
+      for (int b = 0; b < 4; b++) begin
+        if (wl_dec_wr[b] && (wl_dec_idx[b] < FC1_SIZE))
+          fc1_weight_bank[~wbank_act][wl_dec_idx[b]] <= int8_t'(wl_dec_val[b]);
+      end
+    end
     else if (load_fc1_cnt_incr && (fc1_wptr < FC1_SIZE)) begin
       for (int b = 0; b < 4; b++) begin
         if ((fc1_wptr + b) < FC1_SIZE)
-          fc1_weight_flat[fc1_wptr + b] <= int8_t'(nice_icb_rsp_rdata[8*b +: 8]);
+          fc1_weight_bank[~wbank_act][fc1_wptr + b] <= int8_t'(nice_icb_rsp_rdata[8*b +: 8]);
       end
       fc1_wptr <= fc1_wptr + 4;
     end
+    else if (load_fc1_done) begin
+      fc1_wptr <= 0;
+    end
+    else if (sp_wr_fc1) begin
+      for (int b = 0; b < 4; b++) begin
+        if (nice_sp_icb_cmd_wmask[b] && ((sp_wr_idx + b) < FC1_SIZE))
+          fc1_weight_bank[~wbank_act][sp_wr_idx + b] <= int8_t'(nice_sp_icb_cmd_wdata[8*b +: 8]);
+      end
+    end
   end
 
 
@@ -536,11 +1425,12 @@ module e203_subsys_nice_core (
   localparam FC2_OUT_WIDTH  = 10;
   localparam FC2_IN_WIDTH   = 10;
   localparam FC2_SIZE       = FC2_OUT_WIDTH * FC2_IN_WIDTH;  // 100
-  localparam FC2_CNT_CYCLES = 25;
+  localparam FC2_CNT_CYCLES = (FC2_SIZE + 3) / 4;            // 25
 
   integer load_fc2_cnt;
+  wire [31:0] load_fc2_lim  = wl_zip ? wl_dec_beats : FC2_CNT_CYCLES;
 
-  wire load_fc2_cnt_done    = (load_fc2_cnt == FC2_CNT_CYCLES);
+  wire load_fc2_cnt_done    = (load_fc2_cnt == load_fc2_lim);
   wire load_fc2_icb_rsp_hs  = state_is_load_fc2   & nice_icb_rsp_hsked;
   wire load_fc2_cnt_incr    = load_fc2_icb_rsp_hs & ~load_fc2_cnt_done;
   assign load_fc2_done      = load_fc2_icb_rsp_hs & load_fc2_cnt_done;
@@ -550,7 +1440,7 @@ module e203_subsys_nice_core (
     if (!nice_rst_n)
       load_fc2_cnt <= 0;
     else 
-    if (load_fc2_cnt_done)
+    if (load_fc2_done)
       load_fc2_cnt <= 0;
     else if (load_fc2_cnt_incr)
       load_fc2_cnt <= load_fc2_cnt + 1;
@@ -559,12 +1449,12 @@ module e203_subsys_nice_core (
   end
 
   // valid signals
-  wire nice_rsp_valid_load_fc2     = state_is_load_fc2 & load_fc2_cnt_done & nice_icb_rsp_valid;
-  wire nice_icb_cmd_valid_load_fc2 = state_is_load_fc2 & (load_fc2_cnt < FC2_CNT_CYCLES);
+  wire nice_icb_cmd_valid_load_fc2 = state_is_load_fc2 & (load_fc2_cnt < load_fc2_lim);
 
 
   // fc2_weight
-  int8_t fc2_weight_flat [FC2_SIZE];
+  int8_t fc2_weight_bank [2][FC2_SIZE];
+  int8_t fc2_weight_flat [FC2_SIZE];  // active bank
   int8_t fc2_weight [FC2_OUT_WIDTH][FC2_IN_WIDTH];
 
   generate
@@ -575,65 +1465,336 @@ module e203_subsys_nice_core (
     end
   endgenerate
 
+  generate
+    for (genvar i = 0; i < FC2_SIZE; i++) begin
+      assign fc2_weight_flat[i] = fc2_weight_bank[wbank_act][i];
+    end
+  endgenerate
+
   logic [$clog2(FC2_SIZE):0] fc2_wptr;
 
   // fc2 buffer data storage
   always @(posedge nice_clk or negedge nice_rst_n) begin
     if (!nice_rst_n) begin
-      fc2_weight_flat <= '{default: '0};
+      fc2_weight_bank <= '{default: '0};
       fc2_wptr <= 0;
     end 
+    else if (load_fc2_cnt_incr && wl_zip) begin
+      if (wl_dec_hdr)
+        fc2_weight_bank[~wbank_act] <= '{default: int8_t'(wl_dec_fill)};
+      for (int b = 0; b < 4; b++) begin
+        if (wl_dec_wr[b] && (wl_dec_idx[b] < FC2_SIZE))
+          fc2_weight_bank[~wbank_act][wl_dec_idx[b]] <= int8_t'(wl_dec_val[b]);
+      end
+    end
     else if (load_fc2_cnt_incr && (fc2_wptr < FC2_SIZE)) begin
       for (int b = 0; b < 4; b++) begin
         if ((fc2_wptr + b) < FC2_SIZE)
-          fc2_weight_flat[fc2_wptr + b] <= int8_t'(nice_icb_rsp_rdata[8*b +: 8]);
+          fc2_weight_bank[~wbank_act][fc2_wptr + b] <= int8_t'(nice_icb_rsp_rdata[8*b +: 8]);
       end
       fc2_wptr <= fc2_wptr + 4;
     end
+    else if (load_fc2_done) begin
+      fc2_wptr <= 0;
+    end
+    else if (sp_wr_fc2) begin
+      for (int b = 0; b < 4; b++) begin
+        if (nice_sp_icb_cmd_wmask[b] && ((sp_wr_idx + b) < FC2_SIZE))
+          fc2_weight_bank[~wbank_act][sp_wr_idx + b] <= int8_t'(nice_sp_icb_cmd_wdata[8*b +: 8]);
+      end
+    end
   end
 
 
-  //////////// 5. custom3_load_input
-  localparam INPUT_WIDTH      = 28;
-  localparam INPUT_SIZE       = INPUT_WIDTH * INPUT_WIDTH;  // 784
-  localparam INPUT_CNT_CYCLES = 196;
+  //////////// 4b. custom3_load_act
+  // activation LUT after the requant: uint8 code in, uint8 code out, both
+  // on the output scale and zero point of the layer. it stands in for the
+  // relu of the layers selected by CFG_ACT_LUT, so ReLU6, hard-swish,
+  // sigmoid or tanh tables (python/act_lut.py) run in the same cycle, one
+  // read per column. banked with the weights, reset to the identity
+  localparam ACT_SIZE       = 256;
+  localparam ACT_CNT_CYCLES = ACT_SIZE / 4;                  // 64
+  localparam CFG_ACT_LUT    = 3;  // rs1[2:0]: LUT instead of relu / clamp for {fc1, conv2, conv1}
 
-  integer load_input_cnt;
+  integer load_act_cnt;
+  wire [31:0] load_act_lim  = wl_zip ? wl_dec_beats : ACT_CNT_CYCLES;
 
-  wire load_input_cnt_done    = (load_input_cnt == INPUT_CNT_CYCLES);
-  wire load_input_icb_rsp_hs  = state_is_load_input   & nice_icb_rsp_hsked;
-  wire load_input_cnt_incr    = load_input_icb_rsp_hs & ~load_input_cnt_done;
-  assign load_input_done      = load_input_icb_rsp_hs & load_input_cnt_done;
+  wire load_act_cnt_done    = (load_act_cnt == load_act_lim);
+  wire load_act_icb_rsp_hs  = state_is_load_act   & nice_icb_rsp_hsked;
+  wire load_act_cnt_incr    = load_act_icb_rsp_hs & ~load_act_cnt_done;
+  assign load_act_done      = load_act_icb_rsp_hs & load_act_cnt_done;
 
-  // load_input_cnt accumulation
+  // load_act_cnt accumulation
   always @(posedge nice_clk or negedge nice_rst_n) begin
     if (!nice_rst_n)
-      load_input_cnt <= 0;
+      load_act_cnt <= 0;
     else 
-    if (load_input_done)
-      load_input_cnt <= 0;
-    else if (load_input_cnt_incr)
-      load_input_cnt <= load_input_cnt + 1;
+    if (load_act_done)
+      load_act_cnt <= 0;
+    else if (load_act_cnt_incr)
+      load_act_cnt <= load_act_cnt + 1;
     else
-      load_input_cnt <= load_input_cnt;
+      load_act_cnt <= load_act_cnt;
   end
 
   // valid signals
-  wire nice_icb_cmd_valid_load_input = state_is_load_input & (load_input_cnt < INPUT_CNT_CYCLES);
+  wire nice_icb_cmd_valid_load_act = state_is_load_act & (load_act_cnt < load_act_lim);
 
-  // input_weight
-  uint8_t input_reg_flat [INPUT_SIZE];
-  uint8_t input_reg [INPUT_WIDTH][INPUT_WIDTH];
+  uint8_t act_lut_bank [2][ACT_SIZE];
+  uint8_t act_lut      [ACT_SIZE];  // active bank
 
   generate
-    for (genvar i = 0; i < INPUT_WIDTH; i++) begin
-      for (genvar j = 0; j < INPUT_WIDTH; j++) begin
+    for (genvar i = 0; i < ACT_SIZE; i++) begin
+      assign act_lut[i] = act_lut_bank[wbank_act][i];
+    end
+  endgenerate
+
+  logic [$clog2(ACT_SIZE):0] act_wptr;
+
+  // act LUT data storage
+  always @(posedge nice_clk or negedge nice_rst_n) begin
+    if (!nice_rst_n) begin
+      for (int k = 0; k < 2; k++)
+        for (int i = 0; i < ACT_SIZE; i++)
+          act_lut_bank[k][i] <= uint8_t'(i);
+      act_wptr <= 0;
+    end 
+    else if (load_act_cnt_incr && wl_zip) begin
+      if (wl_dec_hdr)
+        act_lut_bank[~wbank_act] <= '{default: wl_dec_fill};
+      for (int b = 0; b < 4; b++) begin
+        if (wl_dec_wr[b] && (wl_dec_idx[b] < ACT_SIZE))
+          act_lut_bank[~wbank_act][wl_dec_idx[b]] <= wl_dec_val[b];
+      end
+    end
+    else if (load_act_cnt_incr && (act_wptr < ACT_SIZE)) begin
+      for (int b = 0; b < 4; b++)
+        act_lut_bank[~wbank_act][act_wptr + b] <= uint8_t'(nice_icb_rsp_rdata[8*b +: 8]);
+      act_wptr <= act_wptr + 4;
+    end
+    else if (load_act_done) begin
+      act_wptr <= 0;
+    end
+    else if (sp_wr_act) begin
+      for (int b = 0; b < 4; b++) begin
+        if (nice_sp_icb_cmd_wmask[b] && ((sp_wr_idx + b) < ACT_SIZE))
+          act_lut_bank[~wbank_act][sp_wr_idx + b] <= uint8_t'(nice_sp_icb_cmd_wdata[8*b +: 8]);
+      end
+    end
+  end
+
+  //////////// 4c. custom3_load_qp
+  // the QP_WORDS int32 of the quant param blob (qp_bank, next to the
+  // constants above), raw words only, CFG_WL_ZIP does not apply to it
+  localparam QP_SIZE        = 4 * QP_WORDS;                 // 140
+  localparam QP_CNT_CYCLES  = QP_WORDS;                     // 35
+
+  integer load_qp_cnt;
+
+  wire load_qp_cnt_done     = (load_qp_cnt == QP_CNT_CYCLES);
+  wire load_qp_icb_rsp_hs   = state_is_load_qp   & nice_icb_rsp_hsked;
+  wire load_qp_cnt_incr     = load_qp_icb_rsp_hs & ~load_qp_cnt_done;
+  assign load_qp_done       = load_qp_icb_rsp_hs & load_qp_cnt_done;
+
+  // load_qp_cnt accumulation
+  always @(posedge nice_clk or negedge nice_rst_n) begin
+    if (!nice_rst_n)
+      load_qp_cnt <= 0;
+    else
+    if (load_qp_done)
+      load_qp_cnt <= 0;
+    else if (load_qp_cnt_incr)
+      load_qp_cnt <= load_qp_cnt + 1;
+    else
+      load_qp_cnt <= load_qp_cnt;
+  end
+
+  // valid signals
+  wire nice_icb_cmd_valid_load_qp = state_is_load_qp & (load_qp_cnt < QP_CNT_CYCLES);
+
+  // quant param storage
+  always @(posedge nice_clk or negedge nice_rst_n) begin
+    if (!nice_rst_n) begin
+      for (int k = 0; k < 2; k++)
+        for (int i = 0; i < QP_WORDS; i++)
+          qp_bank[k][i] <= qp_default(i);
+    end
+    else if (load_qp_cnt_incr) begin
+      qp_bank[~wbank_act][load_qp_cnt] <= nice_icb_rsp_rdata;
+    end
+    else if (sp_wr_qp && ((sp_wr_idx >> 2) < QP_WORDS)) begin
+      for (int b = 0; b < 4; b++) begin
+        if (nice_sp_icb_cmd_wmask[b])
+          qp_bank[~wbank_act][sp_wr_idx >> 2][8*b +: 8] <= nice_sp_icb_cmd_wdata[8*b +: 8];
+      end
+    end
+  end
+
+  logic [2:0] act_lut_en;  // {fc1, conv2, conv1}
+
+  always @(posedge nice_clk or negedge nice_rst_n) begin
+    if (!nice_rst_n)
+      act_lut_en <= '0;
+    else if (nice_req_hsked & custom3_cfg & (nice_req_rs2 == CFG_ACT_LUT))
+      act_lut_en <= nice_req_rs1[2:0];
+  end
+
+  // clamp_u8, then the LUT in place of the relu
+  function automatic uint8_t act_u8(input int32_t acc, input uint8_t zp, input logic relu, input logic lut);
+    return lut ? act_lut[clamp_u8(acc, zp, 1'b0)] : clamp_u8(acc, zp, relu);
+  endfunction
+
+
+  //////////// 5. custom3_load_input
+  localparam INPUT_SIZE       = INPUT_WIDTH * INPUT_WIDTH;  // 784
+  localparam INPUT_BYTES      = INPUT_SIZE * (CONV1_A16 ? 2 : 1);  // 784
+  localparam INPUT_CNT_CYCLES = (INPUT_BYTES + 3) / 4;        // 196
+
+  integer load_input_cnt;
+
+  // custom3_load_frame: the load runs over the raw frame instead
+  localparam FRAME_WIDTH      = INPUT_WIDTH * FRAME_DS;     // 112 at FRAME_DS = 4
+  localparam FRAME_CNT_GRAY   = FRAME_WIDTH * FRAME_WIDTH / 4;  // 4 pixels a beat
+  localparam FRAME_CNT_RGB    = FRAME_WIDTH * FRAME_WIDTH / 2;  // 2 pixels a beat
+
+  if ((FRAME_DS != 0) && ((FRAME_DS > 8) || CONV1_A16)) begin : FRAME_CHECK
+    $error("FRAME_DS is 1 to 8 and writes uint8 pixels, not with CONV1_A16");
+  end
+
+  logic frame_mode;   // this load_input comes from custom3_load_frame
+  logic frame_rgb;    // RGB565, else 8-bit gray
+
+  always @(posedge nice_clk or negedge nice_rst_n) begin
+    if (!nice_rst_n) begin
+      frame_mode <= 1'b0;
+      frame_rgb  <= 1'b0;
+    end
+    else if (nice_req_hsked & custom_input_op) begin
+      frame_mode <= custom3_load_frame;
+      frame_rgb  <= custom3_load_frame & nice_req_rs2[0];
+    end
+  end
+
+  wire [31:0] load_input_lim  = ~frame_mode ? INPUT_CNT_CYCLES :
+                                frame_rgb   ? FRAME_CNT_RGB : FRAME_CNT_GRAY;
+
+  wire load_input_cnt_done    = (load_input_cnt == load_input_lim);
+  wire load_input_icb_rsp_hs  = state_is_load_input   & nice_icb_rsp_hsked;
+  wire load_input_cnt_incr    = load_input_icb_rsp_hs & ~load_input_cnt_done;
+  assign load_input_done      = load_input_icb_rsp_hs & load_input_cnt_done;
+
+  // load_input_cnt accumulation
+  always @(posedge nice_clk or negedge nice_rst_n) begin
+    if (!nice_rst_n)
+      load_input_cnt <= 0;
+    else 
+    if (load_input_done)
+      load_input_cnt <= 0;
+    else if (load_input_cnt_incr)
+      load_input_cnt <= load_input_cnt + 1;
+    else
+      load_input_cnt <= load_input_cnt;
+  end
+
+  // valid signals
+  wire nice_icb_cmd_valid_load_input = state_is_load_input & (load_input_cnt < load_input_lim);
+
+  // input_weight
+  uint8_t input_reg_flat [INPUT_BYTES];
+  uint8_t input_reg [INPUT_WIDTH][INPUT_WIDTH];
+  int16_t input_reg16 [INPUT_WIDTH][INPUT_WIDTH];  // CONV1_A16 view
+
+  generate
+    for (genvar i = 0; i < INPUT_WIDTH; i++) begin
+      for (genvar j = 0; j < INPUT_WIDTH; j++) begin
         assign input_reg[i][j] = input_reg_flat[i * INPUT_WIDTH + j];
+        if (CONV1_A16) begin : INPUT16
+          assign input_reg16[i][j] = {input_reg_flat[2 * (i * INPUT_WIDTH + j) + 1], input_reg_flat[2 * (i * INPUT_WIDTH + j)]};
+        end else begin : INPUT8
+          assign input_reg16[i][j] = '0;
+        end
       end
     end
   endgenerate
 
-  logic [$clog2(INPUT_SIZE):0] input_wptr;
+  logic [$clog2(INPUT_BYTES):0] input_wptr;
+
+  // frame front end. a frame row is a whole number of beats, the beat is
+  // split into pixels, RGB565 goes to luma (77 R + 150 G + 29 B) / 256 on
+  // the 8-bit channels, and each pixel adds into the box sum of its output
+  // column. on the last frame row of a band a column is done with its
+  // last pixel, it is quantised into input_reg and its sum cleared
+  localparam FRAME_SUM_W = $clog2(255 * FRAME_N + 1);
+
+  logic [FRAME_SUM_W-1:0]          frame_sum [INPUT_WIDTH];  // box sums of the current band
+  logic [$clog2(INPUT_WIDTH+1)-1:0] frame_col;               // output column of the next pixel
+  logic [3:0]                      frame_sub;               // its pixel inside the box, FRAME_DS <= 8
+  logic [3:0]                      frame_y;                 // frame row inside the band
+  logic [$clog2(INPUT_WIDTH)-1:0]   frame_row;               // output row of the band
+
+  logic [FRAME_SUM_W-1:0]          frame_sum_nxt [INPUT_WIDTH];
+  logic                            frame_out [INPUT_WIDTH];
+  logic [$clog2(INPUT_WIDTH+1)-1:0] frame_col_nxt;
+  logic [3:0]                      frame_sub_nxt;
+
+  function automatic uint8_t luma565(input logic [15:0] p);
+    int r, g, b;
+    r = {p[15:11], p[15:13]};
+    g = {p[10:5],  p[10:9]};
+    b = {p[4:0],   p[4:2]};
+    return uint8_t'((77 * r + 150 * g + 29 * b + 128) >> 8);
+  endfunction
+
+  always_comb begin : FRAME_BOX
+    frame_sum_nxt = frame_sum;
+    frame_out     = '{default: 1'b0};
+    frame_col_nxt = frame_col;
+    frame_sub_nxt = frame_sub;
+    for (int b = 0; b < 4; b++) begin
+      uint8_t px;
+      px = frame_rgb ? luma565(nice_icb_rsp_rdata[16*(b%2) +: 16]) : uint8_t'(nice_icb_rsp_rdata[8*b +: 8]);
+      if ((b < 2) || ~frame_rgb) begin
+        frame_sum_nxt[frame_col_nxt] = frame_sum_nxt[frame_col_nxt] + px;
+        if (frame_sub_nxt == FRAME_DS - 1) begin
+          frame_out[frame_col_nxt] = (frame_y == FRAME_DS - 1);
+          frame_sub_nxt = '0;
+          frame_col_nxt = frame_col_nxt + 1'b1;
+        end
+        else
+          frame_sub_nxt = frame_sub_nxt + 1'b1;
+      end
+    end
+  end
+
+  wire frame_beat     = load_input_cnt_incr & frame_mode;
+  wire frame_row_end  = (frame_col_nxt == INPUT_WIDTH);
+
+  always @(posedge nice_clk or negedge nice_rst_n) begin : FRAME_ACC
+    if (!nice_rst_n) begin
+      frame_sum <= '{default: '0};
+      frame_col <= '0;
+      frame_sub <= '0;
+      frame_y   <= '0;
+      frame_row <= '0;
+    end
+    else if (nice_req_hsked & custom_input_op) begin
+      frame_sum <= '{default: '0};
+      frame_col <= '0;
+      frame_sub <= '0;
+      frame_y   <= '0;
+      frame_row <= '0;
+    end
+    else if (frame_beat) begin
+      for (int c = 0; c < INPUT_WIDTH; c++)
+        frame_sum[c] <= frame_out[c] ? '0 : frame_sum_nxt[c];
+      frame_col <= frame_row_end ? '0 : frame_col_nxt;
+      frame_sub <= frame_sub_nxt;
+      if (frame_row_end) begin
+        frame_y   <= (frame_y == FRAME_DS - 1) ? '0 : frame_y + 1'b1;
+        frame_row <= (frame_y == FRAME_DS - 1) ? frame_row + 1'b1 : frame_row;
+      end
+    end
+  end
 
   // input buffer data storage
   always @(posedge nice_clk or negedge nice_rst_n) begin : READ_INPUT
@@ -641,9 +1802,14 @@ module e203_subsys_nice_core (
       input_reg_flat <= '{default: '0};
       input_wptr <= 0;
     end 
-    else if (load_input_cnt_incr && (input_wptr < INPUT_SIZE)) begin
+    else if (frame_beat) begin
+      for (int c = 0; c < INPUT_WIDTH; c++)
+        if (frame_out[c])
+          input_reg_flat[frame_row * INPUT_WIDTH + c] <= quant_frame(int32_t'(frame_sum_nxt[c]));
+    end
+    else if (load_input_cnt_incr && (input_wptr < INPUT_BYTES)) begin
       for (int b = 0; b < 4; b++) begin
-        if ((input_wptr + b) < INPUT_SIZE)
+        if ((input_wptr + b) < INPUT_BYTES)
         input_reg_flat[input_wptr + b] <= uint8_t'(nice_icb_rsp_rdata[8*b +: 8]);
       end
       input_wptr <= input_wptr + 4;
@@ -651,6 +1817,12 @@ module e203_subsys_nice_core (
     else if (load_input_cnt_done) begin
       input_wptr <= 0;
     end
+    else if (sp_wr_input) begin
+      for (int b = 0; b < 4; b++) begin
+        if (nice_sp_icb_cmd_wmask[b] && ((sp_wr_idx + b) < INPUT_BYTES))
+          input_reg_flat[sp_wr_idx + b] <= uint8_t'(nice_sp_icb_cmd_wdata[8*b +: 8]);
+      end
+    end
   end
 
 
@@ -660,19 +1832,161 @@ module e203_subsys_nice_core (
   parameter int SA_ROWS = 10;
   parameter int SA_COLS = 5;
 
+  // int4 passes on one multiplier per PE: the two weights go in as one
+  // operand w1 * 2**16 + w0 (21 bit, a single DSP48E1 with the int9 input)
+  // and the column psum holds hi * 2**16 + lo, split below the array
+  parameter int SA_W4_PACK = 0;
+
+  // PE operand widths, CONV2_WINO multiplies V (4 * 255, int11) by U (9 * 255, int13)
+  localparam SA_A_WIDTH = CONV2_WINO ? 11 : 9;
+  localparam SA_W_WIDTH = (SA_W4_PACK && (CONV2_W4 || FC1_W4)) ? 21 :
+                          CONV2_WINO ? 13 : 9;
+
+  // int4 layers get two psum lanes per column, output o = lane * SA_COLS + column
+  localparam SA_LANES    = (CONV2_W4 || FC1_W4) ? 2 : 1;
+  localparam SA_OUTS     = SA_LANES * SA_COLS;
+  localparam CONV2_OCOLS = CONV2_W4 ? (2 * SA_COLS) : SA_COLS;
+  localparam FC1_OCOLS   = FC1_W4   ? (2 * SA_COLS) : SA_COLS;
+
+  if (CONV2_W4 && (CONV2_DW || CONV2_WINO)) begin : CONV2_W4_CHECK
+    $error("CONV2_W4 runs dense direct conv2 only");
+  end
+
+  // the weights pass down the psum registers when they are moved in
+  if ((L_WIDTH < 32) && (CONV2_W4 || FC1_W4 || (L_WIDTH < SA_W_WIDTH))) begin : L_WIDTH_CHECK
+    $error("L_WIDTH < 32 needs CONV2_W4 = FC1_W4 = 0 and at least the %0d bit weights", SA_W_WIDTH);
+  end
+
+  // tiles of each layer over the array
+  localparam CONV1_GRPS    = CONV1_NUM / SA_COLS;                      // 1
+  localparam CONV2_GRPS    = CONV2_NUM / CONV2_OCOLS;                  // 1
+  localparam FC1_IN_TILES  = (FC1_IN_WIDTH + SA_ROWS - 1) / SA_ROWS;  // 2
+  localparam FC1_OUT_TILES = FC1_OUT_WIDTH / FC1_OCOLS;                // 2
+
+  // whole tiles only, a partial one would drop its channels
+  if ((CONV1_NUM % SA_COLS) || (CONV2_NUM % CONV2_OCOLS) || (FC1_OUT_WIDTH % FC1_OCOLS)) begin : TILE_CHECK
+    $error("CONV1_NUM must be a multiple of %0d, CONV2_NUM of %0d, pad with zero-weight channels",
+           SA_COLS, CONV2_OCOLS);
+  end
+
+  // conv im2col: array row s+1 takes slot s, row 0 only seeds the zero psum.
+  // a KxK kernel spreads the taps of one input channel over the slots, in
+  // as many passes as it needs (5x5: 9 + 9 + 7 taps), a 1x1 kernel packs
+  // CONV_SLOTS input channels into each pass instead
+  localparam CONV_SLOTS       = SA_ROWS - 1;                                // 9
+  localparam CONV1_TAP_PASSES = (CONV1_RC + CONV_SLOTS - 1) / CONV_SLOTS;   // 1
+  localparam CONV1_PASSES     = CONV1_TAP_PASSES * (CONV1_A16 ? 2 : 1);     // low then high byte
+  localparam CONV2_TAP_PASSES = CONV2_WINO ? 16 :                          // one per transform position
+                                (CONV2_RC + CONV_SLOTS - 1) / CONV_SLOTS;   // 1
+  localparam CONV2_DW_GRPS    = CONV2_CHA / SA_COLS;
+
+  // CONV2_DW runs the depthwise passes a group of SA_COLS channels at a time,
+  // all of them in one pass: column j holds the kernel of channel
+  // grp * SA_COLS + j and reads that channel on its own row inputs (the
+  // array's COL_IN), so the columns never sum across channels.
+  // the pointwise passes that follow are a dense 1x1 conv
+  wire conv2_dw_pass   = (CONV2_DW != 0) & ~conv2_pw_phase;
+  wire conv2_pw_pass   = (CONV2_DW != 0) &  conv2_pw_phase;
+  // CONV2_WINO packs input channels like a 1x1 kernel and uses
+  // conv2_tap_cnt for the transform position
+  wire conv2_k1        = (CONV2_WIDTH == 1) | conv2_pw_pass | (CONV2_WINO != 0);
+
+  assign conv1_grp_last    = (conv1_grp_cnt == CONV1_GRPS - 1);
+  assign conv1_tap_last    = (conv1_tap_cnt == CONV1_PASSES - 1);
+
+  // CONV1_A16: conv1_tap_cnt runs over the low byte passes, then the high byte ones
+  int  conv1_tap_pass;
+  assign conv1_tap_pass    = conv1_tap_cnt % CONV1_TAP_PASSES;
+  wire conv1_hi_pass       = (CONV1_A16 != 0) && (conv1_tap_cnt >= CONV1_TAP_PASSES);
+  assign conv2_grp_last    = (conv2_grp_cnt == (conv2_dw_pass ? CONV2_DW_GRPS : CONV2_GRPS) - 1);
+  assign conv2_cha_nxt     = conv2_cha_cnt + (conv2_dw_pass ? SA_COLS : conv2_k1 ? CONV_SLOTS : 1);
+  assign conv2_cha_grp_nxt = conv2_dw_pass ? ((conv2_grp_cnt + 1) * SA_COLS) : 0;
+  assign conv2_cha_last    = conv2_dw_pass ? (conv2_cha_nxt == conv2_cha_grp_nxt) : (conv2_cha_nxt >= CONV2_CHA);
+  assign conv2_tap_last    = conv2_pw_pass | (conv2_tap_cnt == CONV2_TAP_PASSES - 1);
+
+  wire conv2_pass_last     = conv2_cha_last & conv2_tap_last;  // last pass of the group
+
+  // tile counters of the pass whose weights move in: the current ones in a
+  // MOVE, those of the next pass when SA_PREMOVE moves it during a CAL
+  // (the same steps as the FSM takes at the end of that CAL)
+  integer mv_conv1_grp;
+  integer mv_conv1_tap;
+  integer mv_conv2_grp;
+  integer mv_conv2_cha;
+  integer mv_conv2_tap;
+  logic   mv_conv2_pw_phase;
+
+  // a next pass in the same layer, the depthwise to pointwise step included
+  wire conv1_pass_nxt      = ~conv1_tap_last | ~conv1_grp_last;
+  wire conv2_pass_nxt      = ~conv2_tap_last | ~conv2_cha_last | ~conv2_grp_last | ((CONV2_DW != 0) & ~conv2_pw_phase);
+
+  always_comb begin : MOVE_PASS
+    mv_conv1_grp      = conv1_grp_cnt;
+    mv_conv1_tap      = conv1_tap_cnt;
+    mv_conv2_grp      = conv2_grp_cnt;
+    mv_conv2_cha      = conv2_cha_cnt;
+    mv_conv2_tap      = conv2_tap_cnt;
+    mv_conv2_pw_phase = conv2_pw_phase;
+    if (state_is_cal_conv1) begin
+      if (~conv1_tap_last)
+        mv_conv1_tap = conv1_tap_cnt + 1;
+      else begin
+        mv_conv1_tap = 0;
+        mv_conv1_grp = conv1_grp_cnt + 1;
+      end
+    end
+    if (state_is_cal_conv2) begin
+      mv_conv2_tap = 0;
+      if (~conv2_tap_last)
+        mv_conv2_tap = conv2_tap_cnt + 1;
+      else if (~conv2_cha_last)
+        mv_conv2_cha = conv2_cha_nxt;
+      else if (~conv2_grp_last) begin
+        mv_conv2_cha = conv2_cha_grp_nxt;
+        mv_conv2_grp = conv2_grp_cnt + 1;
+      end
+      else begin
+        mv_conv2_cha      = 0;
+        mv_conv2_grp      = 0;
+        mv_conv2_pw_phase = 1'b1;
+      end
+    end
+  end
+
+  int  mv_conv1_tap_pass;
+  assign mv_conv1_tap_pass = mv_conv1_tap % CONV1_TAP_PASSES;
+  wire mv_conv2_dw_pass    = (CONV2_DW != 0) & ~mv_conv2_pw_phase;
+  wire mv_conv2_pw_pass    = (CONV2_DW != 0) &  mv_conv2_pw_phase;
+  wire mv_conv2_k1         = (CONV2_WIDTH == 1) | mv_conv2_pw_pass | (CONV2_WINO != 0);
+  assign fc1_in_tile_last  = (fc1_in_tile_cnt == FC1_IN_TILES - 1);
+  assign fc1_out_tile_last = (fc1_out_tile_cnt == FC1_OUT_TILES - 1);
+
   logic   [SA_ROWS-1:0]    sa_en_left;
-  int9_t                   sa_data_left [SA_ROWS];
+  logic signed [SA_A_WIDTH-1:0] sa_data_left [SA_ROWS];
+  logic signed [SA_A_WIDTH-1:0] sa_data_col  [SA_ROWS][SA_COLS];  // CONV2_DW depthwise passes
   logic   [SA_COLS-1:0]    sa_en_up;
   int32_t                  sa_data_up   [SA_COLS];
   logic   [SA_COLS-1:0]    sa_en_down;
   int32_t                  sa_data_down [SA_COLS];
   logic                    sa_mode      [SA_ROWS][SA_COLS];
+  logic                    sa_sat;
+
+  // int4 layer on the array, weights move in and psums come out as two lanes
+  wire sa_w4 = (CONV2_W4 && (state_is_move_conv2 | state_is_cal_conv2)) |
+               (FC1_W4   && (state_is_move_fc1   | state_is_cal_fc1));
+
+  // depthwise pass, every column on its own channel
+  wire sa_col_in = (CONV2_DW != 0) & state_is_cal_conv2 & conv2_dw_pass;
 
   systolic_array_10_5 #(
     .L_WIDTH(L_WIDTH),
     .S_WIDTH(S_WIDTH),
     .ROWS(SA_ROWS),
-    .COLS(SA_COLS)
+    .COLS(SA_COLS),
+    .A_WIDTH(SA_A_WIDTH),
+    .W_WIDTH(SA_W_WIDTH),
+    .W4_PACK(SA_W4_PACK),
+    .COL_IN(CONV2_DW != 0)
   ) u_systolic_array_10_5 (
     .clk       (nice_clk),
     .rst_n     (nice_rst_n),
@@ -680,15 +1994,34 @@ module e203_subsys_nice_core (
     .en_left   (sa_en_left),
     .data_left (sa_data_left),
 
+    .col_in    (sa_col_in),
+    .data_col  (sa_data_col),
+
     .en_up     (sa_en_up),
     .data_up   (sa_data_up),
 
     .en_down   (sa_en_down),
     .data_down (sa_data_down),
 
+    .w4        (sa_w4),
+    .sat       (sa_sat),
+
     .mode      (sa_mode)
   );
 
+  // L_WIDTH < 32: a psum saturated during the last inference, sticky
+  // until the next load_input / run, read through the scratchpad
+  reg sa_sat_r;
+
+  always @(posedge nice_clk or negedge nice_rst_n) begin
+    if (!nice_rst_n)
+      sa_sat_r <= 1'b0;
+    else if (nice_req_hsked & (custom_input_op | custom_run_op))
+      sa_sat_r <= 1'b0;
+    else if (sa_sat)
+      sa_sat_r <= 1'b1;
+  end
+
   ////////////////////// move
   //////////// 6. move_conv1
   integer move_cnt;
@@ -703,14 +2036,19 @@ module e203_subsys_nice_core (
   assign move_fc2_done        = move_fc2_cnt_done;
 
   wire move_cnt_done          = move_conv1_cnt_done | move_conv2_cnt_done | 
-                                move_fc1_cnt_done   | move_fc2_cnt_done;
-  
+                                move_fc1_cnt_done   | move_fc2_cnt_done   |
+                                (sa_premove_run & (move_cnt == SA_ROWS));
+
+  // conv weights moving in, in their MOVE state or ahead of it (SA_PREMOVE)
+  wire sa_mv_conv1            = state_is_move_conv1 | (state_is_cal_conv1 & sa_premove_run);
+  wire sa_mv_conv2            = state_is_move_conv2 | (state_is_cal_conv2 & sa_premove_run);
+
   // move_cnt accumulation
   always @(posedge nice_clk or negedge nice_rst_n) begin : MOVE_CNT
     if (!nice_rst_n)
       move_cnt <= 0;
     else 
-    if (state_is_move) begin
+    if ((state_is_move & ~preempt_take) | sa_premove_run) begin
       if (move_cnt_done)
         move_cnt <= 0;
       else
@@ -721,6 +2059,14 @@ module e203_subsys_nice_core (
   reg [($clog2(FC1_OUT_WIDTH))*2-1:0]  fc1_move_select_row_idx[SA_COLS];
   reg [($clog2(FC1_IN_WIDTH))*2-1:0]   fc1_move_select_col_idx;
 
+  // park on a pass boundary, before the MOVE has changed anything: the
+  // move counter, the fc select counters and the weight feed all hold
+  wire preempt_pass = state_is_move & (move_cnt == 0) & preempt_ok;
+  // an fc_sync issued while an image is parked waits the engine out, the
+  // one resume_state belongs to the parked image
+  wire preempt_fc   = (state_is_fc_hand | state_is_fc_wait) & ~fc_idle & (resume_state == IDLE);
+  assign preempt_take = nice_irq_req & (preempt_pass | preempt_fc);
+
   // fc1 move select idx accumulation
   always @(posedge nice_clk or negedge nice_rst_n) begin
     if (!nice_rst_n) begin
@@ -731,29 +2077,24 @@ module e203_subsys_nice_core (
       for (int i = 0; i < SA_COLS; i++) begin
         fc1_move_select_row_idx[i] <= $unsigned(i);   // 0~4
       end
-      fc1_move_select_col_idx <= 'd9;                 // 9
+      fc1_move_select_col_idx <= SA_ROWS - 1;         // 9
     end
     else if (cal_fc1_done) begin
-      if (fc1_block_cnt == 0) begin
-        for (int i = 0; i < SA_COLS; i++) begin      
-          fc1_move_select_row_idx[i] <= $unsigned(i); // 0~4
-        end
-        fc1_move_select_col_idx <= 'd19;              // 19
-      end
-      else if (fc1_block_cnt == 1) begin
-        for (int i = 0; i < SA_COLS; i++) begin      
-          fc1_move_select_row_idx[i] <= $unsigned(i+5); // 5~9
+      // next block: in-tiles are inner, out-tile moves on after the last one
+      if (fc1_in_tile_last) begin
+        for (int i = 0; i < SA_COLS; i++) begin
+          fc1_move_select_row_idx[i] <= $unsigned((fc1_out_tile_cnt + 1) * FC1_OCOLS + i); // 5~9
         end
-        fc1_move_select_col_idx <= 'd9;                 // 9
+        fc1_move_select_col_idx <= SA_ROWS - 1;                                           // 9
       end
-      else if (fc1_block_cnt == 2) begin
-        for (int i = 0; i < SA_COLS; i++) begin      
-          fc1_move_select_row_idx[i] <= $unsigned(i+5); // 5~9
+      else begin
+        for (int i = 0; i < SA_COLS; i++) begin
+          fc1_move_select_row_idx[i] <= $unsigned(fc1_out_tile_cnt * FC1_OCOLS + i);
         end
-        fc1_move_select_col_idx <= 'd19;                // 19
+        fc1_move_select_col_idx <= (fc1_in_tile_cnt + 2) * SA_ROWS - 1;                    // 19
       end
     end
-    else if (state_is_move_fc1) begin
+    else if (state_is_move_fc1 & ~preempt_take) begin
       fc1_move_select_col_idx <= fc1_move_select_col_idx - 1;
     end
   end
@@ -781,27 +2122,96 @@ module e203_subsys_nice_core (
         fc2_move_select_col_idx <= 'd9;                 // 9
       end
     end
-    else if (state_is_move_fc2) begin
+    else if (state_is_move_fc2 & ~preempt_take) begin
       fc2_move_select_col_idx <= fc2_move_select_col_idx - 1;
     end
   end
 
+  // tap and input channel carried by each slot in the current pass
+  int   conv1_slot_tap [CONV_SLOTS];
+  int   conv1_slot_trow[CONV_SLOTS];
+  int   conv1_slot_tcol[CONV_SLOTS];
+  logic conv1_slot_ok  [CONV_SLOTS];
+  int   conv2_slot_tap [CONV_SLOTS];
+  int   conv2_slot_trow[CONV_SLOTS];
+  int   conv2_slot_tcol[CONV_SLOTS];
+  int   conv2_slot_cha [CONV_SLOTS];
+  logic conv2_slot_ok  [CONV_SLOTS];
+  // the same for the pass that is moving in (mv_*)
+  int   mv_conv1_slot_tap[CONV_SLOTS];
+  logic mv_conv1_slot_ok [CONV_SLOTS];
+  int   mv_conv2_slot_tap[CONV_SLOTS];
+  int   mv_conv2_slot_cha[CONV_SLOTS];
+  logic mv_conv2_slot_ok [CONV_SLOTS];
+
+  always_comb begin : IM2COL_SLOT
+    for (int s = 0; s < CONV_SLOTS; s++) begin
+      conv1_slot_tap[s] = (CONV1_WIDTH == 1) ? 0 : (conv1_tap_pass * CONV_SLOTS + s);
+      conv1_slot_trow[s] = conv1_slot_tap[s] / CONV1_WIDTH;
+      conv1_slot_tcol[s] = conv1_slot_tap[s] % CONV1_WIDTH;
+      conv1_slot_ok[s]  = (CONV1_WIDTH == 1) ? (s == 0) : (conv1_slot_tap[s] < CONV1_RC);  // conv1 has one input channel
+      conv2_slot_tap[s] = conv2_k1 ? 0 : (conv2_tap_cnt * CONV_SLOTS + s);
+      conv2_slot_trow[s] = conv2_slot_tap[s] / CONV2_WIDTH;
+      conv2_slot_tcol[s] = conv2_slot_tap[s] % CONV2_WIDTH;
+      conv2_slot_cha[s] = conv2_k1 ? (conv2_cha_cnt + s) : conv2_cha_cnt;
+      conv2_slot_ok[s]  = (conv2_slot_tap[s] < CONV2_RC) && (conv2_slot_cha[s] < CONV2_CHA);
+
+      mv_conv1_slot_tap[s] = (CONV1_WIDTH == 1) ? 0 : (mv_conv1_tap_pass * CONV_SLOTS + s);
+      mv_conv1_slot_ok[s]  = (CONV1_WIDTH == 1) ? (s == 0) : (mv_conv1_slot_tap[s] < CONV1_RC);
+      mv_conv2_slot_tap[s] = mv_conv2_k1 ? 0 : (mv_conv2_tap * CONV_SLOTS + s);
+      mv_conv2_slot_cha[s] = mv_conv2_k1 ? (mv_conv2_cha + s) : mv_conv2_cha;
+      mv_conv2_slot_ok[s]  = (mv_conv2_slot_tap[s] < CONV2_RC) && (mv_conv2_slot_cha[s] < CONV2_CHA);
+    end
+  end
+
   // send weight to SA after sub zero_point
-  int9_t weight_res[SA_COLS-1:0];
+  logic signed [SA_W_WIDTH-1:0] weight_res[SA_COLS-1:0];
+
+  // int4 weights of lane 1 / lane 0 as the PE takes them
+  function automatic logic signed [20:0] w4_pair(input int8_t w1, input int8_t w0);
+    if (SA_W4_PACK)
+      return (21'(w1) <<< 16) + 21'(w0);
+    else
+      return {13'd0, w1[3:0], w0[3:0]};
+  endfunction
 
   // input:  weight / weight_zp
   // output: weight_res => sa_data_up
   // dequant weight by sub zero_point
   always_comb begin
     for (int i = 0; i < SA_COLS; i++) begin
-      if (state_is_move_conv1) begin
-        weight_res[i] = conv1_weight[i][CONV1_RC-1-move_cnt] - $signed(conv1_weight_zp);
+      if (sa_mv_conv1) begin  // slots go in bottom first, unused ones hold 0
+        if ((move_cnt < CONV_SLOTS) && mv_conv1_slot_ok[CONV_SLOTS-1-move_cnt])
+          weight_res[i] = conv1_weight[mv_conv1_grp*SA_COLS + i][mv_conv1_slot_tap[CONV_SLOTS-1-move_cnt]] - $signed(conv1_weight_zp);
+        else
+          weight_res[i] = '0;
       end
-      else if (state_is_move_conv2) begin
-        weight_res[i] = conv2_weight[i][conv2_cha_cnt][CONV1_RC-1-move_cnt] - $signed(conv2_weight_zp);
+      else if (sa_mv_conv2) begin
+        int s;
+        s = CONV_SLOTS-1-move_cnt;
+        if ((move_cnt >= CONV_SLOTS) || !mv_conv2_slot_ok[s])
+          weight_res[i] = '0;
+        else if (mv_conv2_pw_pass)
+          weight_res[i] = conv2_weight_flat[CONV2_DW_SIZE + (mv_conv2_grp*SA_COLS + i) * CONV2_CHA + mv_conv2_slot_cha[s]] - $signed(conv2_weight_zp);
+        else if (mv_conv2_dw_pass)  // the kernel of the column's own channel
+          weight_res[i] = conv2_weight_flat[(mv_conv2_grp*SA_COLS + i) * CONV2_RC + mv_conv2_slot_tap[s]] - $signed(conv2_dw_weight_zp);
+        else if (CONV2_WINO)  // U of the kernel at transform position mv_conv2_tap, from the loader
+          weight_res[i] = conv2_wino_u_bank[wbank_act][(mv_conv2_grp*SA_COLS + i) * CONV2_CHA + mv_conv2_slot_cha[s]][mv_conv2_tap] -
+                          $signed(conv2_weight_zp) * WINO_GZ[mv_conv2_tap];
+        else if (CONV2_W4)  // {lane 1, lane 0}
+          weight_res[i] = w4_pair(conv2_weight[mv_conv2_grp*CONV2_OCOLS + SA_COLS + i][mv_conv2_slot_cha[s]][mv_conv2_slot_tap[s]],
+                                  conv2_weight[mv_conv2_grp*CONV2_OCOLS + i][mv_conv2_slot_cha[s]][mv_conv2_slot_tap[s]]);
+        else
+          weight_res[i] = conv2_weight[mv_conv2_grp*SA_COLS + i][mv_conv2_slot_cha[s]][mv_conv2_slot_tap[s]] - $signed(conv2_weight_zp);
       end
-      else if (state_is_move_fc1) begin
-        weight_res[i] = fc1_weight[fc1_move_select_row_idx[i]][fc1_move_select_col_idx] - $signed(fc1_weight_zp);
+      else if (state_is_move_fc1) begin  // rows past FC1_IN_WIDTH in the last in-tile hold 0
+        if (fc1_move_select_col_idx >= FC1_IN_WIDTH)
+          weight_res[i] = '0;
+        else if (FC1_W4)
+          weight_res[i] = w4_pair(fc1_weight[fc1_move_select_row_idx[i] + SA_COLS][fc1_move_select_col_idx],
+                                  fc1_weight[fc1_move_select_row_idx[i]][fc1_move_select_col_idx]);
+        else
+          weight_res[i] = fc1_weight[fc1_move_select_row_idx[i]][fc1_move_select_col_idx] - $signed(fc1_weight_zp);
       end
       else if (state_is_move_fc2) begin
         weight_res[i] = fc2_weight[fc2_move_select_row_idx[i]][fc2_move_select_col_idx] - $signed(fc2_weight_zp);
@@ -819,7 +2229,7 @@ module e203_subsys_nice_core (
       sa_data_up  <= '{default: '0};
       sa_mode     <= '{default: 1'b0};
     end
-    else if (state_is_move) begin
+    else if ((state_is_move & ~preempt_take) | sa_premove_run) begin
       if (move_cnt == 0) begin                                    // 0
         sa_mode   <= '{default: 1'b1};
         sa_en_up  <= {SA_COLS{1'b1}};
@@ -833,7 +2243,7 @@ module e203_subsys_nice_core (
         end
       end
       else if (move_cnt == SA_ROWS-1) begin                       // 9
-        if (state_is_move_conv1 | state_is_move_conv2) begin
+        if (sa_mv_conv1 | sa_mv_conv2) begin
           sa_data_up  <= '{default: '0};
         end else if (state_is_move_fc1 | state_is_move_fc2) begin
           for (int i = 0; i < SA_COLS; i++) begin
@@ -856,11 +2266,7 @@ module e203_subsys_nice_core (
 
   ////////////////////// cal
   //////////// 7. cal_conv1
-  localparam CONV1_SELECT_WIDTH = INPUT_WIDTH - CONV1_WIDTH * 2;            // 22
-  localparam POOL1_OUTPUT_WIDTH = INPUT_WIDTH / 2;                          // 14
-  localparam CONV1_OUTPUT_WIDTH = POOL1_OUTPUT_WIDTH - CONV1_WIDTH + 1;     // 12
-  localparam CONV1_OUTPUT_SIZE  = CONV1_OUTPUT_WIDTH * CONV1_OUTPUT_WIDTH;  // 144
-  localparam CAL_CONV1_CYCLES   = CONV1_OUTPUT_SIZE + CONV1_RC + SA_COLS;   // 158
+  localparam CAL_CONV1_CYCLES   = CONV1_OUTPUT_SIZE + CONV_SLOTS + SA_COLS + SA_IN_PIPE;   // 158
 
   integer cal_conv1_cnt;
   wire cal_conv1_cnt_done    = (cal_conv1_cnt == CAL_CONV1_CYCLES);
@@ -881,75 +2287,79 @@ module e203_subsys_nice_core (
       cal_conv1_cnt <= cal_conv1_cnt;
   end
 
-  reg [($clog2(CONV1_SELECT_WIDTH))*2-1:0]  conv1_input_select_row_idx[CONV1_RC];
-  reg [($clog2(CONV1_SELECT_WIDTH))*2-1:0]  conv1_input_select_col_idx[CONV1_RC];
-
-  // input matrix move to SA index accumulation
-  always @(posedge nice_clk or negedge nice_rst_n) begin
-    if (!nice_rst_n) begin
-      conv1_input_select_row_idx <= '{default: '0};
-      conv1_input_select_col_idx <= '{default: '0};
-    end 
-    else if (cal_conv1_done) begin
-      conv1_input_select_row_idx <= '{default: '0};
-      conv1_input_select_col_idx <= '{default: '0};
-    end
-    else if (cal_conv1_cnt) begin // >=1
-      for (int i = 0; i < CONV1_RC; i++) begin
-        if (conv1_input_select_col_idx[i] == CONV1_SELECT_WIDTH) begin
-            conv1_input_select_col_idx[i] <= 0;
-          if (conv1_input_select_row_idx[i] == CONV1_SELECT_WIDTH)
-            conv1_input_select_row_idx[i] <= 0;
-          else
-            conv1_input_select_row_idx[i] <= conv1_input_select_row_idx[i] + 2;
-        end 
-        else begin
-          if (i <= cal_conv1_cnt-1)
-          conv1_input_select_col_idx[i] <= conv1_input_select_col_idx[i] + 2;
-        end
-      end
-    end
-  end
-
-  reg [$clog2(CONV1_OUTPUT_WIDTH)-1:0]  conv1_output_store_row_idx[CONV1_NUM];
-  reg [$clog2(CONV1_OUTPUT_WIDTH)-1:0]  conv1_output_store_col_idx[CONV1_NUM];
+  // array side: the feed of cnt c enters the array at c + SA_IN_PIPE
+  int sa_conv1_cnt;
+  assign sa_conv1_cnt = cal_conv1_cnt - SA_IN_PIPE;
+
+  // output pixel each slot is reading and the pooled-map address of its
+  // tap, registered one cycle ahead of sa_input_res
+  reg [$clog2(CONV1_OUTPUT_WIDTH)-1:0]  conv1_input_select_row_idx[CONV_SLOTS];
+  reg [$clog2(CONV1_OUTPUT_WIDTH)-1:0]  conv1_input_select_col_idx[CONV_SLOTS];
+  reg [$clog2(CONV1_PF*POOL1_OUTPUT_WIDTH)-1:0]  conv1_in_row[CONV_SLOTS];
+  reg [$clog2(CONV1_PF*POOL1_OUTPUT_WIDTH)-1:0]  conv1_in_col[CONV_SLOTS];
+  reg                         conv1_in_pad[CONV_SLOTS];
+
+  conv_addr_gen #(
+    .LANES     (CONV_SLOTS),
+    .OUT_WIDTH (CONV1_OUTPUT_WIDTH),
+    .FIRST     (1),
+    .STRIDE    (CONV1_STRIDE),
+    .PAD       (CONV1_PAD),
+    .PF        (CONV1_PF),
+    .MAP_WIDTH (POOL1_OUTPUT_WIDTH)
+  ) u_conv1_input_addr (
+    .clk     (nice_clk),
+    .rst_n   (nice_rst_n),
+    .clear   (cal_conv1_done),
+    .cnt     (cal_conv1_cnt),
+    .tap_row (conv1_slot_trow),
+    .tap_col (conv1_slot_tcol),
+    .out_row (conv1_input_select_row_idx),
+    .out_col (conv1_input_select_col_idx),
+    .in_row  (conv1_in_row),
+    .in_col  (conv1_in_col),
+    .in_pad  (conv1_in_pad)
+  );
 
-  // conv1 output buffer index accumulation
-  always @(posedge nice_clk or negedge nice_rst_n) begin
-    if (!nice_rst_n) begin
-      conv1_output_store_row_idx <= '{default: '0};
-      conv1_output_store_col_idx <= '{default: '0};
-    end 
-    else if (cal_conv1_done) begin
-      conv1_output_store_row_idx <= '{default: '0};
-      conv1_output_store_col_idx <= '{default: '0};
-    end
-    else if (cal_conv1_cnt >= (SA_ROWS + 1)) begin // >=11
-      for (int i = 0; i < CONV1_NUM; i++) begin
-        if (conv1_output_store_col_idx[i] == CONV1_OUTPUT_WIDTH - 1) begin
-          conv1_output_store_col_idx[i] <= 0;
-          if (conv1_output_store_row_idx[i] == CONV1_OUTPUT_WIDTH - 1)
-            conv1_output_store_row_idx[i] <= 0;
-          else
-            conv1_output_store_row_idx[i] <= conv1_output_store_row_idx[i] + 1;
-        end 
-        else begin
-          if (i < (cal_conv1_cnt - (CONV1_RC + 1)))
-            conv1_output_store_col_idx[i] <= conv1_output_store_col_idx[i] + 1;
-        end
-      end
-    end
-  end
+  // conv1 output buffer index, column i stores from cnt CONV_SLOTS+2+i
+  reg [$clog2(CONV1_OUTPUT_WIDTH)-1:0]  conv1_output_store_row_idx[SA_COLS];
+  reg [$clog2(CONV1_OUTPUT_WIDTH)-1:0]  conv1_output_store_col_idx[SA_COLS];
+
+  conv_addr_gen #(
+    .LANES     (SA_COLS),
+    .OUT_WIDTH (CONV1_OUTPUT_WIDTH),
+    .FIRST     (CONV_SLOTS + 2)
+  ) u_conv1_output_addr (
+    .clk     (nice_clk),
+    .rst_n   (nice_rst_n),
+    .clear   (cal_conv1_done),
+    .cnt     (sa_conv1_cnt),
+    .tap_row ('{default: 0}),
+    .tap_col ('{default: 0}),
+    .out_row (conv1_output_store_row_idx),
+    .out_col (conv1_output_store_col_idx),
+    .in_row  (),
+    .in_col  (),
+    .in_pad  ()
+  );
   
   //////////// 7. cal_conv2
-  localparam CONV2_SELECT_WIDTH = CONV1_OUTPUT_WIDTH - CONV2_WIDTH * 2;     // 6
-  localparam POOL2_OUTPUT_WIDTH = CONV1_OUTPUT_WIDTH / 2;                   // 6
-  localparam CONV2_OUTPUT_WIDTH = POOL2_OUTPUT_WIDTH - CONV2_WIDTH + 1;     // 4
-  localparam CONV2_OUTPUT_SIZE  = CONV2_OUTPUT_WIDTH * CONV2_OUTPUT_WIDTH;  // 16
-  localparam CAL_CONV2_CYCLES   = CONV2_OUTPUT_SIZE + CONV2_RC + SA_COLS;   // 30
+  localparam CAL_CONV2_CYCLES   = CONV2_STREAM + CONV_SLOTS + SA_COLS + SA_IN_PIPE + SA_OUT_PIPE;   // 30
 
   integer cal_conv2_cnt;
   wire cal_conv2_cnt_done    = (cal_conv2_cnt == CAL_CONV2_CYCLES);
+
+  // cycles of one conv2 output group, MOVE and CAL of every pass, against
+  // the direct conv2 of the same layer (CONV_SLOTS taps, one channel a pass)
+  localparam CONV2_WINO_GRP_CYCLES   = CONV2_TAP_PASSES * ((CONV2_CHA + CONV_SLOTS - 1) / CONV_SLOTS) *
+                                       (SA_ROWS + CAL_CONV2_CYCLES + 2);
+  localparam CONV2_DIRECT_GRP_CYCLES = CONV2_CHA * (SA_ROWS + CONV2_OUTPUT_SIZE + CONV_SLOTS + SA_COLS +
+                                                    SA_IN_PIPE + SA_OUT_PIPE + 2);
+
+  if (CONV2_WINO && (CONV2_WINO_GRP_CYCLES >= CONV2_DIRECT_GRP_CYCLES)) begin : CONV2_WINO_GAIN_CHECK
+    $warning("CONV2_WINO takes %0d cycles per conv2 group, direct %0d: it needs about 9 input channels and larger maps",
+             CONV2_WINO_GRP_CYCLES, CONV2_DIRECT_GRP_CYCLES);
+  end
   wire cal_conv2_icb_rsp_hs  = state_is_cal_conv2;
   wire cal_conv2_cnt_incr    = cal_conv2_icb_rsp_hs & ~cal_conv2_cnt_done;
   assign cal_conv2_done      = cal_conv2_icb_rsp_hs & cal_conv2_cnt_done;
@@ -967,74 +2377,119 @@ module e203_subsys_nice_core (
       cal_conv2_cnt <= cal_conv2_cnt;
   end
 
-  reg [($clog2(CONV2_SELECT_WIDTH))*2-1:0]  conv2_input_select_row_idx[CONV2_RC];
-  reg [($clog2(CONV2_SELECT_WIDTH))*2-1:0]  conv2_input_select_col_idx[CONV2_RC];
+  // array side: the feed of cnt c enters the array at c + SA_IN_PIPE,
+  // sa_output_sum another SA_OUT_PIPE later
+  int sa_conv2_cnt;
+  int so_conv2_cnt;
+  assign sa_conv2_cnt = cal_conv2_cnt - SA_IN_PIPE;
+  assign so_conv2_cnt = sa_conv2_cnt - SA_OUT_PIPE;
+
+  // SA_PREMOVE: the last pixel of a pass leaves row 0 of the last column at
+  // array cnt STREAM + SA_COLS, the MOVE started one cycle before that puts
+  // its first weight into row 0 a cycle later and follows the last psum down
+  // every column. its 11 cycles end with the CAL (CONV_SLOTS = SA_ROWS - 1),
+  // so the next CAL starts as it would after a MOVE state
+  wire sa_premove_go = (SA_PREMOVE != 0) & ~sa_premove & ~nice_irq_req &
+                       ((state_is_cal_conv1 & conv1_pass_nxt & (sa_conv1_cnt == CONV1_OUTPUT_SIZE + SA_COLS - 1)) |
+                        (state_is_cal_conv2 & conv2_pass_nxt & (sa_conv2_cnt == CONV2_STREAM + SA_COLS - 1)));
+  assign sa_premove_run = sa_premove_go | (sa_premove & (move_cnt != 0));
 
-  // input matrix move to SA index accumulation
   always @(posedge nice_clk or negedge nice_rst_n) begin
-    if (!nice_rst_n) begin
-      conv2_input_select_row_idx <= '{default: '0};
-      conv2_input_select_col_idx <= '{default: '0};
-    end 
-    else if (cal_conv2_done) begin
-      conv2_input_select_row_idx <= '{default: '0};
-      conv2_input_select_col_idx <= '{default: '0};
-    end
-    else if (cal_conv2_cnt) begin // >=1
-      for (int i = 0; i < CONV2_RC; i++) begin
-        if (conv2_input_select_col_idx[i] == CONV2_SELECT_WIDTH) begin
-          conv2_input_select_col_idx[i] <= 0;
-          if (conv2_input_select_row_idx[i] == CONV2_SELECT_WIDTH)
-          conv2_input_select_row_idx[i] <= 0;
-          else
-            conv2_input_select_row_idx[i] <= conv2_input_select_row_idx[i] + 2;
-        end 
-        else begin
-          if (i <= cal_conv2_cnt-1)
-          conv2_input_select_col_idx[i] <= conv2_input_select_col_idx[i] + 2;
-        end
-      end
-    end
+    if (!nice_rst_n)
+      sa_premove <= 1'b0;
+    else if (cal_conv1_done | cal_conv2_done)
+      sa_premove <= 1'b0;
+    else if (sa_premove_go)
+      sa_premove <= 1'b1;
   end
 
-  reg [$clog2(CONV2_OUTPUT_WIDTH)-1:0]  conv2_output_store_row_idx[CONV2_NUM];
-  reg [$clog2(CONV2_OUTPUT_WIDTH)-1:0]  conv2_output_store_col_idx[CONV2_NUM];
+  // output pixel each slot is reading and the pooled-map address of its
+  // tap, registered one cycle ahead of sa_input_res
+  // CONV2_WINO: tile each slot is reading and the top-left of its 4x4 patch
+  reg [$clog2(CONV2_LANE_WIDTH)-1:0]  conv2_input_select_row_idx[CONV_SLOTS];
+  reg [$clog2(CONV2_LANE_WIDTH)-1:0]  conv2_input_select_col_idx[CONV_SLOTS];
+  reg [$clog2(CONV2_PF*POOL2_OUTPUT_WIDTH)-1:0]  conv2_in_row[CONV_SLOTS];
+  reg [$clog2(CONV2_PF*POOL2_OUTPUT_WIDTH)-1:0]  conv2_in_col[CONV_SLOTS];
+  reg                         conv2_in_pad[CONV_SLOTS];
+
+  conv_addr_gen #(
+    .LANES     (CONV_SLOTS),
+    .OUT_WIDTH (CONV2_LANE_WIDTH),
+    .FIRST     (1),
+    .STRIDE    (CONV2_WINO ? 2 : CONV2_STRIDE),
+    .PAD       (CONV2_PAD),
+    .PF        (CONV2_PF),
+    .MAP_WIDTH (POOL2_OUTPUT_WIDTH)
+  ) u_conv2_input_addr (
+    .clk     (nice_clk),
+    .rst_n   (nice_rst_n),
+    .clear   (cal_conv2_done),
+    .cnt     (cal_conv2_cnt),
+    .tap_row (conv2_slot_trow),
+    .tap_col (conv2_slot_tcol),
+    .out_row (conv2_input_select_row_idx),
+    .out_col (conv2_input_select_col_idx),
+    .in_row  (conv2_in_row),
+    .in_col  (conv2_in_col),
+    .in_pad  (conv2_in_pad)
+  );
 
-  // conv2 output buffer index accumulation
-  always @(posedge nice_clk or negedge nice_rst_n) begin
-    if (!nice_rst_n) begin
-      conv2_output_store_row_idx <= '{default: '0};
-      conv2_output_store_col_idx <= '{default: '0};
-    end 
-    else if (cal_conv2_done) begin
-      conv2_output_store_row_idx <= '{default: '0};
-      conv2_output_store_col_idx <= '{default: '0};
-    end
-    else if (cal_conv2_cnt >= (SA_ROWS + 1)) begin // >=11
-      for (int i = 0; i < CONV2_NUM; i++) begin
-        if (conv2_output_store_col_idx[i] == CONV2_OUTPUT_WIDTH - 1) begin
-          conv2_output_store_col_idx[i] <= 0;
-          if (conv2_output_store_row_idx[i] == CONV2_OUTPUT_WIDTH - 1)
-            conv2_output_store_row_idx[i] <= 0;
-          else
-            conv2_output_store_row_idx[i] <= conv2_output_store_row_idx[i] + 1;
-        end 
-        else begin
-          if (i < (cal_conv2_cnt - (CONV2_RC + 1)))
-            conv2_output_store_col_idx[i] <= conv2_output_store_col_idx[i] + 1;
-        end
-      end
-    end
-  end
+  // conv2 output buffer index, column i stores from cnt CONV_SLOTS+2+i
+  reg [$clog2(CONV2_LANE_WIDTH)-1:0]  conv2_output_store_row_idx[SA_COLS];
+  reg [$clog2(CONV2_LANE_WIDTH)-1:0]  conv2_output_store_col_idx[SA_COLS];
+
+  conv_addr_gen #(
+    .LANES     (SA_COLS),
+    .OUT_WIDTH (CONV2_LANE_WIDTH),
+    .FIRST     (CONV_SLOTS + 2)
+  ) u_conv2_output_addr (
+    .clk     (nice_clk),
+    .rst_n   (nice_rst_n),
+    .clear   (cal_conv2_done),
+    .cnt     (sa_conv2_cnt),
+    .tap_row ('{default: 0}),
+    .tap_col ('{default: 0}),
+    .out_row (conv2_output_store_row_idx),
+    .out_col (conv2_output_store_col_idx),
+    .in_row  (),
+    .in_col  (),
+    .in_pad  ()
+  );
 
   // conv and fc cal buffers
   uint8_t conv1_output_reg[CONV1_NUM][CONV1_OUTPUT_WIDTH][CONV1_OUTPUT_WIDTH];
+  int32_t conv1_psum_reg[SA_COLS][CONV1_OUTPUT_WIDTH][CONV1_OUTPUT_WIDTH];  // only kept with CONV1_PASSES > 1
   int32_t conv2_output_reg[CONV2_NUM][CONV2_OUTPUT_WIDTH][CONV2_OUTPUT_WIDTH];
+  uint8_t conv2_dw_reg[CONV2_CHA][CONV2_OUTPUT_WIDTH][CONV2_OUTPUT_WIDTH];    // only kept with CONV2_DW
+  int32_t conv2_dw_psum_reg[SA_COLS][CONV2_OUTPUT_WIDTH][CONV2_OUTPUT_WIDTH];
+  int32_t conv2_wino_m_reg[SA_COLS][16][CONV2_WINO_TILES];  // only kept with CONV2_WINO
   int32_t fc1_output_reg[FC1_OUT_WIDTH];
 
+  // CONV2_SKIP: x under each conv2 output, pooled like the conv2 feed and
+  // requantised onto the conv2 output scale and zero point
+  uint8_t conv2_skip_px [CONV2_CHA][CONV2_OUTPUT_WIDTH][CONV2_OUTPUT_WIDTH];
+
+  always_comb begin : SKIP
+    conv2_skip_px = '{default: '0};
+    if (CONV2_SKIP) begin
+      for (int ch = 0; ch < CONV2_CHA; ch++) begin
+        for (int r = 0; r < CONV2_OUTPUT_WIDTH; r++) begin
+          for (int c = 0; c < CONV2_OUTPUT_WIDTH; c++) begin
+            uint8_t win[POOL_WIN];
+            win = '{default: '0};
+            for (int dy = 0; dy < CONV2_PK; dy++)
+              for (int dx = 0; dx < CONV2_PK; dx++)
+                win[dy*CONV2_PK + dx] = conv1_output_reg[ch][r*CONV2_PF + dy][c*CONV2_PF + dx];
+            conv2_skip_px[ch][r][c] = clamp_u8(requant_skip(int32_t'(pool_u8(win, CONV2_PK, POOL_AVG)) - int32_t'(conv1_out_zp)),
+                                               conv2_out_zp, 1'b0);
+          end
+        end
+      end
+    end
+  end
+
   //////////// 7. cal_fc1
-  localparam POOL3_INPUT_SIZE   = CONV2_NUM * CONV2_OUTPUT_SIZE;  // 80
-  localparam CAL_FC1_CYCLES     = FC1_OUT_WIDTH + SA_COLS + 1;    // 16
+  localparam CAL_FC1_CYCLES     = FC1_OUT_WIDTH + SA_COLS + 1 + SA_IN_PIPE + SA_OUT_PIPE;    // 16
 
   integer cal_fc1_cnt;
   wire cal_fc1_cnt_done    = (cal_fc1_cnt == CAL_FC1_CYCLES);
@@ -1055,51 +2510,65 @@ module e203_subsys_nice_core (
       cal_fc1_cnt <= cal_fc1_cnt;
   end
 
-  int32_t conv2_output_flat [POOL3_INPUT_SIZE];
+  // array side and sa_output_sum side, as for conv2
+  int sa_fc1_cnt;
+  int so_fc1_cnt;
+  assign sa_fc1_cnt = cal_fc1_cnt - SA_IN_PIPE;
+  assign so_fc1_cnt = sa_fc1_cnt - SA_OUT_PIPE;
 
-  // convert conv2 output to 1D array
+  uint8_t pool3_output_flat [FC1_IN_WIDTH];
+
+  // pool the conv2 output into the fc1 inputs, [ch][row][col] order. the
+  // conv2 output holds still over CAL_FC1, so this is not on the array feed.
+  // a concat skip appends the x channels, addressed in place
   always_comb begin : FLATTEN
-    int idx;
-    idx = 0;
-    for (int ch = 0; ch < 5; ch++) begin
-      // each 2 row and 2 col is a 2×2 block
-      for (int r = 0; r < 4; r += 2) begin
-        for (int c = 0; c < 4; c += 2) begin
-          // (r,c) → (r,c+1) → (r+1,c) → (r+1,c+1)
-          conv2_output_flat[idx] = conv2_output_reg[ch][r  ][c  ];
-          idx = idx + 1;
-          conv2_output_flat[idx] = conv2_output_reg[ch][r  ][c+1];
-          idx = idx + 1;
-          conv2_output_flat[idx] = conv2_output_reg[ch][r+1][c  ];
-          idx = idx + 1;
-          conv2_output_flat[idx] = conv2_output_reg[ch][r+1][c+1];
-          idx = idx + 1;
+    for (int ch = 0; ch < FC1_IN_CHA; ch++) begin
+      for (int pr = 0; pr < POOL3_OUTPUT_WIDTH; pr++) begin
+        for (int pc = 0; pc < POOL3_OUTPUT_WIDTH; pc++) begin
+          int     sum;
+          uint8_t mx;
+          sum = 0;
+          mx  = '0;
+          // pixels past the last full window are dropped
+          for (int dy = 0; dy < POOL3_K; dy++) begin
+            for (int dx = 0; dx < POOL3_K; dx++) begin
+              uint8_t px;
+              if (ch < CONV2_NUM)
+                px = uint8_t'(conv2_output_reg[ch][pr*POOL3_S + dy][pc*POOL3_S + dx]);
+              else
+                px = conv2_skip_px[ch - CONV2_NUM][pr*POOL3_S + dy][pc*POOL3_S + dx];
+              sum = sum + int'(px);
+              mx  = (px > mx) ? px : mx;
+            end
+          end
+          pool3_output_flat[(ch * POOL3_OUTPUT_WIDTH + pr) * POOL3_OUTPUT_WIDTH + pc] =
+            POOL3_AVG ? uint8_t'((sum + POOL3_K * POOL3_K / 2) / (POOL3_K * POOL3_K)) : mx;
         end
       end
     end
   end
   
 
-  reg [$clog2(POOL3_INPUT_SIZE)-1:0] fc1_select_idx;
+  reg [$clog2(FC1_IN_TILES * SA_ROWS + 1)-1:0] fc1_select_idx;
 
   always @(posedge nice_clk or negedge nice_rst_n) begin
     if (!nice_rst_n) begin
       fc1_select_idx <= '0;
     end 
-    else if (cal_fc1_done) begin
-      if ((fc1_block_cnt == 0) || (fc1_block_cnt == 2)) begin
-        fc1_select_idx <= 'd40;
-      end else begin
+    else if (cal_fc1_done) begin  // one pooled conv2 output into each of the SA_ROWS inputs
+      if (fc1_in_tile_last) begin
         fc1_select_idx <= '0;
+      end else begin
+        fc1_select_idx <= (fc1_in_tile_cnt + 1) * SA_ROWS;  // 10
       end
     end
     else if (cal_fc1_cnt >= 1) begin
-      fc1_select_idx <= fc1_select_idx + 4;
+      fc1_select_idx <= fc1_select_idx + 1'b1;
     end 
   end
 
   //////////// 7. cal_fc2
-  localparam CAL_FC2_CYCLES = FC2_OUT_WIDTH + SA_COLS + 2;   // 17
+  localparam CAL_FC2_CYCLES = FC2_OUT_WIDTH + SA_COLS + 2 + SA_IN_PIPE + SA_OUT_PIPE;   // 17
 
   integer cal_fc2_cnt;
   wire cal_fc2_cnt_done     = (cal_fc2_cnt == CAL_FC2_CYCLES);
@@ -1120,9 +2589,41 @@ module e203_subsys_nice_core (
       cal_fc2_cnt <= cal_fc2_cnt;
   end
 
-  
-  localparam int conv_row_offset[CONV1_RC] = '{0, 0, 0, 2, 2, 2, 4, 4, 4};
-  localparam int conv_col_offset[CONV1_RC] = '{0, 2, 4, 0, 2, 4, 0, 2, 4};
+  // array side and sa_output_sum side, as for conv2
+  int sa_fc2_cnt;
+  int so_fc2_cnt;
+  assign sa_fc2_cnt = cal_fc2_cnt - SA_IN_PIPE;
+  assign so_fc2_cnt = sa_fc2_cnt - SA_OUT_PIPE;
+
+
+  // CONV2_WINO input transform, B^T d B of the pooled 4x4 patch under the
+  // tile of each slot, at transform position conv2_tap_cnt
+  logic signed [10:0] conv2_wino_v [SA_ROWS];
+
+  always_comb begin : WINO_INPUT
+    conv2_wino_v = '{default: '0};
+    for (int i = 1; i < SA_ROWS; i++) begin  // slot i-1
+      int v;
+      v = 0;
+      if (CONV2_WINO && conv2_slot_ok[i-1]) begin
+        for (int a = 0; a < 4; a++) begin
+          for (int b = 0; b < 4; b++) begin
+            int     r, c;
+            uint8_t win[POOL_WIN];
+            r = conv2_in_row[i-1] + CONV2_PF*a;
+            c = conv2_in_col[i-1] + CONV2_PF*b;
+            win = '{default: '0};
+            for (int dy = 0; dy < CONV2_PK; dy++)
+              for (int dx = 0; dx < CONV2_PK; dx++)
+                win[dy*CONV2_PK + dx] = conv1_output_reg[conv2_slot_cha[i-1]][r+dy][c+dx];
+            v += WINO_BT[conv2_tap_cnt / 4][a] * WINO_BT[conv2_tap_cnt % 4][b] *
+                 (int'(pool_u8(win, CONV2_PK, POOL_AVG)) - int'(conv1_out_zp));
+          end
+        end
+      end
+      conv2_wino_v[i] = v;
+    end
+  end
 
   // send conv data to SA after pool and sub zero_point
   int9_t sa_input_res [SA_ROWS];
@@ -1132,68 +2633,142 @@ module e203_subsys_nice_core (
   // dequant (and pool) input data by sub zero_point
   always_comb begin
     for (int i = 0; i < SA_ROWS; i++) begin
-      uint8_t a[7]; 
+      uint8_t win[POOL_WIN];
+      int16_t win16[POOL_WIN];
+      int16_t px16;
+      uint8_t px;
+      logic   px_signed;  // CONV1_A16 high byte, int8 without zero point
       int9_t  quant;
-      int9_t  max_int9;
       int9_t  zp_int9;
-
-      if ((state_is_cal_conv1 && (cal_conv1_cnt <= (CONV1_OUTPUT_SIZE + CONV1_RC))) |
-          (state_is_cal_conv2 && (cal_conv2_cnt <= (CONV2_OUTPUT_SIZE + CONV2_RC)))) begin
-        if ((i >= 1) && ((i <= cal_conv1_cnt) | (i <= cal_conv2_cnt))) begin   // i: 1-9
-          if (state_is_cal_conv1) begin
-            a[0] = input_reg[conv1_input_select_row_idx[i-1]+conv_row_offset[i-1]  ][conv1_input_select_col_idx[i-1]+conv_col_offset[i-1]  ];
-            a[1] = input_reg[conv1_input_select_row_idx[i-1]+conv_row_offset[i-1]  ][conv1_input_select_col_idx[i-1]+conv_col_offset[i-1]+1];
-            a[2] = input_reg[conv1_input_select_row_idx[i-1]+conv_row_offset[i-1]+1][conv1_input_select_col_idx[i-1]+conv_col_offset[i-1]  ];
-            a[3] = input_reg[conv1_input_select_row_idx[i-1]+conv_row_offset[i-1]+1][conv1_input_select_col_idx[i-1]+conv_col_offset[i-1]+1];
+      int     r, c;
+
+      win       = '{default: '0};
+      win16     = '{default: '0};
+      px16      = '0;
+      px        = '0;
+      px_signed = 1'b0;
+      zp_int9   = '0;
+
+      if ((state_is_cal_conv1 && (cal_conv1_cnt <= (CONV1_OUTPUT_SIZE + CONV_SLOTS))) |
+          (state_is_cal_conv2 && (cal_conv2_cnt <= (CONV2_STREAM + CONV_SLOTS)))) begin
+        if ((i >= 1) && ((i <= cal_conv1_cnt) | (i <= cal_conv2_cnt))) begin   // i: 1-9, slot i-1
+          if (state_is_cal_conv1 && conv1_slot_ok[i-1] && CONV1_A16) begin
+            r = conv1_in_row[i-1];
+            c = conv1_in_col[i-1];
+            if (!conv1_in_pad[i-1]) begin  // padding is 0
+              for (int dy = 0; dy < CONV1_PK; dy++)
+                for (int dx = 0; dx < CONV1_PK; dx++)
+                  win16[dy*CONV1_PK + dx] = input_reg16[r+dy][c+dx];
+            end
+            px16      = pool_i16(win16, CONV1_PK, POOL_AVG);
+            px        = conv1_hi_pass ? px16[15:8] : px16[7:0];
+            px_signed = conv1_hi_pass;
+          end else if (state_is_cal_conv1 && conv1_slot_ok[i-1]) begin
+            r = conv1_in_row[i-1];
+            c = conv1_in_col[i-1];
+            if (conv1_in_pad[i-1]) begin
+              win = '{default: input_zp};  // padding
+            end else begin      // pool window, a single pixel when bypassed
+              for (int dy = 0; dy < CONV1_PK; dy++)
+                for (int dx = 0; dx < CONV1_PK; dx++)
+                  win[dy*CONV1_PK + dx] = input_reg[r+dy][c+dx];
+            end
+            px = pool_u8(win, CONV1_PK, POOL_AVG);
             zp_int9 = {1'b0, input_zp};
-          end else if (state_is_cal_conv2) begin
-            a[0] = conv1_output_reg[conv2_cha_cnt][conv2_input_select_row_idx[i-1]+conv_row_offset[i-1]  ][conv2_input_select_col_idx[i-1]+conv_col_offset[i-1]  ];
-            a[1] = conv1_output_reg[conv2_cha_cnt][conv2_input_select_row_idx[i-1]+conv_row_offset[i-1]  ][conv2_input_select_col_idx[i-1]+conv_col_offset[i-1]+1];
-            a[2] = conv1_output_reg[conv2_cha_cnt][conv2_input_select_row_idx[i-1]+conv_row_offset[i-1]+1][conv2_input_select_col_idx[i-1]+conv_col_offset[i-1]  ];
-            a[3] = conv1_output_reg[conv2_cha_cnt][conv2_input_select_row_idx[i-1]+conv_row_offset[i-1]+1][conv2_input_select_col_idx[i-1]+conv_col_offset[i-1]+1];
+          end else if (state_is_cal_conv2 && conv2_slot_ok[i-1] && conv2_pw_pass) begin
+            r = conv2_input_select_row_idx[i-1];
+            c = conv2_input_select_col_idx[i-1];
+            px = conv2_dw_reg[conv2_slot_cha[i-1]][r][c];
+            zp_int9 = {1'b0, conv2_dw_out_zp};
+          end else if (state_is_cal_conv2 && conv2_slot_ok[i-1]) begin
+            r = conv2_in_row[i-1];
+            c = conv2_in_col[i-1];
+            if (conv2_in_pad[i-1]) begin
+              win = '{default: conv1_out_zp};
+            end else begin
+              for (int dy = 0; dy < CONV2_PK; dy++)
+                for (int dx = 0; dx < CONV2_PK; dx++)
+                  win[dy*CONV2_PK + dx] = conv1_output_reg[conv2_slot_cha[i-1]][r+dy][c+dx];
+            end
+            px = pool_u8(win, CONV2_PK, POOL_AVG);
             zp_int9 = {1'b0, conv1_out_zp};
-          end else begin
-            a[0] = '0;
-            a[1] = '0;
-            a[2] = '0;
-            a[3] = '0;
-            zp_int9 = '0;
           end
         end
-      end else if (state_is_cal_fc1 && ((cal_fc1_cnt-1) == i)) begin
-        a[0] = conv2_output_flat[fc1_select_idx];
-        a[1] = conv2_output_flat[fc1_select_idx+1];
-        a[2] = conv2_output_flat[fc1_select_idx+2];
-        a[3] = conv2_output_flat[fc1_select_idx+3];
+      end else if (state_is_cal_fc1 && ((cal_fc1_cnt-1) == i) && (fc1_select_idx < FC1_IN_WIDTH)) begin
+        px = pool3_output_flat[fc1_select_idx];  // pooled in FLATTEN
         zp_int9 = {1'b0, conv2_out_zp};
       end else if (state_is_cal_fc2 && ((cal_fc2_cnt-1) == i)) begin
-        a[0] = fc1_output_reg[i];
-        a[1] = fc1_output_reg[i];
-        a[2] = fc1_output_reg[i];
-        a[3] = fc1_output_reg[i];
+        px = fc1_output_reg[i];
         zp_int9 = {1'b0, fc1_out_zp};
-      end else begin
-        a[0] = '0;
-        a[1] = '0;
-        a[2] = '0;
-        a[3] = '0;
-        zp_int9 = '0;
-      end
-
-      // pool
-      a[4] = (a[0] > a[1]) ? a[0] : a[1];
-      a[5] = (a[2] > a[3]) ? a[2] : a[3];
-      a[6] = (a[4] > a[5]) ? a[4] : a[5];
-      max_int9 = {1'b0, a[6]};
+      end
+
       // dequant
-      quant = max_int9 - zp_int9;
+      quant = px_signed ? int9_t'($signed(px)) : ({1'b0, px} - zp_int9);
 
       sa_input_res[i] = quant;
     end
   end
 
+  // CONV2_DW depthwise pass: column j reads channel grp * SA_COLS + j at the
+  // pixels of the slots, the rows of sa_input_res one per column
+  int9_t  conv2_dw_in [SA_ROWS][SA_COLS];
+
+  always_comb begin : DW_INPUT
+    uint8_t win [POOL_WIN];
+    int     r, c;
+
+    conv2_dw_in = '{default: '0};
+    win         = '{default: '0};
+    r           = 0;
+    c           = 0;
+    if (CONV2_DW && state_is_cal_conv2 && conv2_dw_pass && (cal_conv2_cnt <= (CONV2_STREAM + CONV_SLOTS))) begin
+      for (int i = 1; i < SA_ROWS; i++) begin
+        if ((i <= cal_conv2_cnt) && conv2_slot_ok[i-1]) begin
+          r = conv2_in_row[i-1];
+          c = conv2_in_col[i-1];
+          for (int j = 0; j < SA_COLS; j++) begin
+            if (conv2_in_pad[i-1]) begin
+              win = '{default: conv1_out_zp};
+            end else begin
+              for (int dy = 0; dy < CONV2_PK; dy++)
+                for (int dx = 0; dx < CONV2_PK; dx++)
+                  win[dy*CONV2_PK + dx] = conv1_output_reg[conv2_grp_cnt*SA_COLS + j][r+dy][c+dx];
+            end
+            conv2_dw_in[i][j] = {1'b0, pool_u8(win, CONV2_PK, POOL_AVG)} - {1'b0, conv1_out_zp};
+          end
+        end
+      end
+    end
+  end
+
+  // SA_IN_PIPE: the array takes the feed one cycle later from a flop
+  logic signed [SA_A_WIDTH-1:0] sa_input_q [SA_ROWS];
+  logic signed [SA_A_WIDTH-1:0] sa_feed    [SA_ROWS];
+  int9_t                        sa_dw_q    [SA_ROWS][SA_COLS];
+  int9_t                        sa_dw_feed [SA_ROWS][SA_COLS];
+
+  always @(posedge nice_clk or negedge nice_rst_n) begin
+    if (!nice_rst_n) begin
+      sa_input_q <= '{default: '0};
+      sa_dw_q    <= '{default: '0};
+    end
+    else begin
+      for (int i = 0; i < SA_ROWS; i++)
+        sa_input_q[i] <= (CONV2_WINO && state_is_cal_conv2) ? conv2_wino_v[i] : sa_input_res[i];
+      sa_dw_q <= conv2_dw_in;
+    end
+  end
+
+  always_comb begin
+    for (int i = 0; i < SA_ROWS; i++)
+      sa_feed[i] = SA_IN_PIPE ? sa_input_q[i] :
+                   (CONV2_WINO && state_is_cal_conv2) ? conv2_wino_v[i] : sa_input_res[i];
+    sa_dw_feed = SA_IN_PIPE ? sa_dw_q : conv2_dw_in;
+  end
+
   // receive conv output from SA and add bias and quant and clamp to uint8
-  uint8_t sa_output_res [SA_COLS];
+  uint8_t sa_output_res  [SA_COLS];
+  int32_t sa_output_psum [SA_COLS];  // conv1 / depthwise partial sum between passes
 
   // input:  sa_data_down / cal_bias / output_scale / output_zero_point
   // output: sa_output_res => output_reg
@@ -1206,85 +2781,167 @@ module e203_subsys_nice_core (
       res = 8'd0;
 
       // quant
-      if (state_is_cal_conv1 && (cal_conv1_cnt >= (CONV1_RC + 1))) begin        // cal_conv1
-        in = sa_data_down[i] + conv1_bias[i];
-        // scale = 1/510 ≈ (1 + 1/256) / 512
-        // (acc + acc/256) >> 9
-        in = in + (in >>> 8);
-        in = (in >>> 9) + int32_t'(conv1_out_zp);
-        res = (in < int32_t'(conv1_out_zp)) ? conv1_out_zp :
-              (in > 255) ? 8'd255 : uint8_t'(in);  // clamp to uint8 and relu
+      if (state_is_cal_conv1 && (sa_conv1_cnt >= (CONV_SLOTS + 1))) begin        // cal_conv1
+        int32_t down;
+        down = conv1_hi_pass ? (sa_data_down[i] <<< 8) : sa_data_down[i];
+        if (conv1_tap_cnt == 0)
+          in = down + (conv1_bias[conv1_grp_cnt*SA_COLS + i] <<< (CONV1_A16 ? 8 : 0));
+        else
+          in = down + conv1_psum_reg[i][conv1_output_store_row_idx[i]][conv1_output_store_col_idx[i]];
+        res = act_u8(CONV1_A16 ? requant_a16(in, rq_conv1) : requant(in, rq_conv1), conv1_out_zp, 1'b1, act_lut_en[0]);  // clamp to uint8 and relu
+      end
+      else if (state_is_cal_conv2 && conv2_dw_pass && (sa_conv2_cnt >= (CONV_SLOTS + 1))) begin  // cal_conv2 depthwise, columns in step
+        if (conv2_tap_cnt == 0)
+          in = sa_data_down[i] + conv2_dw_bias[conv2_grp_cnt*SA_COLS + i];
+        else
+          in = sa_data_down[i] + conv2_dw_psum_reg[i][conv2_output_store_row_idx[0]][conv2_output_store_col_idx[0]];
+        res = clamp_u8(requant_conv2_dw(in), conv2_dw_out_zp, 1'b1);
       end
 
-      sa_output_res[i] = res;
+      sa_output_res[i]  = res;
+      sa_output_psum[i] = in;
+    end
+  end
+
+  // psum of each output, two int16 lanes per column on an int4 pass.
+  // SA_W4_PACK: the column holds hi * 2**16 + lo with |lo| < 2**15, lo is
+  // the low half sign-extended and hi the high half plus lo's borrow
+  int32_t sa_lane_down [SA_OUTS];
+
+  always_comb begin
+    for (int o = 0; o < SA_OUTS; o++) begin
+      int i;
+      i = o % SA_COLS;
+      if (!sa_w4)
+        sa_lane_down[o] = (o < SA_COLS) ? sa_data_down[i] : '0;
+      else if (o < SA_COLS)
+        sa_lane_down[o] = int32_t'($signed(sa_data_down[i][15:0]));
+      else if (SA_W4_PACK)
+        sa_lane_down[o] = int32_t'($signed(sa_data_down[i][31:16])) + int32_t'(sa_data_down[i][15]);
+      else
+        sa_lane_down[o] = int32_t'($signed(sa_data_down[i][31:16]));
+    end
+  end
+
+  int32_t sa_acc        [SA_OUTS];
+  int32_t sa_acc_q      [SA_OUTS];
+  int32_t sa_acc_st     [SA_OUTS];
+  int32_t sa_output_sum [SA_OUTS];
+
+  // conv2 output buffer index of each column at the requant
+  reg [$clog2(CONV2_LANE_WIDTH)-1:0]  conv2_so_row_idx[SA_COLS];
+  reg [$clog2(CONV2_LANE_WIDTH)-1:0]  conv2_so_col_idx[SA_COLS];
+  reg [$clog2(CONV2_LANE_WIDTH)-1:0]  conv2_so_row_q[SA_COLS];
+  reg [$clog2(CONV2_LANE_WIDTH)-1:0]  conv2_so_col_q[SA_COLS];
+
+  // input:  conv2_output_reg / fc1_output_reg / fc2_bias / sa_lane_down
+  // output: sa_acc
+  // accumulate, output o drains with column o % SA_COLS
+  always_comb begin : OUTPUT_ACC
+    for (int o = 0; o < SA_OUTS; o++) begin
+      int i;
+      i = o % SA_COLS;
+      if (state_is_cal_conv2 && (o < CONV2_OCOLS))
+        sa_acc[o] = conv2_output_reg[conv2_grp_cnt*CONV2_OCOLS + o][conv2_output_store_row_idx[i]][conv2_output_store_col_idx[i]] + sa_lane_down[o];
+      else if (state_is_cal_fc1 && (o < FC1_OCOLS))
+        sa_acc[o] = fc1_output_reg[fc1_out_tile_cnt*FC1_OCOLS + o] + sa_lane_down[o];
+      else if (state_is_cal_fc2 && (o < SA_COLS))
+        sa_acc[o] = sa_data_down[i] + ((fc2_block_cnt == 0) ? fc2_bias[i] : fc2_bias[i+5]);
+      else
+        sa_acc[o] = '0;
     end
   end
 
-  int32_t sa_output_sum [SA_COLS];
+  // SA_OUT_PIPE: the sum and its conv2 address wait a cycle in flops
+  always @(posedge nice_clk or negedge nice_rst_n) begin
+    if (!nice_rst_n) begin
+      sa_acc_q       <= '{default: '0};
+      conv2_so_row_q <= '{default: '0};
+      conv2_so_col_q <= '{default: '0};
+    end
+    else begin
+      sa_acc_q       <= sa_acc;
+      conv2_so_row_q <= conv2_output_store_row_idx;
+      conv2_so_col_q <= conv2_output_store_col_idx;
+    end
+  end
 
-  // input:  output_reg / sa_data_down / out_zp
+  always_comb begin
+    sa_acc_st        = SA_OUT_PIPE ? sa_acc_q : sa_acc;
+    conv2_so_row_idx = SA_OUT_PIPE ? conv2_so_row_q : conv2_output_store_row_idx;
+    conv2_so_col_idx = SA_OUT_PIPE ? conv2_so_col_q : conv2_output_store_col_idx;
+  end
+
+  // input:  sa_acc_st / out_zp / conv2_skip_px
   // output: sa_output_sum
-  // sum output and quant and clamp to uint8
+  // requant and clamp to uint8 on the last pass, a residual skip adds x first
   always_comb begin
-    for (int i = 0; i < SA_COLS; i++) begin
-      if (state_is_cal_conv2 && (cal_conv2_cnt >= (CONV2_RC + 1)) && (conv2_cha_cnt < 4)) begin        // cal_conv2 0-3
-        sa_output_sum[i] = conv2_output_reg[i][conv2_output_store_row_idx[i]][conv2_output_store_col_idx[i]] + sa_data_down[i];
-      end
-      else if (state_is_cal_conv2 && (cal_conv2_cnt >= (CONV2_RC + 1)) && (conv2_cha_cnt == 4)) begin  // cal_conv2 4
-        int32_t res;
-        res = conv2_output_reg[i][conv2_output_store_row_idx[i]][conv2_output_store_col_idx[i]] + sa_data_down[i];
-        // scale = 1/216 ≈ 1/256 + 1/1024 - 1/4096
-        // (acc>>8) + (acc>>10) - (acc>>12)
-        res = (res >>> 8) + (res >>> 10) - (res >>> 12);
-        res = res + int32_t'(conv2_out_zp);
-        res = (res < int32_t'(conv2_out_zp)) ? conv2_out_zp :
-              (res > 255) ? 8'sd255 : res;  // clamp to uint8 and relu
-        sa_output_sum[i] = res;
-      end
-      else if (state_is_cal_fc1 && (cal_fc1_cnt >= (FC1_OUT_WIDTH + 2)) && ((fc1_block_cnt == 0) || (fc1_block_cnt == 2))) begin // cal_fc1 0/2
-        if ((fc1_block_cnt == 0) && (i == (cal_fc1_cnt-(FC1_OUT_WIDTH + 2)))) begin 
-          sa_output_sum[i] = fc1_output_reg[i] + sa_data_down[i];
-        end else if ((fc1_block_cnt == 2) && (i == (cal_fc1_cnt-(FC1_OUT_WIDTH + 2))))begin
-          sa_output_sum[i] = fc1_output_reg[i+5] + sa_data_down[i];
-        end else begin
-          sa_output_sum[i] = '0;
-        end 
-      end
-      else if (state_is_cal_fc1 && (cal_fc1_cnt >= (FC1_OUT_WIDTH + 2)) && ((fc1_block_cnt == 1) || (fc1_block_cnt == 3))) begin // cal_fc1 1/3
-        int32_t res;
-        if ((fc1_block_cnt == 1) && (i == (cal_fc1_cnt-(FC1_OUT_WIDTH + 2)))) begin 
-          res = fc1_output_reg[i] + sa_data_down[i];
-          // scale = 1/206  ≈ 1/256 + 1/1024
-          // (acc>>8) + (acc>>10)
-          res = (res >>> 8) + (res >>> 10);
-          res = res + int32_t'(fc1_out_zp);
-          res = (res < 0) ? 0 :
-                (res > 255) ? 8'sd255 : res;  // clamp to uint8
-        end else if ((fc1_block_cnt == 3) && (i == (cal_fc1_cnt-(FC1_OUT_WIDTH + 2)))) begin
-          res = fc1_output_reg[i+5] + sa_data_down[i];
-          res = (res >>> 8) + (res >>> 10);
-          res = res + int32_t'(fc1_out_zp);
-          res = (res < 0) ? 0 :
-                (res > 255) ? 8'sd255 : res;  // clamp to uint8
-        end else begin
-          res = '0;
-        end
-        sa_output_sum[i] = res;
+    for (int o = 0; o < SA_OUTS; o++) begin
+      int     i;
+      int32_t skip;
+      i    = o % SA_COLS;
+      skip = '0;
+      if ((CONV2_SKIP == 1) && (o < CONV2_OCOLS))
+        skip = int32_t'(conv2_skip_px[conv2_grp_cnt*CONV2_OCOLS + o][conv2_so_row_idx[i]][conv2_so_col_idx[i]]) -
+               int32_t'(conv2_out_zp);
+      if (state_is_cal_conv2 && ~conv2_dw_pass && (so_conv2_cnt >= (CONV_SLOTS + 1)) && (o < CONV2_OCOLS)) begin  // cal_conv2
+        if (conv2_pass_last)
+          sa_output_sum[o] = int32_t'(act_u8(requant(sa_acc_st[o], rq_conv2) + skip, conv2_out_zp, 1'b1, act_lut_en[1]));  // clamp to uint8 and relu
+        else
+          sa_output_sum[o] = sa_acc_st[o];
       end
-      else if (state_is_cal_fc2 && (cal_fc2_cnt >= (FC2_OUT_WIDTH + 2)) && (i == (cal_fc2_cnt-(FC2_OUT_WIDTH + 2)))) begin // cal_fc2
-        int32_t res;
-        if (fc2_block_cnt == 0)
-          res = sa_data_down[i] + fc2_bias[i];
+      else if (state_is_cal_fc1 && (so_fc1_cnt >= (FC1_OUT_WIDTH + 2)) && (o < FC1_OCOLS) && (i == (so_fc1_cnt-(FC1_OUT_WIDTH + 2)))) begin  // cal_fc1
+        if (fc1_in_tile_last)
+          sa_output_sum[o] = int32_t'(act_u8(requant(sa_acc_st[o], rq_fc1), fc1_out_zp, 1'b0, act_lut_en[2]));  // clamp to uint8
         else
-          res = sa_data_down[i] + fc2_bias[i+5];
-        sa_output_sum[i] = res;
+          sa_output_sum[o] = sa_acc_st[o];
+      end
+      else if (state_is_cal_fc2 && (so_fc2_cnt >= (FC2_OUT_WIDTH + 2)) && (o < SA_COLS) && (i == (so_fc2_cnt-(FC2_OUT_WIDTH + 2)))) begin // cal_fc2
+        sa_output_sum[o] = sa_acc_st[o];
       end
       else begin
-        sa_output_sum[i] = '0;
+        sa_output_sum[o] = '0;
       end
     end 
   end
 
+  int32_t conv2_wino_m [SA_COLS];        // channel sum of this position and tile, this pass included
+  int32_t conv2_wino_y [SA_COLS][2][2];  // last pass: A^T M A >>> 2 on the bias, requantised
+
+  // input:  sa_data_down / conv2_wino_m_reg / conv2_output_reg (bias)
+  // output: conv2_wino_m => conv2_wino_m_reg, conv2_wino_y => conv2_output_reg
+  // CONV2_WINO output transform, the last pass brings position 15 so the
+  // other 15 are already summed over every input channel
+  always_comb begin : WINO_OUTPUT
+    conv2_wino_m = '{default: '0};
+    conv2_wino_y = '{default: '0};
+    for (int i = 0; i < SA_COLS; i++) begin
+      int     t, ty, tx;
+      int32_t m[16];
+      if (CONV2_WINO) begin
+        ty = conv2_output_store_row_idx[i];
+        tx = conv2_output_store_col_idx[i];
+        t  = ty*CONV2_WINO_TW + tx;
+        if (conv2_cha_cnt == 0)
+          conv2_wino_m[i] = sa_data_down[i];
+        else
+          conv2_wino_m[i] = conv2_wino_m_reg[i][conv2_tap_cnt][t] + sa_data_down[i];
+        for (int p = 0; p < 16; p++)
+          m[p] = (p == conv2_tap_cnt) ? conv2_wino_m[i] : conv2_wino_m_reg[i][p][t];
+        for (int a = 0; a < 2; a++) begin
+          for (int b = 0; b < 2; b++) begin
+            int32_t y4;
+            y4 = 0;
+            for (int p = 0; p < 16; p++)
+              y4 += WINO_AT[a][p / 4] * WINO_AT[b][p % 4] * m[p];
+            conv2_wino_y[i][a][b] = int32_t'(act_u8(requant(conv2_output_reg[conv2_grp_cnt*SA_COLS + i][2*ty + a][2*tx + b] + (y4 >>> 2), rq_conv2),
+                                                    conv2_out_zp, 1'b1, act_lut_en[1]));
+          end
+        end
+      end
+    end
+  end
+
   int32_t result_max_buffer;
   int32_t result_max_idx;
 
@@ -1301,16 +2958,20 @@ module e203_subsys_nice_core (
     if (!nice_rst_n) begin
       sa_en_left        <= '0;
       sa_data_left      <= '{default: '0};
+      sa_data_col       <= '{default: '0};
       conv1_output_reg  <= '{default: '0};
+      conv1_psum_reg    <= '{default: '0};
       conv2_output_reg  <= '{default: '0};
+      conv2_dw_reg      <= '{default: '0};
+      conv2_dw_psum_reg <= '{default: '0};
+      conv2_wino_m_reg  <= '{default: '0};
       fc1_output_reg    <= '{default: '0};
       result_max_buffer <= '0;
       result_max_idx    <= '0;
     end
-    else if (state_is_cal_conv1 & (cal_conv1_cnt > 0)) begin
-      if (cal_conv1_cnt == 1) begin // 1
-        sa_en_left <= {{CONV1_RC{1'b1}}, 1'b0};
-        sa_data_left[1] <= sa_input_res[1];
+    else if (state_is_cal_conv1 & (sa_conv1_cnt > 0)) begin
+      if (sa_conv1_cnt == 1) begin // 1
+        sa_en_left <= {{CONV_SLOTS{1'b1}}, 1'b0};
         for (int i = 0; i < CONV2_NUM; i++) begin
           for (int j = 0; j < CONV2_OUTPUT_WIDTH; j++) begin
             for (int k = 0; k < CONV2_OUTPUT_WIDTH; k++) begin
@@ -1323,148 +2984,809 @@ module e203_subsys_nice_core (
         end
         result_max_buffer <= 32'sh8000_0000;
         result_max_idx    <= 0;
-      end 
-      else if ((cal_conv1_cnt > 1) && (cal_conv1_cnt <= CONV1_RC)) begin // 2-9
-        for (int i = 1; i <= CONV1_RC; i++) begin
-          if (i <= cal_conv1_cnt)
-              sa_data_left[i] <= sa_input_res[i];
       end
-      end 
-      else if (cal_conv1_cnt == (CONV1_RC + 1)) begin // 10
-        for (int i = 1; i <= CONV1_RC; i++)
-          sa_data_left[i] <= sa_input_res[i];
-      end
-      else if ((cal_conv1_cnt > (CONV1_RC + 1)) && (cal_conv1_cnt <= (CONV1_RC + 1 + CONV1_NUM))) begin // 11-15
-        for (int i = 1; i <= CONV1_RC; i++)
-          sa_data_left[i] <= sa_input_res[i];
-        for (int i = 0; i < CONV1_NUM; i++) begin
-          if (i < (cal_conv1_cnt - (CONV1_RC + 1)))
-            conv1_output_reg[i][conv1_output_store_row_idx[i]][conv1_output_store_col_idx[i]] <= sa_output_res[i];
-        end
+      else if (sa_conv1_cnt == (CONV1_OUTPUT_SIZE + CONV_SLOTS)) begin // 153
+        sa_en_left <= '0;
       end
-      else if ((cal_conv1_cnt > (CONV1_RC + 1 + CONV1_NUM)) && (cal_conv1_cnt <= CONV1_OUTPUT_SIZE)) begin // 16-144
-        for (int i = 1; i <= CONV1_RC; i++)
-          sa_data_left[i] <= sa_input_res[i];
-        for (int i = 0; i < CONV1_NUM; i++) 
-          conv1_output_reg[i][conv1_output_store_row_idx[i]][conv1_output_store_col_idx[i]] <= sa_output_res[i];
+      // row i feeds its slot for CONV1_OUTPUT_SIZE cycles from cnt i on
+      for (int i = 1; i <= CONV_SLOTS; i++) begin
+        if ((sa_conv1_cnt >= i) && (sa_conv1_cnt < (i + CONV1_OUTPUT_SIZE)))
+          sa_data_left[i] <= sa_feed[i];
+        else
+          sa_data_left[i] <= '0;
       end
-      else if ((cal_conv1_cnt > CONV1_OUTPUT_SIZE) && (cal_conv1_cnt <= (CONV1_OUTPUT_SIZE + CONV1_RC))) begin // 145-153
-        for (int i = 1; i <= CONV1_RC; i++) begin
-          if (i > (cal_conv1_cnt - CONV1_OUTPUT_SIZE))
-            sa_data_left[i] <= sa_input_res[i];
+      // column j drains its outputs from cnt CONV_SLOTS + 2 + j on, 11-158
+      for (int i = 0; i < SA_COLS; i++) begin
+        if ((sa_conv1_cnt >= (CONV_SLOTS + 2 + i)) && (sa_conv1_cnt < (CONV_SLOTS + 2 + i + CONV1_OUTPUT_SIZE))) begin
+          if (conv1_tap_last)
+            conv1_output_reg[conv1_grp_cnt*SA_COLS + i][conv1_output_store_row_idx[i]][conv1_output_store_col_idx[i]] <= sa_output_res[i];
           else
-            sa_data_left[i] <= '0;
-        end
-        for (int i = 0; i < CONV1_NUM; i++) 
-          conv1_output_reg[i][conv1_output_store_row_idx[i]][conv1_output_store_col_idx[i]] <= sa_output_res[i];
-        if (cal_conv1_cnt == (CONV1_OUTPUT_SIZE + CONV1_RC))
-          sa_en_left <= '0;
-      end
-      else if ((cal_conv1_cnt > (CONV1_OUTPUT_SIZE + CONV1_RC)) && (cal_conv1_cnt <= (CONV1_OUTPUT_SIZE + CONV1_RC + SA_COLS))) begin // 154-158
-        for (int i = 0; i < CONV1_NUM; i++) begin
-          if (i >= (cal_conv1_cnt - (CONV1_OUTPUT_SIZE + CONV1_RC + 1)))
-            conv1_output_reg[i][conv1_output_store_row_idx[i]][conv1_output_store_col_idx[i]] <= sa_output_res[i];
+            conv1_psum_reg[i][conv1_output_store_row_idx[i]][conv1_output_store_col_idx[i]] <= sa_output_psum[i];
         end
       end
     end
 
-    else if (state_is_cal_conv2 & (cal_conv2_cnt > 0)) begin
-      if (cal_conv2_cnt == 1) begin // 1
-        sa_en_left <= {{CONV2_RC{1'b1}}, 1'b0};
-        sa_data_left[1] <= sa_input_res[1];
-      end 
-      else if ((cal_conv2_cnt > 1) && (cal_conv2_cnt <= CONV2_RC)) begin // 2-9
-        for (int i = 1; i <= CONV2_RC; i++) begin
-          if (i <= cal_conv2_cnt)
-            sa_data_left[i] <= sa_input_res[i];
-        end
-      end 
-      else if (cal_conv2_cnt == (CONV2_RC + 1)) begin // 10
-        for (int i = 1; i <= CONV2_RC; i++)
-          sa_data_left[i] <= sa_input_res[i];
+    else if (state_is_cal_conv2 & (sa_conv2_cnt > 0)) begin
+      if (sa_conv2_cnt == 1) begin // 1
+        sa_en_left <= {{CONV_SLOTS{1'b1}}, 1'b0};
       end
-      else if ((cal_conv2_cnt > (CONV2_RC + 1)) && (cal_conv2_cnt <= (CONV2_RC + 1 + CONV2_NUM))) begin // 11-15
-        for (int i = 1; i <= CONV1_RC; i++)
-          sa_data_left[i] <= sa_input_res[i];
-        for (int i = 0; i < CONV2_NUM; i++) begin
-          if (i < (cal_conv2_cnt - (CONV2_RC + 1)))
-            conv2_output_reg[i][conv2_output_store_row_idx[i]][conv2_output_store_col_idx[i]] <= sa_output_sum[i];
-        end
+      else if (sa_conv2_cnt == (CONV2_STREAM + CONV_SLOTS)) begin // 25
+        sa_en_left <= '0;
       end
-      else if ((cal_conv2_cnt > (CONV2_RC + 1 + CONV2_NUM)) && (cal_conv2_cnt <= CONV2_OUTPUT_SIZE)) begin // 16
-        for (int i = 1; i <= CONV2_RC; i++)
-          sa_data_left[i] <= sa_input_res[i];
-        for (int i = 0; i < CONV2_NUM; i++) 
-          conv2_output_reg[i][conv2_output_store_row_idx[i]][conv2_output_store_col_idx[i]] <= sa_output_sum[i];
+      for (int i = 1; i <= CONV_SLOTS; i++) begin
+        if ((sa_conv2_cnt >= i) && (sa_conv2_cnt < (i + CONV2_STREAM))) begin
+          sa_data_left[i] <= sa_feed[i];
+          sa_data_col[i]  <= sa_dw_feed[i];
+        end
+        else begin
+          sa_data_left[i] <= '0;
+          sa_data_col[i]  <= '{default: '0};
+        end
       end
-      else if ((cal_conv2_cnt > CONV2_OUTPUT_SIZE) && (cal_conv2_cnt <= (CONV2_OUTPUT_SIZE + CONV2_RC))) begin // 17-25
-        for (int i = 1; i <= CONV2_RC; i++) begin
-          if (i > (cal_conv2_cnt - CONV2_OUTPUT_SIZE))
-            sa_data_left[i] <= sa_input_res[i];
+      for (int i = 0; i < SA_COLS; i++) begin
+        if ((sa_conv2_cnt >= (CONV_SLOTS + 2 + i)) && (sa_conv2_cnt < (CONV_SLOTS + 2 + i + CONV2_STREAM))) begin
+          if (CONV2_WINO) begin
+            int ty, tx;
+            ty = conv2_output_store_row_idx[i];
+            tx = conv2_output_store_col_idx[i];
+            if (conv2_pass_last) begin
+              for (int a = 0; a < 2; a++)
+                for (int b = 0; b < 2; b++)
+                  conv2_output_reg[conv2_grp_cnt*SA_COLS + i][2*ty + a][2*tx + b] <= conv2_wino_y[i][a][b];
+            end
+            else
+              conv2_wino_m_reg[i][conv2_tap_cnt][ty*CONV2_WINO_TW + tx] <= conv2_wino_m[i];
+          end
+        end
+        // a depthwise pass drains all columns with column 0, at its address
+        if (conv2_dw_pass && (sa_conv2_cnt >= (CONV_SLOTS + 2)) && (sa_conv2_cnt < (CONV_SLOTS + 2 + CONV2_STREAM))) begin
+          if (conv2_pass_last)
+            conv2_dw_reg[conv2_grp_cnt*SA_COLS + i][conv2_output_store_row_idx[0]][conv2_output_store_col_idx[0]] <= sa_output_res[i];
           else
-            sa_data_left[i] <= '0;
+            conv2_dw_psum_reg[i][conv2_output_store_row_idx[0]][conv2_output_store_col_idx[0]] <= sa_output_psum[i];
         end
-        for (int i = 0; i < CONV2_NUM; i++) 
-          conv2_output_reg[i][conv2_output_store_row_idx[i]][conv2_output_store_col_idx[i]] <= sa_output_sum[i];
-        if (cal_conv2_cnt == (CONV2_OUTPUT_SIZE + CONV2_RC))
-          sa_en_left <= '0;
-      end
-      else if ((cal_conv2_cnt > (CONV2_OUTPUT_SIZE + CONV2_RC)) && (cal_conv2_cnt <= (CONV2_OUTPUT_SIZE + CONV2_RC + SA_COLS))) begin // 26-30
-        for (int i = 0; i < CONV2_NUM; i++) begin
-          if (i >= (cal_conv2_cnt - (CONV2_OUTPUT_SIZE + CONV2_RC + 1)))
-            conv2_output_reg[i][conv2_output_store_row_idx[i]][conv2_output_store_col_idx[i]] <= sa_output_sum[i];
+        // dense conv2 stores from sa_output_sum, SA_OUT_PIPE later
+        if (~CONV2_WINO && ~conv2_dw_pass &&
+            (so_conv2_cnt >= (CONV_SLOTS + 2 + i)) && (so_conv2_cnt < (CONV_SLOTS + 2 + i + CONV2_STREAM))) begin
+          for (int o = i; o < CONV2_OCOLS; o += SA_COLS)  // both lanes of column i
+            conv2_output_reg[conv2_grp_cnt*CONV2_OCOLS + o][conv2_so_row_idx[i]][conv2_so_col_idx[i]] <= sa_output_sum[o];
         end
       end
     end
 
-    else if (state_is_cal_fc1 & (cal_fc1_cnt > 0)) begin
-      if (cal_fc1_cnt == 1) begin // 1
+    else if (state_is_cal_fc1 & (sa_fc1_cnt > 0)) begin
+      if (sa_fc1_cnt == 1) begin // 1
         sa_en_left <= {SA_ROWS{1'b1}};
-        sa_data_left[0] <= sa_input_res[0];
+        sa_data_left[0] <= sa_feed[0];
       end 
-      else if ((cal_fc1_cnt > 1) && (cal_fc1_cnt <= FC1_OUT_WIDTH)) begin // 2-10
+      else if ((sa_fc1_cnt > 1) && (sa_fc1_cnt <= FC1_OUT_WIDTH)) begin // 2-10
         for (int i = 0; i < FC1_OUT_WIDTH; i++)
-          sa_data_left[i] <= sa_input_res[i];
+          sa_data_left[i] <= sa_feed[i];
       end 
-      else if (cal_fc1_cnt == (FC1_OUT_WIDTH + 1)) begin // 11
+      else if (sa_fc1_cnt == (FC1_OUT_WIDTH + 1)) begin // 11
         sa_en_left <= {SA_ROWS{1'b0}};
         sa_data_left <= '{default: '0};
       end
-      else if ((cal_fc1_cnt > (FC1_OUT_WIDTH + 1)) && (cal_fc1_cnt <= (FC1_OUT_WIDTH + 1 + SA_COLS))) begin // 12-16
-        if (fc1_block_cnt <= 1)
-          fc1_output_reg[cal_fc1_cnt-(FC1_OUT_WIDTH + 2)] <= sa_output_sum[cal_fc1_cnt-(FC1_OUT_WIDTH + 2)];
-        else
-          fc1_output_reg[5+cal_fc1_cnt-(FC1_OUT_WIDTH + 2)] <= sa_output_sum[cal_fc1_cnt-(FC1_OUT_WIDTH + 2)];
+      else if ((so_fc1_cnt > (FC1_OUT_WIDTH + 1)) && (so_fc1_cnt <= (FC1_OUT_WIDTH + 1 + SA_COLS))) begin // 12-16
+        for (int l = 0; l < FC1_OCOLS / SA_COLS; l++)  // both lanes of the column
+          fc1_output_reg[fc1_out_tile_cnt*FC1_OCOLS + l*SA_COLS + so_fc1_cnt-(FC1_OUT_WIDTH + 2)] <= sa_output_sum[l*SA_COLS + so_fc1_cnt-(FC1_OUT_WIDTH + 2)];
       end
     end
 
-    else if (state_is_cal_fc2 & (cal_fc2_cnt > 0)) begin
-      if (cal_fc2_cnt == 1) begin // 1
+    else if (state_is_cal_fc2 & (sa_fc2_cnt > 0)) begin
+      if (sa_fc2_cnt == 1) begin // 1
         sa_en_left <= {SA_ROWS{1'b1}};
-        sa_data_left[0] <= sa_input_res[0];
+        sa_data_left[0] <= sa_feed[0];
       end 
-      else if ((cal_fc2_cnt > 1) && (cal_fc2_cnt <= FC2_OUT_WIDTH)) begin // 2-10
+      else if ((sa_fc2_cnt > 1) && (sa_fc2_cnt <= FC2_OUT_WIDTH)) begin // 2-10
         for (int i = 0; i < FC2_OUT_WIDTH; i++)
-          sa_data_left[i] <= sa_input_res[i];
+          sa_data_left[i] <= sa_feed[i];
       end 
-      else if (cal_fc2_cnt == (FC2_OUT_WIDTH + 1)) begin // 11
+      else if (sa_fc2_cnt == (FC2_OUT_WIDTH + 1)) begin // 11
         sa_en_left <= {SA_ROWS{1'b0}};
         sa_data_left <= '{default: '0};
       end
-      else if ((cal_fc2_cnt > (FC2_OUT_WIDTH + 1)) && (cal_fc2_cnt <= (FC2_OUT_WIDTH + 1 + SA_COLS))) begin // 12-16
-        if (sa_output_sum[cal_fc2_cnt-(FC2_OUT_WIDTH + 2)] > result_max_buffer) begin
-          result_max_buffer <= sa_output_sum[cal_fc2_cnt-(FC2_OUT_WIDTH + 2)];
+      else if ((so_fc2_cnt > (FC2_OUT_WIDTH + 1)) && (so_fc2_cnt <= (FC2_OUT_WIDTH + 1 + SA_COLS))) begin // 12-16
+        if (sa_output_sum[so_fc2_cnt-(FC2_OUT_WIDTH + 2)] > result_max_buffer) begin
+          result_max_buffer <= sa_output_sum[so_fc2_cnt-(FC2_OUT_WIDTH + 2)];
           if (fc2_block_cnt == 0)
-            result_max_idx  <= int32_t'(cal_fc2_cnt-(FC2_OUT_WIDTH + 2));
+            result_max_idx  <= int32_t'(so_fc2_cnt-(FC2_OUT_WIDTH + 2));
           else
-            result_max_idx  <= int32_t'(5 + cal_fc2_cnt-(FC2_OUT_WIDTH + 2));
+            result_max_idx  <= int32_t'(5 + so_fc2_cnt-(FC2_OUT_WIDTH + 2));
         end
       end
     end
   end
 
 
-  wire nice_rsp_valid_load_input = state_is_cal_fc2 & (fc2_block_cnt == 1) & cal_fc2_done;
+  // FC_PIPE answers at the handoff with the previous image, fc_sync once the engine is done.
+  // the FSM moves on after that cycle, an answer not taken then is held
+  // with its class until the E203 takes it, no new request before
+  wire main_rsp_fire = (state_is_cal_fc2 & (fc2_block_cnt == 1) & cal_fc2_done & ~out_wb_r) |
+                       ((state_is_fc_hand | state_is_fc_wait) & fc_idle & ~out_wb_r);
+  wire nice_rsp_valid_load_input = main_rsp_fire | main_rsp_pend;
+
+  reg [`E203_XLEN-1:0] main_rsp_dat;
+
+  always @(posedge nice_clk or negedge nice_rst_n) begin
+    if (!nice_rst_n) begin
+      main_rsp_pend <= 1'b0;
+      main_rsp_dat  <= '0;
+    end
+    else if (main_rsp_fire & ~nice_rsp_ready) begin
+      main_rsp_pend <= 1'b1;
+      main_rsp_dat  <= nice_rsp_rdat;
+    end
+    else if (main_rsp_pend & nice_rsp_ready)
+      main_rsp_pend <= 1'b0;
+  end
+
+
+  ////////////////////////////////////////////////////////////
+  // FC engine (FC_PIPE): fc1 then fc2 on FC_MACS multipliers, one output
+  // neuron per multiplier and one input per cycle, then the logits one
+  // per cycle into the top-k. it works on its own copy of the fc1 inputs
+  ////////////////////////////////////////////////////////////
+  localparam FC_PH_FC1   = 2'd0;
+  localparam FC_PH_FC2   = 2'd1;
+  localparam FC_PH_LOGIT = 2'd2;
+
+  wire    fc_start = state_is_fc_hand & fc_idle;
+
+  logic   fc_busy;
+  logic [1:0] fc_ph;
+  integer fc_g;     // output group, FC_MACS neurons
+  integer fc_k;     // input index, logit index in FC_PH_LOGIT
+  uint8_t fc_in_buf [FC1_IN_WIDTH];   // pooled conv2 output of the image in the engine
+  uint8_t fc_h      [FC1_OUT_WIDTH];  // fc1 output
+  int32_t fc_acc    [FC_MACS];
+  int32_t fc_logit_e [FC2_OUT_WIDTH];
+
+  assign fc_idle = ~fc_busy;
+
+  wire fc_in_last  = (fc_ph == FC_PH_FC1) ? (fc_k == FC1_IN_WIDTH - 1) : (fc_k == FC2_IN_WIDTH - 1);
+  wire fc_grp_last = (fc_ph == FC_PH_FC1) ? ((fc_g + 1) * FC_MACS >= FC1_OUT_WIDTH) :
+                                            ((fc_g + 1) * FC_MACS >= FC2_OUT_WIDTH);
+
+  int32_t fc_acc_nxt [FC_MACS];
+
+  always_comb begin : FC_MAC
+    for (int l = 0; l < FC_MACS; l++) begin
+      int o;
+      int act, wgt;
+      o = fc_g * FC_MACS + l;
+      if (fc_ph == FC_PH_FC1) begin
+        act = int'(fc_in_buf[fc_k]) - int'(conv2_out_zp);
+        wgt = (o < FC1_OUT_WIDTH) ? (int'(fc1_weight[o][fc_k]) - (FC1_W4 ? 0 : int'(fc1_weight_zp))) : 0;
+        fc_acc_nxt[l] = ((fc_k == 0) ? ((o < FC1_OUT_WIDTH) ? fc1_bias[o] : 0) : fc_acc[l]) + act * wgt;
+      end
+      else begin
+        act = int'(fc_h[fc_k]) - int'(fc1_out_zp);
+        wgt = (o < FC2_OUT_WIDTH) ? (int'(fc2_weight[o][fc_k]) - int'(fc2_weight_zp)) : 0;
+        fc_acc_nxt[l] = ((fc_k == 0) ? ((o < FC2_OUT_WIDTH) ? fc2_bias[o] : 0) : fc_acc[l]) + act * wgt;
+      end
+    end
+  end
+
+  always @(posedge nice_clk or negedge nice_rst_n) begin
+    if (!nice_rst_n) begin
+      fc_busy    <= 1'b0;
+      fc_ph      <= FC_PH_FC1;
+      fc_g       <= 0;
+      fc_k       <= 0;
+      fc_in_buf  <= '{default: '0};
+      fc_h       <= '{default: '0};
+      fc_acc     <= '{default: '0};
+      fc_logit_e <= '{default: '0};
+    end
+    else if (fc_start) begin
+      fc_busy   <= 1'b1;
+      fc_ph     <= FC_PH_FC1;
+      fc_g      <= 0;
+      fc_k      <= 0;
+      fc_in_buf <= pool3_output_flat;
+    end
+    else if (fc_busy && (fc_ph == FC_PH_LOGIT)) begin
+      if (fc_k == FC2_OUT_WIDTH - 1) begin
+        fc_busy <= 1'b0;
+        fc_k    <= 0;
+      end
+      else
+        fc_k    <= fc_k + 1;
+    end
+    else if (fc_busy) begin
+      fc_acc <= fc_acc_nxt;
+      if (fc_in_last) begin
+        for (int l = 0; l < FC_MACS; l++) begin
+          int o;
+          o = fc_g * FC_MACS + l;
+          if ((fc_ph == FC_PH_FC1) && (o < FC1_OUT_WIDTH))
+            fc_h[o] <= act_u8(requant(fc_acc_nxt[l], rq_fc1), fc1_out_zp, 1'b0, act_lut_en[2]);
+          else if ((fc_ph == FC_PH_FC2) && (o < FC2_OUT_WIDTH))
+            fc_logit_e[o] <= fc_acc_nxt[l];
+        end
+        fc_k <= 0;
+        if (fc_grp_last) begin
+          fc_g  <= 0;
+          fc_ph <= (fc_ph == FC_PH_FC1) ? FC_PH_FC2 : FC_PH_LOGIT;
+        end
+        else
+          fc_g  <= fc_g + 1;
+      end
+      else
+        fc_k <= fc_k + 1;
+    end
+  end
+
+
+  ////////////////////////////////////////////////////////////
+  // Logits, top-k and result writeback
+  ////////////////////////////////////////////////////////////
+  localparam TOPK       = 3;
+  localparam PROB_WORDS = FC2_OUT_WIDTH / 2;
+  localparam WB_WORDS   = FC2_OUT_WIDTH + 2 * TOPK + PROB_WORDS;  // logits[10], {idx, val}[TOPK], prob[10]
+
+  int32_t fc2_logit [FC2_OUT_WIDTH];
+  int32_t topk_idx  [TOPK];
+  int32_t topk_val  [TOPK];
+
+  // one logit per cycle at so_fc2_cnt 12-16, same timing as result_max_idx
+  // FC_PIPE: from the FC engine, one per cycle in FC_PH_LOGIT
+  wire    logit_vld = FC_PIPE ? (fc_busy && (fc_ph == FC_PH_LOGIT)) :
+                      (state_is_cal_fc2 && (so_fc2_cnt > (FC2_OUT_WIDTH + 1)) && (so_fc2_cnt <= (FC2_OUT_WIDTH + 1 + SA_COLS)));
+  integer logit_col;
+  integer logit_idx;
+  int32_t logit_val;
+
+  assign logit_col = so_fc2_cnt - (FC2_OUT_WIDTH + 2);
+  assign logit_idx = FC_PIPE ? fc_k : (fc2_block_cnt == 0) ? logit_col : (5 + logit_col);
+  assign logit_val = FC_PIPE ? fc_logit_e[fc_k] : sa_output_sum[logit_col];
+
+  int32_t topk_idx_nxt [TOPK];
+  int32_t topk_val_nxt [TOPK];
+
+  // insert into the descending list, ties keep the lower index first like result_max_idx
+  always_comb begin : TOPK_INSERT
+    int pos;
+    pos = TOPK;
+    for (int k = TOPK-1; k >= 0; k--) begin
+      if (logit_val > topk_val[k])
+        pos = k;
+    end
+    for (int k = 0; k < TOPK; k++) begin
+      if (k == pos) begin
+        topk_idx_nxt[k] = int32_t'(logit_idx);
+        topk_val_nxt[k] = logit_val;
+      end
+      else if (k > pos) begin
+        topk_idx_nxt[k] = topk_idx[k-1];
+        topk_val_nxt[k] = topk_val[k-1];
+      end
+      else begin
+        topk_idx_nxt[k] = topk_idx[k];
+        topk_val_nxt[k] = topk_val[k];
+      end
+    end
+  end
+
+  always @(posedge nice_clk or negedge nice_rst_n) begin
+    if (!nice_rst_n) begin
+      fc2_logit <= '{default: '0};
+      topk_idx  <= '{default: '0};
+      topk_val  <= '{default: 32'sh8000_0000};
+    end
+    else if (FC_PIPE ? fc_start : (state_is_cal_conv1 & (cal_conv1_cnt == 1))) begin
+      topk_idx  <= '{default: '0};
+      topk_val  <= '{default: 32'sh8000_0000};
+    end
+    else if (logit_vld) begin
+      fc2_logit[logit_idx] <= logit_val;
+      topk_idx <= topk_idx_nxt;
+      topk_val <= topk_val_nxt;
+    end
+  end
+
+  // a parked image keeps its writeback aside, an fc_sync in between
+  // takes out_wb_r for itself, custom3_resume puts it back
+  reg                  park_wb_r;
+  reg [`E203_XLEN-1:0] park_addr_r;
+
+  always @(posedge nice_clk or negedge nice_rst_n) begin
+    if (!nice_rst_n) begin
+      out_wb_r    <= 1'b0;
+      out_addr_r  <= '0;
+      park_wb_r   <= 1'b0;
+      park_addr_r <= '0;
+    end
+    else begin
+      if (nice_req_hsked & custom_multi_cyc_op) begin
+        out_wb_r   <= custom_wb_op;
+        out_addr_r <= nice_req_rs2;
+      end
+      else if (nice_req_hsked & custom3_resume & (resume_state != IDLE)) begin
+        out_wb_r   <= park_wb_r;
+        out_addr_r <= park_addr_r;
+      end
+
+      if (preempt_take) begin
+        park_wb_r   <= out_wb_r;
+        park_addr_r <= out_addr_r;
+      end
+    end
+  end
+
+  ////////////////////////////////////////////////////////////
+  // Softmax: exp by LUT, one reciprocal, Q15 probabilities
+  ////////////////////////////////////////////////////////////
+  // p[i] = exp(s * (logit[i] - logit_max)) / sum, s = fc2 logit scale
+  // x = (logit_max - logit[i]) * s * 32 ≈ d * 139 / 256, exp(-x/32) = exp_hi[x>>5] * exp_lo[x&31]
+  // LUTs and constants from python/softmax_lut.py (max abs error ~0.5%)
+  localparam SMX_FRAC_BITS = 5;
+  localparam SMX_HI_N      = 12;
+  localparam SMX_EXP_END   = FC2_OUT_WIDTH;                // 0-9   exp and sum
+  localparam SMX_DIV_END   = SMX_EXP_END + 16;             // 10-25 recip = 2^31 / sum
+  localparam SMX_CYCLES    = SMX_DIV_END + FC2_OUT_WIDTH;  // 26-35 p = exp * recip >> 16
+
+  localparam logic [15:0] exp_hi [SMX_HI_N] = '{65535, 24109, 8869, 3263, 1200, 442, 162, 60, 22, 8, 3, 1};
+  localparam logic [15:0] exp_lo [1 << SMX_FRAC_BITS] = '{
+    65535, 63519, 61564, 59670, 57834, 56055, 54330, 52659, 51039, 49468, 47946, 46471, 45042, 43656, 42313, 41011,
+    39749, 38526, 37341, 36192, 35078, 33999, 32953, 31939, 30957, 30004, 29081, 28186, 27319, 26479, 25664, 24874};
+
+  // probability output format, written by custom3_cfg
+  localparam CFG_PROB_FMT = 1;  // rs1[0]: 0 = Q15, 1 = uint8
+
+  integer smx_cnt;
+  wire    smx_cnt_done = (smx_cnt == SMX_CYCLES);
+  assign  softmax_done = state_is_softmax & smx_cnt_done;
+
+  always @(posedge nice_clk or negedge nice_rst_n) begin : SMX_CNT
+    if (!nice_rst_n)
+      smx_cnt <= 0;
+    else 
+    if (softmax_done)
+      smx_cnt <= 0;
+    else if (state_is_softmax)
+      smx_cnt <= smx_cnt + 1;
+    else
+      smx_cnt <= smx_cnt;
+  end
+
+  logic [15:0] smx_exp  [FC2_OUT_WIDTH];
+  logic [15:0] prob_q15 [FC2_OUT_WIDTH];
+  logic [19:0] smx_sum;
+  logic [20:0] smx_rem;
+  logic [15:0] smx_recip;
+  logic [15:0] smx_e;
+
+  // exp of logit[smx_cnt]
+  always_comb begin : SMX_EXP
+    int32_t      d;
+    logic [23:0] x;
+    int          hi;
+    d     = topk_val[0] - fc2_logit[(smx_cnt < SMX_EXP_END) ? smx_cnt : 0];
+    if (d > 32'sd65535)
+      d = 32'sd65535;
+    x     = (24'(d) * 24'd139 + 24'd128) >> 8;
+    hi    = int'(x >> SMX_FRAC_BITS);
+    smx_e = (hi >= SMX_HI_N) ? 16'd0 :
+            16'((32'(exp_hi[hi]) * 32'(exp_lo[x[SMX_FRAC_BITS-1:0]])) >> 16);
+  end
+
+  always @(posedge nice_clk or negedge nice_rst_n) begin : SMX
+    logic [20:0] rem_sh;
+    logic [31:0] p;
+    if (!nice_rst_n) begin
+      smx_exp   <= '{default: '0};
+      prob_q15  <= '{default: '0};
+      smx_sum   <= '0;
+      smx_rem   <= '0;
+      smx_recip <= '0;
+    end
+    else if (state_is_softmax) begin
+      if (smx_cnt < SMX_EXP_END) begin
+        smx_exp[smx_cnt] <= smx_e;
+        smx_sum          <= ((smx_cnt == 0) ? 20'd0 : smx_sum) + 20'(smx_e);
+        smx_rem          <= 21'h8000;  // 2^31 >> 16, sum >= 65534 so the upper quotient bits are 0
+        smx_recip        <= '0;
+      end
+      else if (smx_cnt < SMX_DIV_END) begin
+        // restoring division, one quotient bit per cycle
+        rem_sh = {smx_rem[19:0], 1'b0};
+        if (rem_sh >= 21'(smx_sum)) begin
+          smx_rem   <= rem_sh - 21'(smx_sum);
+          smx_recip <= {smx_recip[14:0], 1'b1};
+        end else begin
+          smx_rem   <= rem_sh;
+          smx_recip <= {smx_recip[14:0], 1'b0};
+        end
+      end
+      else if (smx_cnt < SMX_CYCLES) begin
+        p = (32'(smx_exp[smx_cnt - SMX_DIV_END]) * 32'(smx_recip)) >> 16;
+        prob_q15[smx_cnt - SMX_DIV_END] <= (p > 32'd32767) ? 16'd32767 : p[15:0];
+      end
+    end
+  end
+
+  // Q15 to uint8, 1.0 saturates to 255
+  function automatic uint8_t prob_u8(input logic [15:0] q15);
+    logic [15:0] tmp;
+    tmp = (q15 + 16'd64) >> 7;
+    return (tmp > 16'd255) ? 8'd255 : tmp[7:0];
+  endfunction
+
+  logic prob_fmt_u8;
+
+  always @(posedge nice_clk or negedge nice_rst_n) begin
+    if (!nice_rst_n)
+      prob_fmt_u8 <= 1'b0;
+    else if (nice_req_hsked & custom3_cfg & (nice_req_rs2 == CFG_PROB_FMT))
+      prob_fmt_u8 <= nice_req_rs1[0];
+  end
+
+  assign park_drop = custom3_swap |
+                     (custom3_cfg & ((nice_req_rs2 == CFG_ACT_LUT) | (nice_req_rs2 == CFG_PROB_FMT)));
+
+  // OUT_WB stores WB_WORDS words, it waits for the weight loader to free the bus
+  integer wb_cmd_cnt;
+  integer wb_rsp_cnt;
+  reg     wb_err;
+
+  wire wb_icb_sel       = state_is_out_wb & wl_state_is_idle;
+  wire wb_rsp_cnt_done  = (wb_rsp_cnt == WB_WORDS);
+  wire wb_icb_cmd_hs    = wb_icb_sel & nice_icb_cmd_valid & nice_icb_cmd_ready;
+  wire wb_icb_rsp_hs    = wb_icb_sel & nice_icb_rsp_hsked;
+
+  wire nice_icb_cmd_valid_out_wb = wb_icb_sel & (wb_cmd_cnt < WB_WORDS);
+  wire nice_rsp_valid_out_wb     = state_is_out_wb & wb_rsp_cnt_done;
+  assign out_wb_done             = nice_rsp_valid_out_wb & nice_rsp_hsked;
+
+  always @(posedge nice_clk or negedge nice_rst_n) begin
+    if (!nice_rst_n) begin
+      wb_cmd_cnt <= 0;
+      wb_rsp_cnt <= 0;
+      wb_err     <= 1'b0;
+    end
+    else if (out_wb_done) begin
+      wb_cmd_cnt <= 0;
+      wb_rsp_cnt <= 0;
+      wb_err     <= 1'b0;
+    end
+    else begin
+      if (wb_icb_cmd_hs)
+        wb_cmd_cnt <= wb_cmd_cnt + 1;
+      if (wb_icb_rsp_hs) begin
+        wb_rsp_cnt <= wb_rsp_cnt + 1;
+        wb_err     <= wb_err | nice_icb_rsp_err;
+      end
+    end
+  end
+
+  int32_t wb_wdata;
+
+  always_comb begin : WB_DATA
+    int k;
+    k = wb_cmd_cnt - FC2_OUT_WIDTH;
+    if (wb_cmd_cnt < FC2_OUT_WIDTH)
+      wb_wdata = fc2_logit[wb_cmd_cnt];
+    else if (k < 2 * TOPK)
+      wb_wdata = k[0] ? topk_val[k >> 1] : topk_idx[k >> 1];
+    else begin
+      // probabilities packed low class first, 2 x Q15 or 4 x uint8 per word
+      k = k - 2 * TOPK;
+      wb_wdata = '0;
+      if (prob_fmt_u8) begin
+        for (int b = 0; b < 4; b++)
+          if ((4*k + b) < FC2_OUT_WIDTH)
+            wb_wdata[8*b +: 8] = prob_u8(prob_q15[4*k + b]);
+      end
+      else if (k < PROB_WORDS) begin
+        wb_wdata = {prob_q15[2*k + 1], prob_q15[2*k]};
+      end
+    end
+  end
+
+  wire [`E203_XLEN-1:0] wb_addr = out_addr_r + (wb_cmd_cnt << 2);
+
+
+  ////////////////////////////////////////////////////////////
+  // ALU ops: dot4 / max4 / requant / cfg / swap / get_prob
+  ////////////////////////////////////////////////////////////
+  // config registers written by custom3_cfg, rs2 is the index
+  // (CFG_WL_ZIP is kept with the weight loader, CFG_ACT_LUT with the LUT,
+  // CFG_PROB_FMT with the softmax stage)
+  localparam CFG_ALU_ZP = 0;  // rs1 = {w_zp[15:8], in_zp[7:0]}, zero points of dot4
+
+  uint8_t alu_in_zp;
+  uint8_t alu_w_zp;
+
+  always @(posedge nice_clk or negedge nice_rst_n) begin
+    if (!nice_rst_n) begin
+      alu_in_zp <= uint8_t'(qp_default(QP_ZP0));         // input_zp
+      alu_w_zp  <= uint8_t'(qp_default(QP_ZP0) >>> 8);   // conv1_weight_zp
+    end
+    else if (nice_req_hsked & custom3_cfg) begin
+      case (nice_req_rs2)
+        CFG_ALU_ZP: begin
+          alu_in_zp <= nice_req_rs1[7:0];
+          alu_w_zp  <= nice_req_rs1[15:8];
+        end
+        default: ;
+      endcase
+    end
+  end
+
+  int32_t alu_res;
+
+  // input:  nice_req_rs1 / nice_req_rs2
+  // output: alu_res => alu_res_r
+  always_comb begin : ALU
+    logic signed [9:0] act;
+    logic signed [9:0] wgt;
+    int32_t            acc;
+    uint8_t            max_u8;
+
+    act     = '0;
+    wgt     = '0;
+    acc     = '0;
+    max_u8  = '0;
+    alu_res = '0;
+
+    if (custom3_dot4) begin
+      // uint8 activations and int8 weights, 4 lanes of int10 x int10
+      for (int k = 0; k < 4; k++) begin
+        act = $signed({2'b00, nice_req_rs1[8*k +: 8]}) - $signed({2'b00, alu_in_zp});
+        wgt = $signed({{2{nice_req_rs2[8*k+7]}}, nice_req_rs2[8*k +: 8]}) - $signed({2'b00, alu_w_zp});
+        acc = acc + act * wgt;
+      end
+      alu_res = acc;
+    end
+    else if (custom3_max4) begin
+      // the max half of pool_u8 over one word
+      for (int k = 0; k < 4; k++) begin
+        if (uint8_t'(nice_req_rs1[8*k +: 8]) > max_u8)
+          max_u8 = nice_req_rs1[8*k +: 8];
+      end
+      alu_res = int32_t'(max_u8);
+    end
+    else if (custom3_requant) begin
+      // rs2[1:0] scale select, rs2[15:8] out zero_point, rs2[16] relu, rs2[17] act LUT
+      case (nice_req_rs2[1:0])
+        2'd0:    acc = requant(nice_req_rs1, rq_conv1);
+        2'd1:    acc = requant(nice_req_rs1, rq_conv2);
+        2'd2:    acc = requant(nice_req_rs1, rq_fc1);
+        default: acc = nice_req_rs1;
+      endcase
+      alu_res = int32_t'(act_u8(acc, nice_req_rs2[15:8], nice_req_rs2[16], nice_req_rs2[17]));
+    end
+    else if (custom3_swap) begin
+      alu_res = int32_t'(~wbank_act);
+    end
+    else if (custom3_get_prob) begin
+      if (nice_req_rs1 < FC2_OUT_WIDTH)
+        alu_res = prob_fmt_u8 ? int32_t'(prob_u8(prob_q15[nice_req_rs1])) : int32_t'(prob_q15[nice_req_rs1]);
+    end
+    else if (custom3_resume) begin
+      alu_res = -1;  // nothing parked, a parked op never gets here
+    end
+  end
+
+  int32_t alu_res_r;
+
+  always @(posedge nice_clk or negedge nice_rst_n) begin
+    if (!nice_rst_n)
+      alu_res_r <= '0;
+    else if (nice_req_hsked & custom_alu_op)
+      alu_res_r <= alu_res;
+  end
+
+  wire nice_rsp_valid_exec_alu = state_is_exec_alu;
+  assign exec_alu_done         = state_is_exec_alu & nice_rsp_hsked;
+
+
+  ////////////////////////////////////////////////////////////
+  // Scratchpad: NICE buffers on the perips ICB fabric
+  ////////////////////////////////////////////////////////////
+  // byte offset inside the 8KB window, rw = weights/input, ro = layer outputs
+  //   0x0000  conv1 weight   45 B  rw
+  //   0x0040  conv2 weight  225 B  rw
+  //   0x0140  fc1 weight    200 B  rw
+  //   0x0240  fc2 weight    100 B  rw
+  //   0x02c0  act LUT       256 B  rw
+  //   0x03c0  quant params   35 W  rw  the load_qp blob
+  //   0x0800  input         784 B  rw
+  //   0x0c00  conv1 output  720 B  ro  [ch][row][col] uint8
+  //   0x1000  conv2 output   80 W  ro  [ch][row][col] int32
+  //   0x1200  fc1 output     10 W  ro  int32
+  //   0x1280  fc2 logits     10 W  ro  int32
+  //   0x12c0  top-k        2*K W  ro  {idx, val} pairs, descending
+  //   0x1300  probability    5 W  ro  Q15, 2 per word
+  //   0x1340  status         1 W  ro  bit 0: a PE psum saturated (L_WIDTH < 32)
+  // the offsets follow from the buffer sizes, the table is the default
+  // CONV1_NUM = CONV2_NUM = 5 model; other widths move them (c/insn.h too).
+  // writes to ro or unmapped offsets answer with rsp_err.
+  // weights, LUT and quant params are those of the inactive bank, i.e. the
+  // next model after a swap.
+  // an access waits only for the FSM that owns its buffer: the input for
+  // the main FSM, the weight / LUT banks for the loader (and a swap in the
+  // same cycle), so the next model streams in while an image runs on the
+  // active bank. the ro buffers answer at any time, mid-inference too.
+  localparam CONV1_OUT_BYTES   = CONV1_NUM * CONV1_OUTPUT_SIZE;  // 720
+  localparam CONV2_OUT_WORDS   = CONV2_NUM * CONV2_OUTPUT_SIZE;  // 80
+
+  function automatic int sp_align(input int ofs, input int al);
+    return (ofs + al - 1) / al * al;
+  endfunction
+
+  localparam SP_CONV1_BASE     = 0;
+  localparam SP_CONV2_BASE     = sp_align(SP_CONV1_BASE     + CONV1_SIZE,          'h40);   // 0x0040
+  localparam SP_FC1_BASE       = sp_align(SP_CONV2_BASE     + CONV2_SIZE,          'h40);   // 0x0140
+  localparam SP_FC2_BASE       = sp_align(SP_FC1_BASE       + FC1_SIZE,            'h40);   // 0x0240
+  localparam SP_ACT_BASE       = sp_align(SP_FC2_BASE       + FC2_SIZE,            'h40);   // 0x02c0
+  localparam SP_QP_BASE        = sp_align(SP_ACT_BASE       + ACT_SIZE,            'h40);   // 0x03c0
+  localparam SP_INPUT_BASE     = sp_align(SP_QP_BASE        + QP_SIZE,             'h800);  // 0x0800
+  localparam SP_CONV1_OUT_BASE = sp_align(SP_INPUT_BASE     + INPUT_BYTES,         'h400);  // 0x0c00
+  localparam SP_CONV2_OUT_BASE = sp_align(SP_CONV1_OUT_BASE + CONV1_OUT_BYTES,     'h400);  // 0x1000
+  localparam SP_FC1_OUT_BASE   = sp_align(SP_CONV2_OUT_BASE + 4 * CONV2_OUT_WORDS, 'h200);  // 0x1200
+  localparam SP_LOGIT_BASE     = sp_align(SP_FC1_OUT_BASE   + 4 * FC1_OUT_WIDTH,   'h80);   // 0x1280
+  localparam SP_TOPK_BASE      = sp_align(SP_LOGIT_BASE     + 4 * FC2_OUT_WIDTH,   'h40);   // 0x12c0
+  localparam SP_PROB_BASE      = sp_align(SP_TOPK_BASE      + 8 * TOPK,            'h40);   // 0x1300
+  localparam SP_STAT_BASE      = sp_align(SP_PROB_BASE      + 4 * PROB_WORDS,      'h40);   // 0x1340
+  localparam SP_END            = SP_STAT_BASE + 4;
+
+  if (SP_END > (1 << SP_AW)) begin : SP_AW_CHECK
+    $error("NICE scratchpad map needs %0d bytes, SP_AW too small", SP_END);
+  end
+
+  // Constant connection, no resource consumption
+  uint8_t conv1_output_sp [CONV1_OUT_BYTES];
+  int32_t conv2_output_sp [CONV2_OUT_WORDS];
+
+  generate
+    for (genvar n = 0; n < CONV1_NUM; n++) begin
+      for (genvar r = 0; r < CONV1_OUTPUT_WIDTH; r++) begin
+        for (genvar c = 0; c < CONV1_OUTPUT_WIDTH; c++) begin
+          assign conv1_output_sp[n * CONV1_OUTPUT_SIZE + r * CONV1_OUTPUT_WIDTH + c] = conv1_output_reg[n][r][c];
+        end
+      end
+    end
+    for (genvar n = 0; n < CONV2_NUM; n++) begin
+      for (genvar r = 0; r < CONV2_OUTPUT_WIDTH; r++) begin
+        for (genvar c = 0; c < CONV2_OUTPUT_WIDTH; c++) begin
+          assign conv2_output_sp[n * CONV2_OUTPUT_SIZE + r * CONV2_OUTPUT_WIDTH + c] = conv2_output_reg[n][r][c];
+        end
+      end
+    end
+  endgenerate
+
+  wire [SP_AW-1:0] sp_ofs = {nice_sp_icb_cmd_addr[SP_AW-1:2], 2'b00};
+
+  wire sp_sel_conv1     = (sp_ofs <  SP_CONV1_BASE + CONV1_SIZE);
+  wire sp_sel_conv2     = (sp_ofs >= SP_CONV2_BASE) && (sp_ofs < SP_CONV2_BASE + CONV2_SIZE);
+  wire sp_sel_fc1       = (sp_ofs >= SP_FC1_BASE)   && (sp_ofs < SP_FC1_BASE + FC1_SIZE);
+  wire sp_sel_fc2       = (sp_ofs >= SP_FC2_BASE)   && (sp_ofs < SP_FC2_BASE + FC2_SIZE);
+  wire sp_sel_act       = (sp_ofs >= SP_ACT_BASE)   && (sp_ofs < SP_ACT_BASE + ACT_SIZE);
+  wire sp_sel_qp        = (sp_ofs >= SP_QP_BASE)    && (sp_ofs < SP_QP_BASE + QP_SIZE);
+  wire sp_sel_input     = (sp_ofs >= SP_INPUT_BASE) && (sp_ofs < SP_INPUT_BASE + INPUT_BYTES);
+  wire sp_sel_conv1_out = (sp_ofs >= SP_CONV1_OUT_BASE) && (sp_ofs < SP_CONV1_OUT_BASE + CONV1_OUT_BYTES);
+  wire sp_sel_conv2_out = (sp_ofs >= SP_CONV2_OUT_BASE) && (sp_ofs < SP_CONV2_OUT_BASE + 4*CONV2_OUT_WORDS);
+  wire sp_sel_fc1_out   = (sp_ofs >= SP_FC1_OUT_BASE)   && (sp_ofs < SP_FC1_OUT_BASE + 4*FC1_OUT_WIDTH);
+  wire sp_sel_logit     = (sp_ofs >= SP_LOGIT_BASE)     && (sp_ofs < SP_LOGIT_BASE + 4*FC2_OUT_WIDTH);
+  wire sp_sel_topk      = (sp_ofs >= SP_TOPK_BASE)      && (sp_ofs < SP_TOPK_BASE + 8*TOPK);
+  wire sp_sel_prob      = (sp_ofs >= SP_PROB_BASE)      && (sp_ofs < SP_PROB_BASE + 4*PROB_WORDS);
+  wire sp_sel_stat      = (sp_ofs == SP_STAT_BASE);
+
+  wire sp_sel_rw        = sp_sel_conv1 | sp_sel_conv2 | sp_sel_fc1 | sp_sel_fc2 | sp_sel_act |
+                          sp_sel_qp    | sp_sel_input;
+  wire sp_sel_ro        = sp_sel_conv1_out | sp_sel_conv2_out | sp_sel_fc1_out |
+                          sp_sel_logit     | sp_sel_topk      | sp_sel_prob | sp_sel_stat;
+
+  // one access in flight, the response is registered
+  reg                  sp_rsp_valid_r;
+  reg                  sp_rsp_err_r;
+  reg [`E203_XLEN-1:0] sp_rsp_rdata_r;
+
+  wire sp_sel_wbank     = sp_sel_conv1 | sp_sel_conv2 | sp_sel_fc1 | sp_sel_fc2 | sp_sel_act |
+                          sp_sel_qp;
+  wire sp_buf_free      = sp_sel_input ? state_is_idle :
+                          sp_sel_wbank ? (wl_state_is_idle & ~(nice_req_valid & custom3_swap)) : 1'b1;
+
+  assign nice_sp_icb_cmd_ready = sp_buf_free & (~sp_rsp_valid_r | nice_sp_icb_rsp_ready);
+
+  wire sp_icb_cmd_hsked = nice_sp_icb_cmd_valid & nice_sp_icb_cmd_ready;
+  wire sp_icb_wr        = sp_icb_cmd_hsked & ~nice_sp_icb_cmd_read;
+  wire sp_icb_rd        = sp_icb_cmd_hsked &  nice_sp_icb_cmd_read;
+
+  assign sp_wr_conv1 = sp_icb_wr & sp_sel_conv1;
+  assign sp_wr_conv2 = sp_icb_wr & sp_sel_conv2;
+  assign sp_wr_fc1   = sp_icb_wr & sp_sel_fc1;
+  assign sp_wr_fc2   = sp_icb_wr & sp_sel_fc2;
+  assign sp_wr_act   = sp_icb_wr & sp_sel_act;
+  assign sp_wr_qp    = sp_icb_wr & sp_sel_qp;
+  assign sp_wr_input = sp_icb_wr & sp_sel_input;
+
+  assign sp_wr_idx   = sp_sel_conv2 ? (sp_ofs - SP_CONV2_BASE) :
+                       sp_sel_fc1   ? (sp_ofs - SP_FC1_BASE)   :
+                       sp_sel_fc2   ? (sp_ofs - SP_FC2_BASE)   :
+                       sp_sel_act   ? (sp_ofs - SP_ACT_BASE)   :
+                       sp_sel_qp    ? (sp_ofs - SP_QP_BASE)    :
+                       sp_sel_input ? (sp_ofs - SP_INPUT_BASE) :
+                                       sp_ofs;
+
+  logic [`E203_XLEN-1:0] sp_rdata;
+
+  // read mux, bytes past the end of a buffer read as 0
+  always_comb begin : SP_READ
+    int idx;
+    sp_rdata = '0;
+    idx      = 0;
+    if (sp_sel_rw) begin
+      idx = int'(sp_wr_idx);
+      for (int b = 0; b < 4; b++) begin
+        if (sp_sel_conv1 && ((idx + b) < CONV1_SIZE))
+          sp_rdata[8*b +: 8] = conv1_weight_bank[~wbank_act][idx + b];
+        else if (sp_sel_conv2 && ((idx + b) < CONV2_SIZE))
+          sp_rdata[8*b +: 8] = conv2_weight_bank[~wbank_act][idx + b];
+        else if (sp_sel_fc1 && ((idx + b) < FC1_SIZE))
+          sp_rdata[8*b +: 8] = fc1_weight_bank[~wbank_act][idx + b];
+        else if (sp_sel_fc2 && ((idx + b) < FC2_SIZE))
+          sp_rdata[8*b +: 8] = fc2_weight_bank[~wbank_act][idx + b];
+        else if (sp_sel_act && ((idx + b) < ACT_SIZE))
+          sp_rdata[8*b +: 8] = act_lut_bank[~wbank_act][idx + b];
+        else if (sp_sel_qp)
+          sp_rdata[8*b +: 8] = qp_bank[~wbank_act][idx >> 2][8*b +: 8];
+        else if (sp_sel_input && ((idx + b) < INPUT_BYTES))
+          sp_rdata[8*b +: 8] = input_reg_flat[idx + b];
+      end
+    end
+    else if (sp_sel_conv1_out) begin
+      idx = int'(sp_ofs - SP_CONV1_OUT_BASE);
+      for (int b = 0; b < 4; b++)
+        sp_rdata[8*b +: 8] = conv1_output_sp[idx + b];
+    end
+    else if (sp_sel_conv2_out) begin
+      idx = int'(sp_ofs - SP_CONV2_OUT_BASE) >> 2;
+      sp_rdata = conv2_output_sp[idx];
+    end
+    else if (sp_sel_fc1_out) begin
+      idx = int'(sp_ofs - SP_FC1_OUT_BASE) >> 2;
+      sp_rdata = fc1_output_reg[idx];
+    end
+    else if (sp_sel_logit) begin
+      idx = int'(sp_ofs - SP_LOGIT_BASE) >> 2;
+      sp_rdata = fc2_logit[idx];
+    end
+    else if (sp_sel_topk) begin
+      idx = int'(sp_ofs - SP_TOPK_BASE) >> 2;
+      sp_rdata = idx[0] ? topk_val[idx >> 1] : topk_idx[idx >> 1];
+    end
+    else if (sp_sel_prob) begin
+      idx = int'(sp_ofs - SP_PROB_BASE) >> 2;
+      sp_rdata = {prob_q15[2*idx + 1], prob_q15[2*idx]};
+    end
+    else if (sp_sel_stat) begin
+      sp_rdata = {{(`E203_XLEN-1){1'b0}}, sa_sat_r};
+    end
+  end
+
+  always @(posedge nice_clk or negedge nice_rst_n) begin
+    if (!nice_rst_n) begin
+      sp_rsp_valid_r <= 1'b0;
+      sp_rsp_err_r   <= 1'b0;
+      sp_rsp_rdata_r <= '0;
+    end
+    else if (sp_icb_cmd_hsked) begin
+      sp_rsp_valid_r <= 1'b1;
+      sp_rsp_err_r   <= sp_icb_rd ? ~(sp_sel_rw | sp_sel_ro) : ~sp_sel_rw;
+      sp_rsp_rdata_r <= sp_icb_rd ? sp_rdata : '0;
+    end
+    else if (nice_sp_icb_rsp_ready) begin
+      sp_rsp_valid_r <= 1'b0;
+    end
+  end
+
+  assign nice_sp_icb_rsp_valid = sp_rsp_valid_r;
+  assign nice_sp_icb_rsp_rdata = sp_rsp_rdata_r;
+  assign nice_sp_icb_rsp_err   = sp_rsp_err_r;
 
 
   ////////////////////////////////////////////////////////////////
@@ -1475,20 +3797,30 @@ module e203_subsys_nice_core (
   // Generate the command handshake signal
   wire nice_icb_cmd_hsked = nice_icb_cmd_valid & nice_icb_cmd_ready;
 
+  // The first beat goes out together with the request: weight loads whenever the
+  // loader is free and LOAD_INPUT does not own the bus, the rest from IDLE.
+  wire wl_req_ok   = wl_idle & ~state_is_load_input & ~state_is_out_wb;
+  wire main_req_ok = state_is_idle & wl_idle & ~main_rsp_pend & (fc_idle | ~custom3_swap) &  // no swap under the FC engine
+                     ~(custom3_swap & conv2_xf_stale);                                      // nor before WINO_XF
+  wire mem_req_first = custom_mem_op & (custom_wl_op ? wl_req_ok : main_req_ok);
+
   // Determine individual enable signals for each operation
-  wire load_conv1_maddr_ena = (state_is_idle & custom3_load_conv1 & nice_icb_cmd_hsked) | (state_is_load_conv1 & nice_icb_cmd_hsked);
-  wire load_conv2_maddr_ena = (state_is_idle & custom3_load_conv2 & nice_icb_cmd_hsked) | (state_is_load_conv2 & nice_icb_cmd_hsked);
-  wire load_fc1_maddr_ena   = (state_is_idle & custom3_load_fc1   & nice_icb_cmd_hsked) | (state_is_load_fc1   & nice_icb_cmd_hsked);
-  wire load_fc2_maddr_ena   = (state_is_idle & custom3_load_fc2   & nice_icb_cmd_hsked) | (state_is_load_fc2   & nice_icb_cmd_hsked);
-  wire load_input_maddr_ena = (state_is_idle & custom3_load_input & nice_icb_cmd_hsked) | (state_is_load_input & nice_icb_cmd_hsked);
+  wire load_conv1_maddr_ena = (mem_req_first & custom3_load_conv1 & nice_icb_cmd_hsked) | (state_is_load_conv1 & nice_icb_cmd_hsked);
+  wire load_conv2_maddr_ena = (mem_req_first & custom3_load_conv2 & nice_icb_cmd_hsked) | (state_is_load_conv2 & nice_icb_cmd_hsked);
+  wire load_fc1_maddr_ena   = (mem_req_first & custom3_load_fc1   & nice_icb_cmd_hsked) | (state_is_load_fc1   & nice_icb_cmd_hsked);
+  wire load_fc2_maddr_ena   = (mem_req_first & custom3_load_fc2   & nice_icb_cmd_hsked) | (state_is_load_fc2   & nice_icb_cmd_hsked);
+  wire load_act_maddr_ena   = (mem_req_first & custom3_load_act   & nice_icb_cmd_hsked) | (state_is_load_act   & nice_icb_cmd_hsked);
+  wire load_qp_maddr_ena    = (mem_req_first & custom3_load_qp    & nice_icb_cmd_hsked) | (state_is_load_qp    & nice_icb_cmd_hsked);
+  wire load_input_maddr_ena = (mem_req_first & custom_input_op    & nice_icb_cmd_hsked) | (state_is_load_input & nice_icb_cmd_hsked);
   //wire conv_start_maddr_ena = (state_is_start_conv & conv_start_cmd_store);
 
   // Combine the enable signals for the memory address update
   wire maddr_ena = load_conv1_maddr_ena | load_conv2_maddr_ena | load_fc1_maddr_ena | 
-                   load_fc2_maddr_ena   | load_input_maddr_ena;
+                   load_fc2_maddr_ena   | load_act_maddr_ena   | load_qp_maddr_ena    |
+                   load_input_maddr_ena;
 
   // When in IDLE state, use the base address from nice_req_rs1; otherwise, use the current accumulator value.
-  wire maddr_ena_idle = (maddr_ena & state_is_idle); // | conv_start_cmd_store_first;
+  wire maddr_ena_idle = (maddr_ena & mem_req_first); // | conv_start_cmd_store_first;
   wire [`E203_XLEN-1:0] maddr_acc_op1 = maddr_ena_idle ? nice_req_rs1 : 
                                         //(conv_start_cmd_store_first ? start_conv_rs1_reg : nice_req_rs1) : 
                                         maddr_acc_r;
@@ -1520,10 +3852,11 @@ module e203_subsys_nice_core (
   assign nice_req_hsked = nice_req_valid & nice_req_ready;
 
   // The NICE core can accept a request (nice_req_ready) if:
-  // 1. It is in the IDLE state, and
+  // 1. For a weight load, the weight loader is free (the main FSM may be busy);
+  //    for anything else, both FSMs are idle, and
   // 2. If the instruction involves memory operations, the memory command interface is ready;
   //    otherwise, no additional conditions are required.
-  assign nice_req_ready = state_is_idle & (custom_mem_op ? nice_icb_cmd_ready : 1'b1);
+  assign nice_req_ready = (custom_wl_op ? wl_req_ok : main_req_ok) & (custom_mem_op ? nice_icb_cmd_ready : 1'b1);
 
 
   ////////////////////////////////////////////////////////////
@@ -1540,16 +3873,24 @@ module e203_subsys_nice_core (
 
   // The NICE core provides a valid response if any of the three operations (rowsum, sbuf, lbuf)
   // signals a valid result.
-  assign nice_rsp_valid = nice_rsp_valid_load_conv1 | nice_rsp_valid_load_conv2 | nice_rsp_valid_load_fc1 | 
-                          nice_rsp_valid_load_fc2   | nice_rsp_valid_load_input;
-
-  // When in the CAL_FC2 state, the response data is result_max_idx;
+  assign nice_rsp_valid = wl_rsp_valid | nice_rsp_valid_load_input | nice_rsp_valid_exec_alu |
+                          nice_rsp_valid_out_wb | state_is_preempt;
+
+  // When in the CAL_FC2 or OUT_WB state, the response data is result_max_idx
+  // (FC_PIPE: the top class of the FC engine, also in FC_HAND / FC_WAIT);
+  // in the EXEC_ALU state, it is the registered ALU result;
+  // in the PREEMPT state, it is NICE_RESUME (-2);
+  // a held image answer (main_rsp_pend) keeps its class;
   // in other states, it is typically zero or unused here.
-  assign nice_rsp_rdat  = {`E203_XLEN{state_is_cal_fc2}} & result_max_idx;
+  assign nice_rsp_rdat  = main_rsp_pend     ? main_rsp_dat :
+                          state_is_preempt  ? {{(`E203_XLEN-2){1'b1}}, 2'b10} :
+                          state_is_exec_alu ? alu_res_r :
+                          FC_PIPE ? ({`E203_XLEN{state_is_fc_hand | state_is_fc_wait | state_is_out_wb}} & topk_idx[0]) :
+                          ({`E203_XLEN{state_is_cal_fc2 | state_is_out_wb}} & result_max_idx);
 
-  // Indicate a memory access bus error if a valid memory response indicates an error.
+  // Indicate a memory access bus error if any beat of a weight load or writeback returned an error.
   // (Optionally, an illegal-instruction check can also be included if needed.)
-  assign nice_rsp_err   = (nice_icb_rsp_hsked & nice_icb_rsp_err);
+  assign nice_rsp_err   = (wl_rsp_valid & wl_rsp_err) | (nice_rsp_valid_out_wb & wb_err);
 
 
   ////////////////////////////////////////////////////////////
@@ -1561,40 +3902,46 @@ module e203_subsys_nice_core (
 
   // Generate the memory command valid signal.
   assign nice_icb_cmd_valid =
-         (state_is_idle & nice_req_valid & custom_mem_op)
+         (nice_req_valid & mem_req_first)
          | nice_icb_cmd_valid_load_conv1
          | nice_icb_cmd_valid_load_conv2
          | nice_icb_cmd_valid_load_fc1
          | nice_icb_cmd_valid_load_fc2
-         | nice_icb_cmd_valid_load_input;
+         | nice_icb_cmd_valid_load_act
+         | nice_icb_cmd_valid_load_qp
+         | nice_icb_cmd_valid_load_input
+         | nice_icb_cmd_valid_out_wb;
 
   // Select the memory address. If in IDLE and about to start a memory operation,
   // use the base address from nice_req_rs1; otherwise, use the accumulated address.
-  assign nice_icb_cmd_addr = (state_is_idle & custom_mem_op) ? nice_req_rs1 : 
+  assign nice_icb_cmd_addr = mem_req_first ? nice_req_rs1 : 
+                             wb_icb_sel    ? wb_addr      : 
                              //(conv_start_cmd_store_first) ? start_conv_rs1_reg :
                              maddr_acc_r;
 
   // Determine whether the operation is a read or write
-  assign nice_icb_cmd_read = (state_is_idle & custom_mem_op)
-         ? (custom3_load_conv1 | custom3_load_conv2 | custom3_load_fc1 | custom3_load_fc2 | custom3_load_input) : 1'b1;
+  assign nice_icb_cmd_read = mem_req_first
+         ? (custom3_load_conv1 | custom3_load_conv2 | custom3_load_fc1 | custom3_load_fc2 | custom3_load_act |
+            custom3_load_qp    | custom_input_op) : ~wb_icb_sel;
         // : ((conv_start_maddr_ena) ? 1'b0 : 1'b1);
 
   // Select the write data when in SBUF state or about to start SBUF from IDLE.
   assign nice_icb_cmd_wdata = //conv_start_maddr_ena ? output_reg[output_cmd_num_idx][output_cmd_row_idx][output_cmd_col_idx] :
-                              {`E203_XLEN{1'b0}};
+                              wb_icb_sel ? wb_wdata : {`E203_XLEN{1'b0}};
 
   // The transaction size is fixed at word (2'b10).
   assign nice_icb_cmd_size = 2'b10;
 
   // Assert 'nice_mem_holdup' when in any multi-cycle memory state
   assign nice_mem_holdup = state_is_load_conv1 | state_is_load_conv2 | state_is_load_fc1 |
-                           state_is_load_fc2   | state_is_load_input;
+                           state_is_load_fc2   | state_is_load_act   | state_is_load_qp    |
+                           state_is_load_input | state_is_out_wb;
 
 
   ////////////////////////////////////////////////////////////
   // NICE Active Signal
   ////////////////////////////////////////////////////////////
-  assign nice_active = state_is_idle ? nice_req_valid : 1'b1;
+  assign nice_active = (main_req_ok & fc_idle) ? nice_req_valid : 1'b1;
 
   
 endmodule
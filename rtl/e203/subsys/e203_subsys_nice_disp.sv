@@ -0,0 +1,666 @@
+//=====================================================================
+//
+// Designer   : FyF
+//
+// Description:
+//  NICE dispatch unit, fans the NICE port of the E203 out to NICE_NUM
+//  instances of e203_subsys_nice_core
+//  - load_input / run (and the _wb forms) go round-robin to the next
+//    free instance and answer at once with its index, the class comes
+//    later from collect, in issue order
+//  - weight loads, cfg and swap wait for all instances to be idle and
+//    go to all of them in the same cycle. the instances then run in
+//    lockstep, only instance 0 reaches the bus and its beats are handed
+//    to all, so the weights are fetched once and every bank holds the
+//    same copy
+//  - the other ops go to the instance of the last collected image
+//  - the scratchpad window maps the instance that takes the next image
+//  - with an interrupt waiting, collect answers NICE_RESUME instead of
+//    waiting for a busy image. images run detached from the E203, only
+//    a forwarded op (fc_sync, resume) passes the interrupt to its instance
+//  memory requests share the NICE ICB through a sirv_gnrl_icb_arbt.
+//  - DTCM_PORT: the NICE ICB passes the LSU, one word in flight, and the
+//    input beats of all instances queue on it. the odd instances then
+//    take their DTCM accesses (an image in DTCM, its _wb result) to a
+//    second port on the external interface of the DTCM, so two images
+//    stream in at once, the SRAM takes a word every cycle
+//  NICE_NUM = 1 is the bare core
+//
+// ====================================================================
+`include "e203_defines.v"
+
+`ifdef E203_HAS_NICE//{
+module e203_subsys_nice_disp #(
+  parameter NICE_NUM  = 1,
+  parameter DTCM_PORT = 0,
+  parameter DTCM_BASE = 32'h9000_0000,  // DTCM window, E203_DTCM_ADDR_BASE
+  parameter DTCM_AW   = 16              // E203_DTCM_ADDR_WIDTH
+)(
+    // System
+    input                         nice_clk             ,
+    input                         nice_rst_n	         ,
+    output                        nice_active	         ,
+    output                        nice_mem_holdup	     ,
+    input                         nice_irq_req         ,  // an interrupt waits, answer long ops early
+
+    // Control cmd_req
+    input                         nice_req_valid       ,
+    output                        nice_req_ready       ,
+    input  [`E203_XLEN-1:0]       nice_req_inst        ,
+    input  [`E203_XLEN-1:0]       nice_req_rs1         ,
+    input  [`E203_XLEN-1:0]       nice_req_rs2         ,
+
+    // Control cmd_rsp
+    output                        nice_rsp_valid       ,
+    input                         nice_rsp_ready       ,
+    output [`E203_XLEN-1:0]       nice_rsp_rdat        ,
+    output                        nice_rsp_err    	   ,
+
+    // Memory lsu_req
+    output                        nice_icb_cmd_valid   ,
+    input                         nice_icb_cmd_ready   ,
+    output [`E203_ADDR_SIZE-1:0]  nice_icb_cmd_addr    ,
+    output                        nice_icb_cmd_read    ,
+    output [`E203_XLEN-1:0]       nice_icb_cmd_wdata   ,
+    output [1:0]                  nice_icb_cmd_size    ,
+
+    // Memory lsu_rsp
+    input                         nice_icb_rsp_valid   ,
+    output                        nice_icb_rsp_ready   ,
+    input  [`E203_XLEN-1:0]       nice_icb_rsp_rdata   ,
+    input                         nice_icb_rsp_err     ,
+
+    // Scratchpad icb_cmd, buffers mapped into the PPI region
+    input                         nice_sp_icb_cmd_valid,
+    output                        nice_sp_icb_cmd_ready,
+    input  [`E203_ADDR_SIZE-1:0]  nice_sp_icb_cmd_addr ,
+    input                         nice_sp_icb_cmd_read ,
+    input  [`E203_XLEN-1:0]       nice_sp_icb_cmd_wdata,
+    input  [`E203_XLEN/8-1:0]     nice_sp_icb_cmd_wmask,
+
+    // Scratchpad icb_rsp
+    output                        nice_sp_icb_rsp_valid,
+    input                         nice_sp_icb_rsp_ready,
+    output [`E203_XLEN-1:0]       nice_sp_icb_rsp_rdata,
+    output                        nice_sp_icb_rsp_err  ,
+
+    // DTCM_PORT, to the external ICB of the DTCM
+    output                        nice_dtcm_icb_cmd_valid,
+    input                         nice_dtcm_icb_cmd_ready,
+    output [`E203_ADDR_SIZE-1:0]  nice_dtcm_icb_cmd_addr ,
+    output                        nice_dtcm_icb_cmd_read ,
+    output [`E203_XLEN-1:0]       nice_dtcm_icb_cmd_wdata,
+    output [1:0]                  nice_dtcm_icb_cmd_size ,
+    input                         nice_dtcm_icb_rsp_valid,
+    output                        nice_dtcm_icb_rsp_ready,
+    input  [`E203_XLEN-1:0]       nice_dtcm_icb_rsp_rdata,
+    input                         nice_dtcm_icb_rsp_err
+
+  );
+
+  generate
+    if (NICE_NUM == 1) begin : SINGLE
+
+      e203_subsys_nice_core u_nice_core (
+        .nice_clk             (nice_clk),
+        .nice_rst_n           (nice_rst_n),
+        .nice_active          (nice_active),
+        .nice_mem_holdup      (nice_mem_holdup),
+        .nice_irq_req         (nice_irq_req),
+
+        .nice_req_valid       (nice_req_valid),
+        .nice_req_ready       (nice_req_ready),
+        .nice_req_inst        (nice_req_inst),
+        .nice_req_rs1         (nice_req_rs1),
+        .nice_req_rs2         (nice_req_rs2),
+
+        .nice_rsp_valid       (nice_rsp_valid),
+        .nice_rsp_ready       (nice_rsp_ready),
+        .nice_rsp_rdat        (nice_rsp_rdat),
+        .nice_rsp_err         (nice_rsp_err),
+
+        .nice_icb_cmd_valid   (nice_icb_cmd_valid),
+        .nice_icb_cmd_ready   (nice_icb_cmd_ready),
+        .nice_icb_cmd_addr    (nice_icb_cmd_addr),
+        .nice_icb_cmd_read    (nice_icb_cmd_read),
+        .nice_icb_cmd_wdata   (nice_icb_cmd_wdata),
+        .nice_icb_cmd_size    (nice_icb_cmd_size),
+
+        .nice_icb_rsp_valid   (nice_icb_rsp_valid),
+        .nice_icb_rsp_ready   (nice_icb_rsp_ready),
+        .nice_icb_rsp_rdata   (nice_icb_rsp_rdata),
+        .nice_icb_rsp_err     (nice_icb_rsp_err),
+
+        .nice_sp_icb_cmd_valid(nice_sp_icb_cmd_valid),
+        .nice_sp_icb_cmd_ready(nice_sp_icb_cmd_ready),
+        .nice_sp_icb_cmd_addr (nice_sp_icb_cmd_addr ),
+        .nice_sp_icb_cmd_read (nice_sp_icb_cmd_read ),
+        .nice_sp_icb_cmd_wdata(nice_sp_icb_cmd_wdata),
+        .nice_sp_icb_cmd_wmask(nice_sp_icb_cmd_wmask),
+
+        .nice_sp_icb_rsp_valid(nice_sp_icb_rsp_valid),
+        .nice_sp_icb_rsp_ready(nice_sp_icb_rsp_ready),
+        .nice_sp_icb_rsp_rdata(nice_sp_icb_rsp_rdata),
+        .nice_sp_icb_rsp_err  (nice_sp_icb_rsp_err  )
+      );
+
+      assign nice_dtcm_icb_cmd_valid = 1'b0;
+      assign nice_dtcm_icb_cmd_addr  = {`E203_ADDR_SIZE{1'b0}};
+      assign nice_dtcm_icb_cmd_read  = 1'b1;
+      assign nice_dtcm_icb_cmd_wdata = {`E203_XLEN{1'b0}};
+      assign nice_dtcm_icb_cmd_size  = 2'b10;
+      assign nice_dtcm_icb_rsp_ready = 1'b1;
+
+    end
+    else begin : MULTI
+
+      localparam PW = $clog2(NICE_NUM);
+
+      // image slot of an instance
+      localparam ST_FREE = 2'd0;
+      localparam ST_BUSY = 2'd1;  // image running
+      localparam ST_DONE = 2'd2;  // class waiting for collect
+
+      // pending response to the E203, one request at a time
+      localparam R_NONE    = 3'd0;
+      localparam R_TICKET  = 3'd1;  // image op, rd = instance
+      localparam R_FWD     = 3'd2;  // answer of instance rsp_inst
+      localparam R_BCAST   = 3'd3;  // answer of all instances
+      localparam R_COLLECT = 3'd4;  // class of the oldest image
+
+      localparam RESUME    = -2;    // rd of an op cut short by an interrupt, as the core
+
+      ////////////////////////////////////////////////////////////
+      // decode, same encodings as e203_subsys_nice_core
+      ////////////////////////////////////////////////////////////
+      wire [6:0] opcode = nice_req_inst[6:0];
+      wire [2:0] func3  = nice_req_inst[14:12];
+      wire [6:0] func7  = nice_req_inst[31:25];
+
+      wire custom3    = (opcode == 7'b1111011);
+      wire op_wl      = custom3 && (func3 == 3'b010) && (((func7 >= 7'b0001011) && (func7 <= 7'b0001110)) ||
+                                                      (func7 == 7'b0011100) ||  // load_conv1..fc2, load_act
+                                                      (func7 == 7'b0011110));   // load_qp
+      wire op_image   = custom3 && (((func3 == 3'b110) && (func7 == 7'b0001111)) ||   // load_input
+                                    ((func3 == 3'b100) && (func7 == 7'b0010100)) ||   // run
+                                    ((func3 == 3'b111) && (func7 == 7'b0010110)) ||   // load_input_wb
+                                    ((func3 == 3'b111) && (func7 == 7'b0011101)) ||   // load_frame
+                                    ((func3 == 3'b101) && (func7 == 7'b0010111)));    // run_wb
+      wire op_bcast   = op_wl || (custom3 && (((func3 == 3'b011) && (func7 == 7'b0010011)) ||   // cfg
+                                              ((func3 == 3'b100) && (func7 == 7'b0010101))));   // swap
+      // rd = class of the oldest image in flight, -1 when there is none
+      wire op_collect = custom3 && (func3 == 3'b100) && (func7 == 7'b0011010);
+
+      ////////////////////////////////////////////////////////////
+      // instances
+      ////////////////////////////////////////////////////////////
+      logic                        inst_active       [NICE_NUM];
+      logic                        inst_holdup       [NICE_NUM];
+      logic                        inst_irq_req      [NICE_NUM];
+      logic                        inst_req_valid    [NICE_NUM];
+      logic                        inst_req_ready    [NICE_NUM];
+      logic                        inst_rsp_valid    [NICE_NUM];
+      logic                        inst_rsp_ready    [NICE_NUM];
+      logic [`E203_XLEN-1:0]       inst_rsp_rdat     [NICE_NUM];
+      logic                        inst_rsp_err      [NICE_NUM];
+      logic                        inst_cmd_valid    [NICE_NUM];
+      logic                        inst_cmd_ready    [NICE_NUM];
+      logic [`E203_ADDR_SIZE-1:0]  inst_cmd_addr     [NICE_NUM];
+      logic                        inst_cmd_read     [NICE_NUM];
+      logic [`E203_XLEN-1:0]       inst_cmd_wdata    [NICE_NUM];
+      logic [1:0]                  inst_cmd_size     [NICE_NUM];
+      logic                        inst_icb_rsp_valid[NICE_NUM];
+      logic                        inst_icb_rsp_ready[NICE_NUM];
+      logic [`E203_XLEN-1:0]       inst_icb_rsp_rdata[NICE_NUM];
+      logic                        inst_icb_rsp_err  [NICE_NUM];
+      logic                        inst_sp_cmd_valid [NICE_NUM];
+      logic                        inst_sp_cmd_ready [NICE_NUM];
+      logic                        inst_sp_rsp_valid [NICE_NUM];
+      logic                        inst_sp_rsp_ready [NICE_NUM];
+      logic [`E203_XLEN-1:0]       inst_sp_rsp_rdata [NICE_NUM];
+      logic                        inst_sp_rsp_err   [NICE_NUM];
+
+      for (genvar k = 0; k < NICE_NUM; k++) begin : NICE
+        e203_subsys_nice_core u_nice_core (
+          .nice_clk             (nice_clk),
+          .nice_rst_n           (nice_rst_n),
+          .nice_active          (inst_active[k]),
+          .nice_mem_holdup      (inst_holdup[k]),
+          .nice_irq_req         (inst_irq_req[k]),
+
+          .nice_req_valid       (inst_req_valid[k]),
+          .nice_req_ready       (inst_req_ready[k]),
+          .nice_req_inst        (nice_req_inst),
+          .nice_req_rs1         (nice_req_rs1),
+          .nice_req_rs2         (nice_req_rs2),
+
+          .nice_rsp_valid       (inst_rsp_valid[k]),
+          .nice_rsp_ready       (inst_rsp_ready[k]),
+          .nice_rsp_rdat        (inst_rsp_rdat[k]),
+          .nice_rsp_err         (inst_rsp_err[k]),
+
+          .nice_icb_cmd_valid   (inst_cmd_valid[k]),
+          .nice_icb_cmd_ready   (inst_cmd_ready[k]),
+          .nice_icb_cmd_addr    (inst_cmd_addr[k]),
+          .nice_icb_cmd_read    (inst_cmd_read[k]),
+          .nice_icb_cmd_wdata   (inst_cmd_wdata[k]),
+          .nice_icb_cmd_size    (inst_cmd_size[k]),
+
+          .nice_icb_rsp_valid   (inst_icb_rsp_valid[k]),
+          .nice_icb_rsp_ready   (inst_icb_rsp_ready[k]),
+          .nice_icb_rsp_rdata   (inst_icb_rsp_rdata[k]),
+          .nice_icb_rsp_err     (inst_icb_rsp_err[k]),
+
+          .nice_sp_icb_cmd_valid(inst_sp_cmd_valid[k]),
+          .nice_sp_icb_cmd_ready(inst_sp_cmd_ready[k]),
+          .nice_sp_icb_cmd_addr (nice_sp_icb_cmd_addr ),
+          .nice_sp_icb_cmd_read (nice_sp_icb_cmd_read ),
+          .nice_sp_icb_cmd_wdata(nice_sp_icb_cmd_wdata),
+          .nice_sp_icb_cmd_wmask(nice_sp_icb_cmd_wmask),
+
+          .nice_sp_icb_rsp_valid(inst_sp_rsp_valid[k]),
+          .nice_sp_icb_rsp_ready(inst_sp_rsp_ready[k]),
+          .nice_sp_icb_rsp_rdata(inst_sp_rsp_rdata[k]),
+          .nice_sp_icb_rsp_err  (inst_sp_rsp_err[k]  )
+        );
+      end
+
+      ////////////////////////////////////////////////////////////
+      // dispatch
+      ////////////////////////////////////////////////////////////
+      logic [1:0]            st      [NICE_NUM];
+      logic [`E203_XLEN-1:0] res     [NICE_NUM];
+      logic                  res_err [NICE_NUM];
+      logic [PW-1:0]         head;      // oldest image in flight
+      logic [PW-1:0]         tail;      // instance of the next image
+      logic [PW-1:0]         last;      // instance of the last collected image
+      logic [2:0]            rsp_sel;
+      logic [PW-1:0]         rsp_inst;
+      logic                  bc_go;     // all instances idle, the broadcast goes out
+      logic                  bc_wl;     // broadcast weight load in flight
+
+      wire disp_free = (rsp_sel == R_NONE);
+
+      // with no request in front of it an instance is ready only when idle.
+      // the broadcast checks that one cycle ahead, idle instances stay idle
+      logic all_idle;
+      logic all_rsp;
+      logic any_err;
+
+      always_comb begin
+        all_idle = 1'b1;
+        all_rsp  = 1'b1;
+        any_err  = 1'b0;
+        for (int k = 0; k < NICE_NUM; k++) begin
+          all_idle = all_idle & inst_req_ready[k] & (st[k] != ST_BUSY);
+          all_rsp  = all_rsp & inst_rsp_valid[k];
+          any_err  = any_err | inst_rsp_err[k];
+        end
+      end
+
+      wire req_image   = nice_req_valid & disp_free & op_image;
+      wire req_bcast   = nice_req_valid & disp_free & op_bcast & bc_go;
+      wire req_collect = nice_req_valid & disp_free & op_collect;
+      wire req_fwd     = nice_req_valid & disp_free & ~op_image & ~op_bcast & ~op_collect;
+
+      always_comb begin
+        for (int k = 0; k < NICE_NUM; k++)
+          inst_req_valid[k] = req_bcast | (req_image & (tail == k) & (st[k] == ST_FREE)) | (req_fwd & (last == k));
+      end
+
+      // at most NICE_NUM images in flight, an image op waits for its slot to be collected
+      assign nice_req_ready = disp_free & (op_image   ? ((st[tail] == ST_FREE) & inst_req_ready[tail]) :
+                                           op_bcast   ? (bc_go & inst_req_ready[0]) :
+                                           op_collect ? 1'b1 :
+                                                        inst_req_ready[last]);
+
+      wire nice_req_hsked = nice_req_valid & nice_req_ready;
+
+      assign nice_rsp_valid = (rsp_sel == R_TICKET) |
+                              ((rsp_sel == R_FWD) & inst_rsp_valid[rsp_inst]) |
+                              ((rsp_sel == R_BCAST) & all_rsp) |
+                              ((rsp_sel == R_COLLECT) & ((st[head] != ST_BUSY) | nice_irq_req));
+
+      assign nice_rsp_rdat  = (rsp_sel == R_TICKET)  ? `E203_XLEN'(rsp_inst) :
+                              (rsp_sel == R_FWD)     ? inst_rsp_rdat[rsp_inst] :
+                              (rsp_sel == R_BCAST)   ? inst_rsp_rdat[0] :
+                              (st[head] == ST_DONE)  ? res[head] :
+                              (st[head] == ST_BUSY)  ? `E203_XLEN'(RESUME) : {`E203_XLEN{1'b1}};
+
+      assign nice_rsp_err   = ((rsp_sel == R_FWD) & inst_rsp_err[rsp_inst]) |
+                              ((rsp_sel == R_BCAST) & any_err) |
+                              ((rsp_sel == R_COLLECT) & (st[head] == ST_DONE) & res_err[head]);
+
+      wire nice_rsp_hsked = nice_rsp_valid & nice_rsp_ready;
+
+      always_comb begin
+        for (int k = 0; k < NICE_NUM; k++)
+          inst_irq_req[k] = nice_irq_req & (rsp_sel == R_FWD) & (rsp_inst == k);
+      end
+
+      // a running image answers into its slot
+      always_comb begin
+        for (int k = 0; k < NICE_NUM; k++)
+          inst_rsp_ready[k] = (st[k] == ST_BUSY) |
+                              ((rsp_sel == R_FWD) & (rsp_inst == k) & nice_rsp_ready) |
+                              ((rsp_sel == R_BCAST) & all_rsp & nice_rsp_ready);
+      end
+
+      always @(posedge nice_clk or negedge nice_rst_n) begin
+        if (!nice_rst_n) begin
+          st       <= '{default: ST_FREE};
+          res      <= '{default: '0};
+          res_err  <= '{default: 1'b0};
+          head     <= '0;
+          tail     <= '0;
+          last     <= '0;
+          rsp_sel  <= R_NONE;
+          rsp_inst <= '0;
+          bc_go    <= 1'b0;
+          bc_wl    <= 1'b0;
+        end
+        else begin
+          for (int k = 0; k < NICE_NUM; k++) begin
+            if ((st[k] == ST_BUSY) & inst_rsp_valid[k]) begin
+              st[k]      <= ST_DONE;
+              res[k]     <= inst_rsp_rdat[k];
+              res_err[k] <= inst_rsp_err[k];
+            end
+          end
+
+          if (~bc_go & nice_req_valid & disp_free & op_bcast & all_idle)
+            bc_go <= 1'b1;
+          else if (nice_req_hsked)
+            bc_go <= 1'b0;
+
+          if (nice_req_hsked) begin
+            if (op_image) begin
+              st[tail] <= ST_BUSY;
+              rsp_sel  <= R_TICKET;
+              rsp_inst <= tail;
+              tail     <= (tail == NICE_NUM - 1) ? '0 : (tail + 1'b1);
+            end
+            else if (op_bcast) begin
+              rsp_sel  <= R_BCAST;
+              bc_wl    <= op_wl;
+            end
+            else if (op_collect) begin
+              rsp_sel  <= R_COLLECT;
+            end
+            else begin
+              rsp_sel  <= R_FWD;
+              rsp_inst <= last;
+            end
+          end
+          else if (nice_rsp_hsked) begin
+            rsp_sel <= R_NONE;
+            bc_wl   <= 1'b0;
+            if ((rsp_sel == R_COLLECT) & (st[head] == ST_DONE)) begin
+              st[head] <= ST_FREE;
+              last     <= head;
+              head     <= (head == NICE_NUM - 1) ? '0 : (head + 1'b1);
+            end
+          end
+        end
+      end
+
+      ////////////////////////////////////////////////////////////
+      // memory, a broadcast load puts instance 0 on the bus
+      ////////////////////////////////////////////////////////////
+      wire bc_mem = bc_wl | (req_bcast & op_wl);
+
+      // DTCM_PORT: a command of an odd instance into the DTCM window goes
+      // to the DTCM port. an instance waits for each answer, the pend
+      // flags only keep a command off one port while the other still
+      // owes its answer, and tell which port that answer comes from
+      logic [NICE_NUM-1:0] to_dtcm;
+      logic [NICE_NUM-1:0] pend_main;
+      logic [NICE_NUM-1:0] pend_dtcm;
+
+      always_comb begin
+        for (int k = 0; k < NICE_NUM; k++)
+          to_dtcm[k] = (DTCM_PORT != 0) & (k % 2 == 1) & ~bc_mem &
+                       ((inst_cmd_addr[k] >> DTCM_AW) == (DTCM_BASE >> DTCM_AW));
+      end
+
+      wire [NICE_NUM-1:0]                 arbt_cmd_valid;
+      wire [NICE_NUM-1:0]                 arbt_cmd_ready;
+      wire [NICE_NUM-1:0]                 arbt_cmd_read;
+      wire [NICE_NUM*`E203_ADDR_SIZE-1:0] arbt_cmd_addr;
+      wire [NICE_NUM*`E203_XLEN-1:0]      arbt_cmd_wdata;
+      wire [NICE_NUM*2-1:0]               arbt_cmd_size;
+      wire [NICE_NUM-1:0]                 arbt_rsp_valid;
+      wire [NICE_NUM-1:0]                 arbt_rsp_ready;
+      wire [NICE_NUM-1:0]                 arbt_rsp_err;
+      wire [NICE_NUM*`E203_XLEN-1:0]      arbt_rsp_rdata;
+
+      wire [NICE_NUM-1:0]                 dtcm_cmd_valid;
+      wire [NICE_NUM-1:0]                 dtcm_cmd_ready;
+      wire [NICE_NUM-1:0]                 dtcm_rsp_valid;
+      wire [NICE_NUM-1:0]                 dtcm_rsp_ready;
+      wire [NICE_NUM-1:0]                 dtcm_rsp_err;
+      wire [NICE_NUM*`E203_XLEN-1:0]      dtcm_rsp_rdata;
+
+      for (genvar k = 0; k < NICE_NUM; k++) begin : ICB
+        assign arbt_cmd_valid[k]                                    = inst_cmd_valid[k] & ~(bc_mem & (k != 0)) &
+                                                                      ~to_dtcm[k] & ~pend_dtcm[k];
+        assign arbt_cmd_read[k]                                     = inst_cmd_read[k];
+        assign arbt_cmd_addr[k*`E203_ADDR_SIZE +: `E203_ADDR_SIZE]  = inst_cmd_addr[k];
+        assign arbt_cmd_wdata[k*`E203_XLEN +: `E203_XLEN]           = inst_cmd_wdata[k];
+        assign arbt_cmd_size[k*2 +: 2]                              = inst_cmd_size[k];
+        assign arbt_rsp_ready[k]                                    = inst_icb_rsp_ready[k] & ~pend_dtcm[k];
+
+        assign dtcm_cmd_valid[k]                                    = inst_cmd_valid[k] & to_dtcm[k] & ~pend_main[k];
+        assign dtcm_rsp_ready[k]                                    = inst_icb_rsp_ready[k] & pend_dtcm[k];
+
+        // in a broadcast load every instance listens to port 0
+        assign inst_cmd_ready[k]     = bc_mem     ? arbt_cmd_ready[0] :
+                                       to_dtcm[k] ? (dtcm_cmd_ready[k] & ~pend_main[k]) :
+                                                    (arbt_cmd_ready[k] & ~pend_dtcm[k]);
+        assign inst_icb_rsp_valid[k] = bc_mem       ? arbt_rsp_valid[0] :
+                                       pend_dtcm[k] ? dtcm_rsp_valid[k] : arbt_rsp_valid[k];
+        assign inst_icb_rsp_rdata[k] = bc_mem       ? arbt_rsp_rdata[0 +: `E203_XLEN] :
+                                       pend_dtcm[k] ? dtcm_rsp_rdata[k*`E203_XLEN +: `E203_XLEN] :
+                                                      arbt_rsp_rdata[k*`E203_XLEN +: `E203_XLEN];
+        assign inst_icb_rsp_err[k]   = bc_mem       ? arbt_rsp_err[0] :
+                                       pend_dtcm[k] ? dtcm_rsp_err[k] : arbt_rsp_err[k];
+
+        always @(posedge nice_clk or negedge nice_rst_n) begin
+          if (!nice_rst_n) begin
+            pend_main[k] <= 1'b0;
+            pend_dtcm[k] <= 1'b0;
+          end
+          else begin
+            if (arbt_cmd_valid[k] & arbt_cmd_ready[k])
+              pend_main[k] <= 1'b1;
+            else if (arbt_rsp_valid[k] & arbt_rsp_ready[k])
+              pend_main[k] <= 1'b0;
+            if (dtcm_cmd_valid[k] & dtcm_cmd_ready[k])
+              pend_dtcm[k] <= 1'b1;
+            else if (dtcm_rsp_valid[k] & dtcm_rsp_ready[k])
+              pend_dtcm[k] <= 1'b0;
+          end
+        end
+      end
+
+      sirv_gnrl_icb_arbt # (
+        .ARBT_SCHEME     (1),  // round-robin
+        .ALLOW_0CYCL_RSP (0),
+        .FIFO_OUTS_NUM   (`E203_LSU_OUTS_NUM),
+        .FIFO_CUT_READY  (0),
+        .ARBT_NUM        (NICE_NUM),
+        .ARBT_PTR_W      (PW),
+        .USR_W           (1),
+        .AW              (`E203_ADDR_SIZE),
+        .DW              (`E203_XLEN)
+      ) u_nice_icb_arbt (
+        .o_icb_cmd_valid        (nice_icb_cmd_valid),
+        .o_icb_cmd_ready        (nice_icb_cmd_ready),
+        .o_icb_cmd_read         (nice_icb_cmd_read),
+        .o_icb_cmd_addr         (nice_icb_cmd_addr),
+        .o_icb_cmd_wdata        (nice_icb_cmd_wdata),
+        .o_icb_cmd_wmask        (),
+        .o_icb_cmd_burst        (),
+        .o_icb_cmd_beat         (),
+        .o_icb_cmd_excl         (),
+        .o_icb_cmd_lock         (),
+        .o_icb_cmd_size         (nice_icb_cmd_size),
+        .o_icb_cmd_usr          (),
+
+        .o_icb_rsp_valid        (nice_icb_rsp_valid),
+        .o_icb_rsp_ready        (nice_icb_rsp_ready),
+        .o_icb_rsp_err          (nice_icb_rsp_err),
+        .o_icb_rsp_excl_ok      (1'b0),
+        .o_icb_rsp_rdata        (nice_icb_rsp_rdata),
+        .o_icb_rsp_usr          (1'b0),
+
+        .i_bus_icb_cmd_ready    (arbt_cmd_ready),
+        .i_bus_icb_cmd_valid    (arbt_cmd_valid),
+        .i_bus_icb_cmd_read     (arbt_cmd_read),
+        .i_bus_icb_cmd_addr     (arbt_cmd_addr),
+        .i_bus_icb_cmd_wdata    (arbt_cmd_wdata),
+        .i_bus_icb_cmd_wmask    ({NICE_NUM*`E203_XLEN/8{1'b1}}),
+        .i_bus_icb_cmd_burst    ({NICE_NUM*2{1'b0}}),
+        .i_bus_icb_cmd_beat     ({NICE_NUM*2{1'b0}}),
+        .i_bus_icb_cmd_excl     ({NICE_NUM{1'b0}}),
+        .i_bus_icb_cmd_lock     ({NICE_NUM{1'b0}}),
+        .i_bus_icb_cmd_size     (arbt_cmd_size),
+        .i_bus_icb_cmd_usr      ({NICE_NUM{1'b0}}),
+
+        .i_bus_icb_rsp_valid    (arbt_rsp_valid),
+        .i_bus_icb_rsp_ready    (arbt_rsp_ready),
+        .i_bus_icb_rsp_err      (arbt_rsp_err),
+        .i_bus_icb_rsp_excl_ok  (),
+        .i_bus_icb_rsp_rdata    (arbt_rsp_rdata),
+        .i_bus_icb_rsp_usr      (),
+
+        .clk                    (nice_clk),
+        .rst_n                  (nice_rst_n)
+      );
+
+      if (DTCM_PORT != 0) begin : DTCM
+        sirv_gnrl_icb_arbt # (
+          .ARBT_SCHEME     (1),  // round-robin
+          .ALLOW_0CYCL_RSP (0),
+          .FIFO_OUTS_NUM   (1),
+          .FIFO_CUT_READY  (0),
+          .ARBT_NUM        (NICE_NUM),
+          .ARBT_PTR_W      (PW),
+          .USR_W           (1),
+          .AW              (`E203_ADDR_SIZE),
+          .DW              (`E203_XLEN)
+        ) u_nice_dtcm_arbt (
+          .o_icb_cmd_valid        (nice_dtcm_icb_cmd_valid),
+          .o_icb_cmd_ready        (nice_dtcm_icb_cmd_ready),
+          .o_icb_cmd_read         (nice_dtcm_icb_cmd_read),
+          .o_icb_cmd_addr         (nice_dtcm_icb_cmd_addr),
+          .o_icb_cmd_wdata        (nice_dtcm_icb_cmd_wdata),
+          .o_icb_cmd_wmask        (),
+          .o_icb_cmd_burst        (),
+          .o_icb_cmd_beat         (),
+          .o_icb_cmd_excl         (),
+          .o_icb_cmd_lock         (),
+          .o_icb_cmd_size         (nice_dtcm_icb_cmd_size),
+          .o_icb_cmd_usr          (),
+
+          .o_icb_rsp_valid        (nice_dtcm_icb_rsp_valid),
+          .o_icb_rsp_ready        (nice_dtcm_icb_rsp_ready),
+          .o_icb_rsp_err          (nice_dtcm_icb_rsp_err),
+          .o_icb_rsp_excl_ok      (1'b0),
+          .o_icb_rsp_rdata        (nice_dtcm_icb_rsp_rdata),
+          .o_icb_rsp_usr          (1'b0),
+
+          .i_bus_icb_cmd_ready    (dtcm_cmd_ready),
+          .i_bus_icb_cmd_valid    (dtcm_cmd_valid),
+          .i_bus_icb_cmd_read     (arbt_cmd_read),
+          .i_bus_icb_cmd_addr     (arbt_cmd_addr),
+          .i_bus_icb_cmd_wdata    (arbt_cmd_wdata),
+          .i_bus_icb_cmd_wmask    ({NICE_NUM*`E203_XLEN/8{1'b1}}),
+          .i_bus_icb_cmd_burst    ({NICE_NUM*2{1'b0}}),
+          .i_bus_icb_cmd_beat     ({NICE_NUM*2{1'b0}}),
+          .i_bus_icb_cmd_excl     ({NICE_NUM{1'b0}}),
+          .i_bus_icb_cmd_lock     ({NICE_NUM{1'b0}}),
+          .i_bus_icb_cmd_size     (arbt_cmd_size),
+          .i_bus_icb_cmd_usr      ({NICE_NUM{1'b0}}),
+
+          .i_bus_icb_rsp_valid    (dtcm_rsp_valid),
+          .i_bus_icb_rsp_ready    (dtcm_rsp_ready),
+          .i_bus_icb_rsp_err      (dtcm_rsp_err),
+          .i_bus_icb_rsp_excl_ok  (),
+          .i_bus_icb_rsp_rdata    (dtcm_rsp_rdata),
+          .i_bus_icb_rsp_usr      (),
+
+          .clk                    (nice_clk),
+          .rst_n                  (nice_rst_n)
+        );
+      end
+      else begin : NO_DTCM
+        assign dtcm_cmd_ready          = '0;
+        assign dtcm_rsp_valid          = '0;
+        assign dtcm_rsp_err            = '0;
+        assign dtcm_rsp_rdata          = '0;
+
+        assign nice_dtcm_icb_cmd_valid = 1'b0;
+        assign nice_dtcm_icb_cmd_addr  = {`E203_ADDR_SIZE{1'b0}};
+        assign nice_dtcm_icb_cmd_read  = 1'b1;
+        assign nice_dtcm_icb_cmd_wdata = {`E203_XLEN{1'b0}};
+        assign nice_dtcm_icb_cmd_size  = 2'b10;
+        assign nice_dtcm_icb_rsp_ready = 1'b1;
+      end
+
+      ////////////////////////////////////////////////////////////
+      // scratchpad, one access at a time so the answer comes from
+      // the instance that took the command
+      ////////////////////////////////////////////////////////////
+      logic [PW-1:0] sp_sel;
+      logic          sp_pend;
+
+      always_comb begin
+        for (int k = 0; k < NICE_NUM; k++) begin
+          inst_sp_cmd_valid[k] = nice_sp_icb_cmd_valid & ~sp_pend & (tail == k);
+          inst_sp_rsp_ready[k] = nice_sp_icb_rsp_ready & (sp_sel == k);
+        end
+      end
+
+      assign nice_sp_icb_cmd_ready = ~sp_pend & inst_sp_cmd_ready[tail];
+      assign nice_sp_icb_rsp_valid = sp_pend & inst_sp_rsp_valid[sp_sel];
+      assign nice_sp_icb_rsp_rdata = inst_sp_rsp_rdata[sp_sel];
+      assign nice_sp_icb_rsp_err   = inst_sp_rsp_err[sp_sel];
+
+      always @(posedge nice_clk or negedge nice_rst_n) begin
+        if (!nice_rst_n) begin
+          sp_sel  <= '0;
+          sp_pend <= 1'b0;
+        end
+        else if (nice_sp_icb_cmd_valid & nice_sp_icb_cmd_ready) begin
+          sp_sel  <= tail;
+          sp_pend <= 1'b1;
+        end
+        else if (nice_sp_icb_rsp_valid & nice_sp_icb_rsp_ready) begin
+          sp_pend <= 1'b0;
+        end
+      end
+
+      ////////////////////////////////////////////////////////////
+      // status
+      ////////////////////////////////////////////////////////////
+      logic any_active;
+      logic any_holdup;
+
+      always_comb begin
+        any_active = 1'b0;
+        any_holdup = 1'b0;
+        for (int k = 0; k < NICE_NUM; k++) begin
+          any_active = any_active | inst_active[k];
+          any_holdup = any_holdup | inst_holdup[k];
+        end
+      end
+
+      assign nice_active     = any_active | ~disp_free | bc_go | nice_req_valid;
+      assign nice_mem_holdup = any_holdup;
+
+    end
+  endgenerate
+
+endmodule
+`endif//}
@@ -41,6 +41,21 @@ module e203_subsys_perips(
   output                         ppi_icb_rsp_err,
   output [`E203_XLEN-1:0]        ppi_icb_rsp_rdata,
   
+  `ifdef E203_HAS_NICE//{
+  //////////////////////////////////////////////////////////
+  output                         nice_sp_icb_cmd_valid,
+  input                          nice_sp_icb_cmd_ready,
+  output [`E203_ADDR_SIZE-1:0]   nice_sp_icb_cmd_addr, 
+  output                         nice_sp_icb_cmd_read, 
+  output [`E203_XLEN-1:0]        nice_sp_icb_cmd_wdata,
+  output [`E203_XLEN/8-1:0]      nice_sp_icb_cmd_wmask,
+  //
+  input                          nice_sp_icb_rsp_valid,
+  output                         nice_sp_icb_rsp_ready,
+  input                          nice_sp_icb_rsp_err,
+  input  [`E203_XLEN-1:0]        nice_sp_icb_rsp_rdata,
+  `endif//}
+
   //////////////////////////////////////////////////////////
   output                         sysper_icb_cmd_valid,
   input                          sysper_icb_cmd_ready,
@@ -398,9 +413,9 @@ module e203_subsys_perips(
   .O14_BASE_ADDR       (32'h1004_1000),       
   .O14_BASE_REGION_LSB (12),
   
-  // * Reserved 
+  // * NICE Scratchpad : 0x1004 2000 -- 0x1004 3FFF
   .O15_BASE_ADDR       (32'h1004_2000),       
-  .O15_BASE_REGION_LSB (3)
+  .O15_BASE_REGION_LSB (13)
 
   )u_sirv_ppi_fab(
 
@@ -741,7 +756,28 @@ module e203_subsys_perips(
     .o14_icb_rsp_rdata  (expl_axi_icb_rsp_rdata),
 
 
-   //  *      
+   //  * NICE Scratchpad
+  `ifdef E203_HAS_NICE//{
+    .o15_icb_enable     (1'b1),
+
+    .o15_icb_cmd_valid  (nice_sp_icb_cmd_valid),
+    .o15_icb_cmd_ready  (nice_sp_icb_cmd_ready),
+    .o15_icb_cmd_addr   (nice_sp_icb_cmd_addr ),
+    .o15_icb_cmd_read   (nice_sp_icb_cmd_read ),
+    .o15_icb_cmd_wdata  (nice_sp_icb_cmd_wdata),
+    .o15_icb_cmd_wmask  (nice_sp_icb_cmd_wmask),
+    .o15_icb_cmd_lock   (),
+    .o15_icb_cmd_excl   (),
+    .o15_icb_cmd_size   (),
+    .o15_icb_cmd_burst  (),
+    .o15_icb_cmd_beat   (),
+    
+    .o15_icb_rsp_valid  (nice_sp_icb_rsp_valid),
+    .o15_icb_rsp_ready  (nice_sp_icb_rsp_ready),
+    .o15_icb_rsp_err    (nice_sp_icb_rsp_err  ),
+    .o15_icb_rsp_excl_ok(1'b0),
+    .o15_icb_rsp_rdata  (nice_sp_icb_rsp_rdata),
+  `else//}{
     .o15_icb_enable     (1'b0),
 
     .o15_icb_cmd_valid  (),
@@ -761,6 +797,7 @@ module e203_subsys_perips(
     .o15_icb_rsp_err    (1'b0),
     .o15_icb_rsp_excl_ok(1'b0),
     .o15_icb_rsp_rdata  (32'b0),
+  `endif//}
 
     .clk           (clk  ),
     .rst_n         (bus_rst_n) 
@@ -33,6 +33,7 @@ module e203_subsys_pll(
 
   input  pllrefclk, // The reference clock into PLL
   output plloutclk, // The PLL generated clock
+  output pllniceclk, // The NICE accelerator clock, 2x plloutclk
 
   input        pll_RESET,
   input [1:0]  pll_OD,
@@ -49,5 +50,10 @@ module e203_subsys_pll(
   `endif//}
 
   assign plloutclk = pllout;
+
+  // Second output for the NICE accelerator (E203_CFG_NICE_CLK_ASYNC),
+  //   set it to 2x the core clock in the real PLL. In FPGA take another
+  //   output of the MMCM, the model just passes the reference clock
+  assign pllniceclk = pllrefclk;
 endmodule
 
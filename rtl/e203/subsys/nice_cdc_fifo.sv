@@ -0,0 +1,88 @@
+//=====================================================================
+//
+// Designer   : FyF
+//
+// Description:
+//  Asynchronous FIFO between the E203 clock and the NICE clock
+//  Gray-coded pointers cross through sirv_gnrl_sync, the data stays
+//  in the FIFO until the write pointer has been seen on the read side.
+//  Valid/ready on both sides, one push and one pop per cycle, so a
+//  stream crosses at full rate once the sync latency is paid
+//
+// ====================================================================
+
+module nice_cdc_fifo #(
+  parameter int DW      = 32,
+  parameter int AW      = 2,          // 2**AW entries
+  parameter int SYNC_DP = 2
+)(
+  // write side
+  input  logic                wclk,
+  input  logic                wrst_n,
+  input  logic                i_vld,
+  output logic                i_rdy,
+  input  logic [DW-1:0]       i_dat,
+
+  // read side
+  input  logic                rclk,
+  input  logic                rrst_n,
+  output logic                o_vld,
+  input  logic                o_rdy,
+  output logic [DW-1:0]       o_dat
+);
+
+  logic [DW-1:0] mem [2**AW];
+
+  logic [AW:0]   wptr, wgray, rgray_w;   // write side
+  logic [AW:0]   rptr, rgray, wgray_r;   // read side
+
+  wire  [AW:0]   wptr_nxt = wptr + 1'b1;
+  wire  [AW:0]   rptr_nxt = rptr + 1'b1;
+
+  sirv_gnrl_sync #(.DP(SYNC_DP), .DW(AW+1)) u_rgray_sync (
+    .din_a (rgray),
+    .dout  (rgray_w),
+    .clk   (wclk),
+    .rst_n (wrst_n)
+  );
+
+  sirv_gnrl_sync #(.DP(SYNC_DP), .DW(AW+1)) u_wgray_sync (
+    .din_a (wgray),
+    .dout  (wgray_r),
+    .clk   (rclk),
+    .rst_n (rrst_n)
+  );
+
+  // full: the write pointer is one lap ahead of the read pointer
+  assign i_rdy = (wgray != (rgray_w ^ {2'b11, {(AW-1){1'b0}}}));
+  assign o_vld = (rgray != wgray_r);
+  assign o_dat = mem[rptr[AW-1:0]];
+
+  always_ff @(posedge wclk or negedge wrst_n) begin
+    if (!wrst_n) begin
+      wptr  <= '0;
+      wgray <= '0;
+    end
+    else if (i_vld & i_rdy) begin
+      wptr  <= wptr_nxt;
+      wgray <= wptr_nxt ^ (wptr_nxt >> 1);
+    end
+  end
+
+  always_ff @(posedge wclk) begin
+    if (i_vld & i_rdy)
+      mem[wptr[AW-1:0]] <= i_dat;
+  end
+
+  always_ff @(posedge rclk or negedge rrst_n) begin
+    if (!rrst_n) begin
+      rptr  <= '0;
+      rgray <= '0;
+    end
+    else if (o_vld & o_rdy) begin
+      rptr  <= rptr_nxt;
+      rgray <= rptr_nxt ^ (rptr_nxt >> 1);
+    end
+  end
+
+endmodule
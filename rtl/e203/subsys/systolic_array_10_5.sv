@@ -4,7 +4,11 @@
 //
 // Description:
 //  The Module to realize a 10 * 5 Systolic Array
-//  Mul width: int9   Add width: int32
+//  Mul width: int9 (A_WIDTH x W_WIDTH)   Add width: int32 (L_WIDTH)
+//  L_WIDTH < 32 narrows the PE accumulators, psums saturate there
+//  and raise sat; data_down is sign-extended back to int32
+//  COL_IN: with col_in up every column takes its own row inputs from
+//  data_col on en_left, in step with column 0 (depthwise passes)
 //
 // ====================================================================
 
@@ -13,14 +17,21 @@ module systolic_array_10_5 #(
     parameter int L_WIDTH    = 32,
     parameter int S_WIDTH    = 8,
     parameter int ROWS       = 10,
-    parameter int COLS       = 5
+    parameter int COLS       = 5,
+    parameter int A_WIDTH    = 9,
+    parameter int W_WIDTH    = 9,
+    parameter int W4_PACK    = 0,
+    parameter int COL_IN     = 0
 )(
     // Clock and reset
     input  logic                         clk,
     input  logic                         rst_n,
 
     input  logic        [ROWS-1:0]       en_left,
-    input  logic signed [8:0]            data_left [ROWS], // int9
+    input  logic signed [A_WIDTH-1:0]    data_left [ROWS], // int9
+
+    input  logic                         col_in,           // COL_IN: data_col instead of the left neighbour
+    input  logic signed [A_WIDTH-1:0]    data_col  [ROWS][COLS],
 
     input  logic        [COLS-1:0]       en_up,
     input  logic signed [31:0]           data_up   [COLS], // int32
@@ -28,6 +39,9 @@ module systolic_array_10_5 #(
     output logic        [COLS-1:0]       en_down,
     output logic signed [31:0]           data_down [COLS], // int32
 
+    input  logic                         w4,               // int4 weight pass
+    output logic                         sat,              // a PE saturated its psum
+
     input  logic                         mode      [ROWS][COLS]
 );
 
@@ -45,7 +59,13 @@ module systolic_array_10_5 #(
 
     // Horizontal connections: dimension is [0..ROWS-1] in row, [0..COLS] in column
     logic        [ROWS-1:0][0:COLS]                 en_horz;
-    logic signed [ROWS-1:0][0:COLS][8:0]            data_horz; // int9
+    logic signed [ROWS-1:0][0:COLS][A_WIDTH-1:0]    data_horz; // int9
+
+    logic        [ROWS-1:0][COLS-1:0]               sat_pe;
+
+    // left input of each PE, the neighbour or with col_in its own data_col
+    logic        [ROWS-1:0][COLS-1:0]               en_pe;
+    logic signed [ROWS-1:0][COLS-1:0][A_WIDTH-1:0]  data_pe;
 
     // --------------------------------------------------------------------------------
     // Connect the left boundary with en_left/data_left.
@@ -55,12 +75,19 @@ module systolic_array_10_5 #(
         assign data_horz[i][0] = data_left[i];
     end
 
+    for (genvar i = 0; i < ROWS; i++) begin
+        for (genvar j = 0; j < COLS; j++) begin
+            assign en_pe[i][j]   = (COL_IN && col_in) ? en_left[i]     : en_horz[i][j];
+            assign data_pe[i][j] = (COL_IN && col_in) ? data_col[i][j] : data_horz[i][j];
+        end
+    end
+
     // --------------------------------------------------------------------------------
     // Connect the upper boundary with en_up/data_up.
     // --------------------------------------------------------------------------------
     for (genvar j = 0; j < COLS; j++) begin
         assign en_vert[0][j]   = en_up[j];
-        assign data_vert[0][j] = data_up[j];
+        assign data_vert[0][j] = data_up[j][L_WIDTH-1:0];
     end
 
     // --------------------------------------------------------------------------------
@@ -68,9 +95,11 @@ module systolic_array_10_5 #(
     // --------------------------------------------------------------------------------
     for (genvar j = 0; j < COLS; j++) begin : DOWN_CONNECT
         assign en_down[j]    = en_vert[ROWS][j];
-        assign data_down[j]  = data_vert[ROWS][j];
+        assign data_down[j]  = $signed(data_vert[ROWS][j]);
     end
 
+    assign sat = |sat_pe;
+
     // --------------------------------------------------------------------------------
     // Generate the systolic array of ROWS×COLS Processing Elements (PE).
     // For the last column (j=COLS-1), instantiate PE_r, which has no right output.
@@ -80,16 +109,22 @@ module systolic_array_10_5 #(
             if (j < COLS-1) begin
                 PE #(
                     .L_WIDTH(L_WIDTH),
-                    .S_WIDTH(S_WIDTH)
+                    .S_WIDTH(S_WIDTH),
+                    .A_WIDTH(A_WIDTH),
+                    .W_WIDTH(W_WIDTH),
+                    .W4_PACK(W4_PACK)
                 ) pe_inst (
                     .PE_clk       (clk),
                     .PE_rst_n     (rst_n),
                     .PE_mode      (mode[i][j]),
+                    .PE_w4        (w4),
 
                     .PE_en_up     (en_vert  [i][j]),
                     .PE_data_up   (data_vert[i][j]),
-                    .PE_en_left   (en_horz  [i][j]),
-                    .PE_data_left (data_horz[i][j]),
+                    .PE_en_left   (en_pe    [i][j]),
+                    .PE_data_left (data_pe  [i][j]),
+
+                    .PE_sat       (sat_pe   [i][j]),
 
                     .PE_en_right  (en_horz  [i][j+1]),
                     .PE_data_right(data_horz[i][j+1]),
@@ -100,16 +135,21 @@ module systolic_array_10_5 #(
             else begin
                 PE_r #(
                     .L_WIDTH(L_WIDTH),
-                    .S_WIDTH(S_WIDTH)
+                    .S_WIDTH(S_WIDTH),
+                    .A_WIDTH(A_WIDTH),
+                    .W_WIDTH(W_WIDTH),
+                    .W4_PACK(W4_PACK)
                 ) pe_r_inst (
                     .PE_clk       (clk),
                     .PE_rst_n     (rst_n),
                     .PE_mode      (mode[i][j]),
+                    .PE_w4        (w4),
 
                     .PE_en_up     (en_vert  [i][j]),
                     .PE_data_up   (data_vert[i][j]),
-                    .PE_en_left   (en_horz  [i][j]),
-                    .PE_data_left (data_horz[i][j]),
+                    .PE_en_left   (en_pe    [i][j]),
+                    .PE_data_left (data_pe  [i][j]),
+                    .PE_sat       (sat_pe   [i][j]),
 
                     .PE_en_down   (en_vert  [i+1][j]),
                     .PE_data_down (data_vert[i+1][j])
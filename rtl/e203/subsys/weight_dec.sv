@@ -0,0 +1,118 @@
+//=====================================================================
+//
+// Designer   : FyF
+//
+// Description:
+//  sparse bitmap decoder on the weight load path of the NICE core
+//  A blob is one header word {8'd0, fill[7:0], len[15:0]} and len bytes
+//  of payload, packed 4 per beat. The payload is a bitmap byte per group
+//  of 8 weights (bit j set: weight j of the group is not fill) followed
+//  by its non-fill weights in order. The header beat fills the whole
+//  bank, every payload beat then writes up to 4 weights
+//
+// ====================================================================
+
+module weight_dec #(
+  parameter int AW = 16               // weight index width
+)(
+  // system
+  input  logic                clk,
+  input  logic                rst_n,
+
+  // control
+  input  logic                clear,            // end of the load
+  input  logic                beat,             // response beat of a compressed load
+  input  logic [31:0]         rdata,
+
+  // header
+  output logic                hdr,              // this beat is the header
+  output logic [7:0]          fill,             // its fill byte, valid with hdr
+  output int                  beats,            // load_convX_cnt limit of the blob
+
+  // weight writes of this beat
+  output logic                wr      [4],
+  output logic [AW-1:0]       wr_idx  [4],
+  output logic [7:0]          wr_val  [4]
+);
+
+  logic          hdr_ok;     // header seen
+  logic [15:0]   left;       // payload bytes not decoded yet
+  logic [7:0]    mask;       // weights of the current group still to come
+  logic [AW-1:0] cur;        // first weight of the current group
+  logic [AW-1:0] grp;        // first weight of the next group
+
+  logic [15:0]   left_n;
+  logic [7:0]    mask_n;
+  logic [AW-1:0] cur_n, grp_n;
+
+  assign hdr  = beat & ~hdr_ok;
+  assign fill = rdata[23:16];
+
+  // one byte after the other, a bitmap byte opens the next group,
+  // a literal goes to the lowest weight still set in the bitmap
+  always_comb begin : DECODE
+    left_n = left;
+    mask_n = mask;
+    cur_n  = cur;
+    grp_n  = grp;
+
+    for (int j = 0; j < 4; j++) begin
+      logic [7:0] byte_j;
+      int         pos;
+
+      byte_j    = rdata[8*j +: 8];
+      pos       = 0;
+      wr[j]     = 1'b0;
+      wr_idx[j] = '0;
+      wr_val[j] = byte_j;
+
+      if (beat && hdr_ok && (left_n != 0)) begin
+        left_n = left_n - 1'b1;
+        if (mask_n == 0) begin
+          mask_n = byte_j;
+          cur_n  = grp_n;
+          grp_n  = grp_n + AW'(8);
+        end
+        else begin
+          for (int p = 7; p >= 0; p--)
+            if (mask_n[p])
+              pos = p;
+          wr[j]     = 1'b1;
+          wr_idx[j] = cur_n + AW'(pos);
+          mask_n    = mask_n & (mask_n - 1'b1);
+        end
+      end
+    end
+  end
+
+  always_ff @(posedge clk or negedge rst_n) begin
+    if (!rst_n) begin
+      hdr_ok <= 1'b0;
+      left   <= '0;
+      mask   <= '0;
+      cur    <= '0;
+      grp    <= '0;
+      beats  <= 1;
+    end
+    else if (clear) begin
+      hdr_ok <= 1'b0;
+      left   <= '0;
+      mask   <= '0;
+      cur    <= '0;
+      grp    <= '0;
+      beats  <= 1;
+    end
+    else if (hdr) begin
+      hdr_ok <= 1'b1;
+      left   <= rdata[15:0];
+      beats  <= 1 + (int'(rdata[15:0]) + 3) / 4;
+    end
+    else if (beat) begin
+      left   <= left_n;
+      mask   <= mask_n;
+      cur    <= cur_n;
+      grp    <= grp_n;
+    end
+  end
+
+endmodule
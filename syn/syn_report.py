@@ -0,0 +1,27 @@
+import re
+import sys
+
+# cell count and logic depth of a yosys run of syn/Makefile
+#
+#   python syn/syn_report.py run/<tag> "<params>"
+
+
+def parse(run):
+    stat = open(run + ".stat").read()
+    ltp = open(run + ".ltp").read()
+    cells = int(re.findall(r"Number of cells:\s+(\d+)", stat)[-1])
+    dffs = sum(int(n) for n in re.findall(r"\$_\w*DFF\w*_\s+(\d+)", stat))
+    depth = int(re.findall(r"\(length=(\d+)\)", ltp)[-1])
+    return {"cells": cells, "dffs": dffs, "depth": depth}
+
+
+def main():
+    run, params = sys.argv[1], sys.argv[2]
+    res = parse(run)
+    print("params: %s" % (params or "default"))
+    for key in ("cells", "dffs", "depth"):
+        print("%s: %d" % (key, res[key]))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,255 @@
+`timescale 1ns/1ps
+`include "e203_defines.v"
+
+// batch throughput of e203_subsys_nice_disp, run with NICE_NUM = 1, 2, 4
+// and DTCM_PORT = 0, 1 (the images sit in DTCM, the second port is a
+// second memory port on the same array)
+//   iverilog -g2012 -P tb_nice_disp.NICE_NUM=2 -P tb_nice_disp.DTCM_PORT=1 ...
+// python/cycle_model.py dispatch() gives the expected cycles/image
+module tb_nice_disp;
+
+  parameter NICE_NUM = 2;
+  parameter BATCH    = 16;
+  parameter MEM_LAT  = 1;     // ICB response latency, cycles
+  parameter DTCM_PORT = 0;
+
+  localparam W_CONV1 = 32'h0000_0000;
+  localparam W_CONV2 = 32'h0000_0100;
+  localparam W_FC1   = 32'h0000_0200;
+  localparam W_FC2   = 32'h0000_0400;
+  localparam IMAGE   = 32'h9000_1000;   // BATCH images of 784 bytes, in DTCM
+
+  reg                          clk;
+  reg                          rst_n;
+
+  reg                          nice_req_valid;
+  wire                         nice_req_ready;
+  reg  [`E203_XLEN-1:0]        nice_req_inst;
+  reg  [`E203_XLEN-1:0]        nice_req_rs1;
+  reg  [`E203_XLEN-1:0]        nice_req_rs2;
+  wire                         nice_rsp_valid;
+  wire [`E203_XLEN-1:0]        nice_rsp_rdat;
+  wire                         nice_rsp_err;
+
+  wire                         nice_icb_cmd_valid;
+  wire [`E203_ADDR_SIZE-1:0]   nice_icb_cmd_addr;
+  wire                         nice_icb_cmd_read;
+  wire [`E203_XLEN-1:0]        nice_icb_cmd_wdata;
+  wire [1:0]                   nice_icb_cmd_size;
+  wire                         nice_icb_rsp_ready;
+
+  wire                         nice_sp_icb_cmd_ready;
+  wire                         nice_sp_icb_rsp_valid;
+  wire [`E203_XLEN-1:0]        nice_sp_icb_rsp_rdata;
+  wire                         nice_sp_icb_rsp_err;
+
+  ////////////////////////////////////////////////////////////
+  // memory, one outstanding read, MEM_LAT cycles
+  ////////////////////////////////////////////////////////////
+  reg  [31:0]                  mem [0:16383];
+  reg                          icb_busy;
+  reg  [7:0]                   icb_wait;
+  reg  [31:0]                  icb_addr;
+  reg  [31:0]                  beats;
+
+  wire                         icb_cmd_ready = ~icb_busy;
+  wire                         icb_rsp_valid = icb_busy & (icb_wait == 0);
+  wire [31:0]                  icb_rsp_rdata = mem[icb_addr[15:2]];
+
+  wire                         dtcm_cmd_valid;
+  wire [`E203_ADDR_SIZE-1:0]   dtcm_cmd_addr;
+  wire                         dtcm_rsp_ready;
+  reg                          dtcm_busy;
+  reg  [7:0]                   dtcm_wait;
+  reg  [31:0]                  dtcm_addr;
+
+  wire                         dtcm_cmd_ready = ~dtcm_busy;
+  wire                         dtcm_rsp_valid = dtcm_busy & (dtcm_wait == 0);
+  wire [31:0]                  dtcm_rsp_rdata = mem[dtcm_addr[15:2]];
+
+  e203_subsys_nice_disp #(
+    .NICE_NUM             (NICE_NUM),
+    .DTCM_PORT            (DTCM_PORT)
+  ) u_nice_disp (
+    .nice_clk             (clk),
+    .nice_rst_n           (rst_n),
+    .nice_active          (),
+    .nice_mem_holdup      (),
+    .nice_irq_req         (1'b0),
+
+    .nice_req_valid       (nice_req_valid),
+    .nice_req_ready       (nice_req_ready),
+    .nice_req_inst        (nice_req_inst),
+    .nice_req_rs1         (nice_req_rs1),
+    .nice_req_rs2         (nice_req_rs2),
+
+    .nice_rsp_valid       (nice_rsp_valid),
+    .nice_rsp_ready       (1'b1),
+    .nice_rsp_rdat        (nice_rsp_rdat),
+    .nice_rsp_err         (nice_rsp_err),
+
+    .nice_icb_cmd_valid   (nice_icb_cmd_valid),
+    .nice_icb_cmd_ready   (icb_cmd_ready),
+    .nice_icb_cmd_addr    (nice_icb_cmd_addr),
+    .nice_icb_cmd_read    (nice_icb_cmd_read),
+    .nice_icb_cmd_wdata   (nice_icb_cmd_wdata),
+    .nice_icb_cmd_size    (nice_icb_cmd_size),
+
+    .nice_icb_rsp_valid   (icb_rsp_valid),
+    .nice_icb_rsp_ready   (nice_icb_rsp_ready),
+    .nice_icb_rsp_rdata   (icb_rsp_rdata),
+    .nice_icb_rsp_err     (1'b0),
+
+    .nice_sp_icb_cmd_valid(1'b0),
+    .nice_sp_icb_cmd_ready(nice_sp_icb_cmd_ready),
+    .nice_sp_icb_cmd_addr ({`E203_ADDR_SIZE{1'b0}}),
+    .nice_sp_icb_cmd_read (1'b1),
+    .nice_sp_icb_cmd_wdata({`E203_XLEN{1'b0}}),
+    .nice_sp_icb_cmd_wmask({`E203_XLEN/8{1'b0}}),
+
+    .nice_sp_icb_rsp_valid(nice_sp_icb_rsp_valid),
+    .nice_sp_icb_rsp_ready(1'b1),
+    .nice_sp_icb_rsp_rdata(nice_sp_icb_rsp_rdata),
+    .nice_sp_icb_rsp_err  (nice_sp_icb_rsp_err  ),
+
+    .nice_dtcm_icb_cmd_valid(dtcm_cmd_valid),
+    .nice_dtcm_icb_cmd_ready(dtcm_cmd_ready),
+    .nice_dtcm_icb_cmd_addr (dtcm_cmd_addr),
+    .nice_dtcm_icb_cmd_read (),
+    .nice_dtcm_icb_cmd_wdata(),
+    .nice_dtcm_icb_cmd_size (),
+    .nice_dtcm_icb_rsp_valid(dtcm_rsp_valid),
+    .nice_dtcm_icb_rsp_ready(dtcm_rsp_ready),
+    .nice_dtcm_icb_rsp_rdata(dtcm_rsp_rdata),
+    .nice_dtcm_icb_rsp_err  (1'b0)
+  );
+
+  always @(posedge clk or negedge rst_n) begin
+    if (!rst_n) begin
+      icb_busy <= 1'b0;
+      icb_wait <= 0;
+      icb_addr <= 0;
+      beats    <= 0;
+    end
+    else begin
+      if (nice_icb_cmd_valid & icb_cmd_ready) begin
+        icb_busy <= 1'b1;
+        icb_wait <= MEM_LAT - 1;
+        icb_addr <= nice_icb_cmd_addr;
+      end
+      else if (icb_rsp_valid & nice_icb_rsp_ready) begin
+        icb_busy <= 1'b0;
+      end
+      else if (icb_busy & (icb_wait != 0)) begin
+        icb_wait <= icb_wait - 1;
+      end
+      beats <= beats + (nice_icb_cmd_valid & icb_cmd_ready) + (dtcm_cmd_valid & dtcm_cmd_ready);
+    end
+  end
+
+  // second port of the same array, as the DTCM external interface
+  always @(posedge clk or negedge rst_n) begin
+    if (!rst_n) begin
+      dtcm_busy <= 1'b0;
+      dtcm_wait <= 0;
+      dtcm_addr <= 0;
+    end
+    else if (dtcm_cmd_valid & dtcm_cmd_ready) begin
+      dtcm_busy <= 1'b1;
+      dtcm_wait <= MEM_LAT - 1;
+      dtcm_addr <= dtcm_cmd_addr;
+    end
+    else if (dtcm_rsp_valid & dtcm_rsp_ready) begin
+      dtcm_busy <= 1'b0;
+    end
+    else if (dtcm_busy & (dtcm_wait != 0)) begin
+      dtcm_wait <= dtcm_wait - 1;
+    end
+  end
+
+  ////////////////////////////////////////////////////////////
+  // E203 side, one request at a time like the NICE port
+  ////////////////////////////////////////////////////////////
+  reg  [31:0]                  cycle;
+
+  always @(posedge clk or negedge rst_n) begin
+    if (!rst_n) cycle <= 0;
+    else        cycle <= cycle + 1;
+  end
+
+  // .insn r 0x7b, func3, func7, x10, x11, x12
+  function [31:0] insn;
+    input [2:0] func3;
+    input [6:0] func7;
+    insn = {func7, 5'd12, 5'd11, func3, 5'd10, 7'b1111011};
+  endfunction
+
+  task nice_op;
+    input  [31:0] inst;
+    input  [31:0] rs1;
+    output [31:0] rd;
+    begin
+      @(negedge clk);
+      nice_req_valid = 1'b1;
+      nice_req_inst  = inst;
+      nice_req_rs1   = rs1;
+      nice_req_rs2   = 0;
+      #1;
+      while (!nice_req_ready) @(negedge clk);
+      @(negedge clk);
+      nice_req_valid = 1'b0;
+      while (!nice_rsp_valid) @(negedge clk);
+      rd = nice_rsp_rdat;
+    end
+  endtask
+
+  initial begin
+    clk = 0;
+    forever #5 clk = ~clk;
+  end
+
+  integer i, t0, b0;
+  reg [31:0] rd;
+
+  initial begin
+    for (i = 0; i < 16384; i = i + 1)
+      mem[i] = (i * 32'h9e3779b1) ^ (i >> 3);
+
+    rst_n          = 0;
+    nice_req_valid = 0;
+    nice_req_inst  = 0;
+    nice_req_rs1   = 0;
+    nice_req_rs2   = 0;
+    #100 rst_n = 1;
+
+    nice_op(insn(3'b010, 7'd11), W_CONV1, rd);
+    nice_op(insn(3'b010, 7'd12), W_CONV2, rd);
+    nice_op(insn(3'b010, 7'd13), W_FC1,   rd);
+    nice_op(insn(3'b010, 7'd14), W_FC2,   rd);
+    nice_op(insn(3'b100, 7'd21), 0,       rd);
+
+    t0 = cycle;
+    b0 = beats;
+    for (i = 0; i < BATCH + NICE_NUM; i = i + 1) begin
+      if (NICE_NUM == 1) begin
+        if (i < BATCH) begin
+          nice_op(insn(3'b110, 7'd15), IMAGE + i * 784, rd);
+          $display("image %0d: class %0d", i, rd);
+        end
+      end
+      else begin
+        if (i >= NICE_NUM && i - NICE_NUM < BATCH) begin
+          nice_op(insn(3'b100, 7'd26), 0, rd);
+          $display("image %0d: class %0d", i - NICE_NUM, rd);
+        end
+        if (i < BATCH)
+          nice_op(insn(3'b110, 7'd15), IMAGE + i * 784, rd);
+      end
+    end
+
+    $display("NICE_NUM = %0d, DTCM_PORT = %0d: %0d images, %0d cycles, %0d cycles/image, %0d bus beats",
+             NICE_NUM, DTCM_PORT, BATCH, cycle - t0, (cycle - t0) / BATCH, beats - b0);
+    $finish;
+  end
+
+endmodule
@@ -0,0 +1,215 @@
+`timescale 1ns/1ps
+`include "e203_defines.v"
+
+// PREEMPT with writeback: a load_input_wb image is parked by an interrupt,
+// the ISR issues fc_sync, custom_resume finishes the image. its class and
+// result struct must match the same image run without the interrupt
+//   iverilog -g2012 -P tb_nice_preempt.MEM_LAT=1 ...
+module tb_nice_preempt;
+
+  parameter MEM_LAT  = 1;     // ICB response latency, cycles
+
+  localparam W_CONV1 = 32'h0000_0000;
+  localparam W_CONV2 = 32'h0000_0100;
+  localparam W_FC1   = 32'h0000_0200;
+  localparam W_FC2   = 32'h0000_0400;
+  localparam IMAGE   = 32'h0000_1000;
+  localparam OUT_A   = 32'h0000_2000;   // result struct, uninterrupted run
+  localparam OUT_B   = 32'h0000_2100;   // result struct, preempted run
+  localparam OUT_W   = 21;              // nice_result_t words
+
+  localparam RESUME  = 32'hffff_fffe;   // NICE_RESUME
+
+  reg                          clk;
+  reg                          rst_n;
+  reg                          irq_req;
+
+  reg                          nice_req_valid;
+  wire                         nice_req_ready;
+  reg  [`E203_XLEN-1:0]        nice_req_inst;
+  reg  [`E203_XLEN-1:0]        nice_req_rs1;
+  reg  [`E203_XLEN-1:0]        nice_req_rs2;
+  wire                         nice_rsp_valid;
+  wire [`E203_XLEN-1:0]        nice_rsp_rdat;
+  wire                         nice_rsp_err;
+
+  wire                         nice_icb_cmd_valid;
+  wire [`E203_ADDR_SIZE-1:0]   nice_icb_cmd_addr;
+  wire                         nice_icb_cmd_read;
+  wire [`E203_XLEN-1:0]        nice_icb_cmd_wdata;
+  wire [1:0]                   nice_icb_cmd_size;
+  wire                         nice_icb_rsp_ready;
+
+  wire                         nice_sp_icb_cmd_ready;
+  wire                         nice_sp_icb_rsp_valid;
+  wire [`E203_XLEN-1:0]        nice_sp_icb_rsp_rdata;
+  wire                         nice_sp_icb_rsp_err;
+
+  ////////////////////////////////////////////////////////////
+  // memory, one outstanding access, MEM_LAT cycles
+  ////////////////////////////////////////////////////////////
+  reg  [31:0]                  mem [0:16383];
+  reg                          icb_busy;
+  reg  [7:0]                   icb_wait;
+  reg  [31:0]                  icb_addr;
+
+  wire                         icb_cmd_ready = ~icb_busy;
+  wire                         icb_rsp_valid = icb_busy & (icb_wait == 0);
+  wire [31:0]                  icb_rsp_rdata = mem[icb_addr[15:2]];
+
+  e203_subsys_nice_core u_nice_core (
+    .nice_clk             (clk),
+    .nice_rst_n           (rst_n),
+    .nice_active          (),
+    .nice_mem_holdup      (),
+    .nice_irq_req         (irq_req),
+
+    .nice_req_valid       (nice_req_valid),
+    .nice_req_ready       (nice_req_ready),
+    .nice_req_inst        (nice_req_inst),
+    .nice_req_rs1         (nice_req_rs1),
+    .nice_req_rs2         (nice_req_rs2),
+
+    .nice_rsp_valid       (nice_rsp_valid),
+    .nice_rsp_ready       (1'b1),
+    .nice_rsp_rdat        (nice_rsp_rdat),
+    .nice_rsp_err         (nice_rsp_err),
+
+    .nice_icb_cmd_valid   (nice_icb_cmd_valid),
+    .nice_icb_cmd_ready   (icb_cmd_ready),
+    .nice_icb_cmd_addr    (nice_icb_cmd_addr),
+    .nice_icb_cmd_read    (nice_icb_cmd_read),
+    .nice_icb_cmd_wdata   (nice_icb_cmd_wdata),
+    .nice_icb_cmd_size    (nice_icb_cmd_size),
+
+    .nice_icb_rsp_valid   (icb_rsp_valid),
+    .nice_icb_rsp_ready   (nice_icb_rsp_ready),
+    .nice_icb_rsp_rdata   (icb_rsp_rdata),
+    .nice_icb_rsp_err     (1'b0),
+
+    .nice_sp_icb_cmd_valid(1'b0),
+    .nice_sp_icb_cmd_ready(nice_sp_icb_cmd_ready),
+    .nice_sp_icb_cmd_addr ({`E203_ADDR_SIZE{1'b0}}),
+    .nice_sp_icb_cmd_read (1'b1),
+    .nice_sp_icb_cmd_wdata({`E203_XLEN{1'b0}}),
+    .nice_sp_icb_cmd_wmask({`E203_XLEN/8{1'b0}}),
+
+    .nice_sp_icb_rsp_valid(nice_sp_icb_rsp_valid),
+    .nice_sp_icb_rsp_ready(1'b1),
+    .nice_sp_icb_rsp_rdata(nice_sp_icb_rsp_rdata),
+    .nice_sp_icb_rsp_err  (nice_sp_icb_rsp_err  )
+  );
+
+  always @(posedge clk or negedge rst_n) begin
+    if (!rst_n) begin
+      icb_busy <= 1'b0;
+      icb_wait <= 0;
+      icb_addr <= 0;
+    end
+    else if (nice_icb_cmd_valid & icb_cmd_ready) begin
+      icb_busy <= 1'b1;
+      icb_wait <= MEM_LAT - 1;
+      icb_addr <= nice_icb_cmd_addr;
+      if (!nice_icb_cmd_read)
+        mem[nice_icb_cmd_addr[15:2]] <= nice_icb_cmd_wdata;
+    end
+    else if (icb_rsp_valid & nice_icb_rsp_ready) begin
+      icb_busy <= 1'b0;
+    end
+    else if (icb_busy & (icb_wait != 0)) begin
+      icb_wait <= icb_wait - 1;
+    end
+  end
+
+  ////////////////////////////////////////////////////////////
+  // E203 side, one request at a time like the NICE port
+  ////////////////////////////////////////////////////////////
+
+  // .insn r 0x7b, func3, func7, x10, x11, x12
+  function [31:0] insn;
+    input [2:0] func3;
+    input [6:0] func7;
+    insn = {func7, 5'd12, 5'd11, func3, 5'd10, 7'b1111011};
+  endfunction
+
+  task nice_op;
+    input  [31:0] inst;
+    input  [31:0] rs1;
+    input  [31:0] rs2;
+    output [31:0] rd;
+    begin
+      @(negedge clk);
+      nice_req_valid = 1'b1;
+      nice_req_inst  = inst;
+      nice_req_rs1   = rs1;
+      nice_req_rs2   = rs2;
+      #1;
+      while (!nice_req_ready) @(negedge clk);
+      @(negedge clk);
+      nice_req_valid = 1'b0;
+      while (!nice_rsp_valid) @(negedge clk);
+      rd = nice_rsp_rdat;
+    end
+  endtask
+
+  initial begin
+    clk = 0;
+    forever #5 clk = ~clk;
+  end
+
+  integer i, err;
+  reg [31:0] rd, rd_a, rd_b;
+
+  initial begin
+    for (i = 0; i < 16384; i = i + 1)
+      mem[i] = (i * 32'h9e3779b1) ^ (i >> 3);
+
+    rst_n          = 0;
+    irq_req        = 0;
+    nice_req_valid = 0;
+    nice_req_inst  = 0;
+    nice_req_rs1   = 0;
+    nice_req_rs2   = 0;
+    #100 rst_n = 1;
+
+    nice_op(insn(3'b010, 7'd11), W_CONV1, 0, rd);
+    nice_op(insn(3'b010, 7'd12), W_CONV2, 0, rd);
+    nice_op(insn(3'b010, 7'd13), W_FC1,   0, rd);
+    nice_op(insn(3'b010, 7'd14), W_FC2,   0, rd);
+    nice_op(insn(3'b100, 7'd21), 0,       0, rd);
+
+    // reference, load_input_wb without the interrupt
+    nice_op(insn(3'b111, 7'd22), IMAGE, OUT_A, rd_a);
+
+    // the interrupt parks the image at its first pass boundary
+    irq_req = 1'b1;
+    nice_op(insn(3'b111, 7'd22), IMAGE, OUT_B, rd);
+    irq_req = 1'b0;
+    err = (rd != RESUME);
+    if (rd != RESUME)
+      $display("FAIL: load_input_wb answered %0d, not NICE_RESUME", $signed(rd));
+
+    // the ISR: fc_sync must leave the parked writeback alone
+    nice_op(insn(3'b100, 7'd25), 0, 0, rd);
+    $display("fc_sync in the ISR: %0d", $signed(rd));
+
+    nice_op(insn(3'b100, 7'd27), 0, 0, rd_b);
+    while (rd_b == RESUME)
+      nice_op(insn(3'b100, 7'd27), 0, 0, rd_b);
+
+    if (rd_b != rd_a) begin
+      $display("FAIL: resumed class %0d, uninterrupted %0d", $signed(rd_b), $signed(rd_a));
+      err = err + 1;
+    end
+    for (i = 0; i < OUT_W; i = i + 1)
+      if (mem[OUT_B[15:2] + i] !== mem[OUT_A[15:2] + i]) begin
+        $display("FAIL: result word %0d: %h, uninterrupted %h", i, mem[OUT_B[15:2] + i], mem[OUT_A[15:2] + i]);
+        err = err + 1;
+      end
+
+    if (err == 0)
+      $display("PASS: class %0d, %0d result words match", $signed(rd_a), OUT_W);
+    $finish;
+  end
+
+endmodule